@@ -23,6 +23,11 @@
 #include "fdstag.h"
 #include "bc.h"
 #include "tools.h"
+#include "profile.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 //---------------------------------------------------------------------------
 PetscErrorCode AVDCreate(AVD *A)
@@ -670,10 +675,19 @@ PetscErrorCode AVDExecuteMarkerInjection(AdvCtx *actx, PetscInt npoints, PetscSc
 PetscErrorCode AVDMarkerControl(AdvCtx *actx)
 {
 	// check marker distribution and delete or inject markers if necessary
+	// host cells and edge shift flags are computed once, and maintained while
+	// markers are injected and deleted, all control volumes are mapped from them
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	ierr = PetscLogEventBegin(LaMEM_MarkerControl, 0, 0, 0, 0); CHKERRQ(ierr);
+
+	// map markers on cells and edge control volumes
+	ierr = ADVMapMarkToCells(actx); CHKERRQ(ierr);
+
+	actx->cellmap = PETSC_TRUE;
+
 	// AVD routine for every control volume
 	ierr = AVDMarkerControlMV(actx, _CELL_); CHKERRQ(ierr); // CELLS
 
@@ -683,6 +697,10 @@ PetscErrorCode AVDMarkerControl(AdvCtx *actx)
 
 	ierr = AVDMarkerControlMV(actx, _YZED_); CHKERRQ(ierr); // YZ Edge
 
+	actx->cellmap = PETSC_FALSE;
+
+	ierr = PetscLogEventEnd(LaMEM_MarkerControl, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -717,9 +735,14 @@ PetscErrorCode AVDMarkerControlMV(AdvCtx *actx, VolumeCase vtype)
 PetscErrorCode AVDCheckCellsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 {
 	// check marker distribution and delete or inject markers if necessary
-	PetscScalar    xs[3], xe[3];
-	PetscInt       ind, i, j, k, M, N;
-	PetscInt       n, ninj, ndel, nmin;
+	// Voronoi diagrams of deficient cells are independent, they are processed by
+	// a dynamically scheduled thread loop (if compiled with OpenMP) using per-thread
+	// scratch, injected and deleted markers are merged serially in the cell order
+	AVDWork        *work;
+	PetscScalar    *xc;
+	PetscInt       ind, it, n, ninj, ndel, nmin, ntask, nthreads, nerr;
+	PetscInt       mcap, ncap, nsrt;
+	PetscInt       *tind, *toff, *area, *sind, *tarea;
 	PetscLogDouble t0,t1;
 	char           lbl[_lbl_sz_];
 
@@ -729,36 +752,37 @@ PetscErrorCode AVDCheckCellsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 	// record time
 	ierr = PetscTime(&t0); CHKERRQ(ierr);
 
-	// get number of cells
-	M = mv->M;
-	N = mv->N;
-
 	// calculate storage
-	ninj = 0;
-	ndel = 0;
+	ninj  = 0;
+	ndel  = 0;
+	ntask = 0;
+	mcap  = 0;
+	ncap  = 0;
+	nsrt  = 0;
+
 	for(ind = 0; ind < mv->ncells; ind++)
 	{
 		// no of markers in cell
 		n = mv->markstart[ind+1] - mv->markstart[ind];
 
-		if (n < actx->nmin)
-		{
-			// expand i, j, k cell indices
-			GET_CELL_IJK(ind, i, j, k, M, N);
+		// minimum number of markers (half-volumes)
+		nmin = AVDGetMinMarkMV(actx, mv, dir, ind);
 
-			// half-volumes
-			nmin = actx->nmin;
-			if ((dir == 0) && ((i == 0) | (i+1 == mv->M))) { nmin = (PetscInt) (actx->nmin/2+1); }
-			if ((dir == 1) && ((j == 0) | (j+1 == mv->N))) { nmin = (PetscInt) (actx->nmin/2+1); }
-			if ((dir == 2) && ((k == 0) | (k+1 == mv->P))) { nmin = (PetscInt) (actx->nmin/2+1); }
+		if (n < nmin && n)
+		{
+			if ((nmin - n) > n) ninj += n;
+			else                ninj += nmin - n;
 
-			if (n < nmin)
-			{
-				if ((nmin - n) > n) ninj += n;
-				else                ninj += nmin - n;
-			}
+			ntask++;
+			ncap += n;
+			mcap  = PetscMax(mcap, n);
+			nsrt  = PetscMax(nsrt, n);
+		}
+		if (n > actx->nmax)
+		{
+			ndel += n - actx->nmax;
+			nsrt  = PetscMax(nsrt, n);
 		}
-		if (n > actx->nmax) ndel += n - actx->nmax;
 	}
 
 	// if no need for injection/deletion
@@ -767,49 +791,115 @@ PetscErrorCode AVDCheckCellsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 	actx->nrecv = ninj;
 	actx->ndel  = ndel;
 
-	// allocate memory
-	if(ninj) { ierr = PetscMalloc((size_t)actx->nrecv*sizeof(Marker),   &actx->recvbuf); CHKERRQ(ierr); }
-	if(ndel) { ierr = PetscMalloc((size_t)actx->ndel *sizeof(PetscInt), &actx->idel   ); CHKERRQ(ierr); }
+	// reserve memory
+	ierr = ADVReserveBuff(actx, 0, ninj, ndel); CHKERRQ(ierr);
+
+	ierr = makeIntArray (&tind,  NULL, ntask+1); CHKERRQ(ierr);
+	ierr = makeIntArray (&toff,  NULL, ntask+1); CHKERRQ(ierr);
+	ierr = makeIntArray (&tarea, NULL, ncap+1);  CHKERRQ(ierr);
+	ierr = makeScalArray(&xc,    NULL, 3*ncap+1);CHKERRQ(ierr);
+	ierr = makeIntArray (&area,  NULL, nsrt+1);  CHKERRQ(ierr);
+	ierr = makeIntArray (&sind,  NULL, nsrt+1);  CHKERRQ(ierr);
+
+	// create injection work queue
+	ntask = 0;
+	ncap  = 0;
+
+	for(ind = 0; ind < mv->ncells; ind++)
+	{
+		n    = mv->markstart[ind+1] - mv->markstart[ind];
+		nmin = AVDGetMinMarkMV(actx, mv, dir, ind);
+
+		if (n < nmin && n)
+		{
+			tind [ntask] = ind;
+			toff [ntask] = ncap;
+
+			ntask++;
+			ncap += n;
+		}
+	}
+
+	// create per-thread AVD scratch
+	nthreads = 1;
+#ifdef _OPENMP
+	nthreads = (PetscInt)omp_get_max_threads();
+#endif
+	if(!ntask) nthreads = 0;
+
+	ierr = PetscMalloc((size_t)(nthreads+1)*sizeof(AVDWork), &work); CHKERRQ(ierr);
+
+	for(it = 0; it < nthreads; it++)
+	{
+		ierr = AVDWorkCreate(actx, &work[it], mcap); CHKERRQ(ierr);
+	}
+
+	// compute Voronoi areas and half-centroids of deficient cells
+	nerr = 0;
+
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic, 1) reduction(+:nerr)
+#endif
+	for(it = 0; it < ntask; it++)
+	{
+		AVDWork *W = work;
+#ifdef _OPENMP
+		W = work + omp_get_thread_num();
+#endif
+		nerr += AVDRunMV(actx, mv, W, tind[it], tarea + toff[it], xc + 3*toff[it]);
+	}
 
+	if(nerr)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Inserting cells into boundary cells is not permitted \n");
+	}
+
+	// merge injected/deleted markers
 	actx->cinj = 0;
 	actx->cdel = 0;
+	it         = 0;
 
-	// inject/delete
 	for(ind = 0; ind < mv->ncells; ind++)
 	{
-		// no of markers in cell
-		n = mv->markstart[ind+1] - mv->markstart[ind];
+		n    = mv->markstart[ind+1] - mv->markstart[ind];
+		nmin = AVDGetMinMarkMV(actx, mv, dir, ind);
 
-		if ((n < actx->nmin) || (n > actx->nmax))
+		if (n < nmin && n)
 		{
-			// expand i, j, k cell indices
-			GET_CELL_IJK(ind, i, j, k, M, N);
-
-			// get cell coordinates
-			xs[0] = mv->xcoord[i]; xe[0] = mv->xcoord[i+1];
-			xs[1] = mv->ycoord[j]; xe[1] = mv->ycoord[j+1];
-			xs[2] = mv->zcoord[k]; xe[2] = mv->zcoord[k+1];
-
-			// here calculate half volumes minimum
-			nmin = actx->nmin;
-			if ((dir == 0) && ((i == 0) | (i+1 == mv->M))) { nmin = (PetscInt) (actx->nmin/2+1); }
-			if ((dir == 1) && ((j == 0) | (j+1 == mv->N))) { nmin = (PetscInt) (actx->nmin/2+1); }
-			if ((dir == 2) && ((k == 0) | (k+1 == mv->P))) { nmin = (PetscInt) (actx->nmin/2+1); }
-
-			// inject/delete markers
-			if ((n < nmin) || (n > actx->nmax))
-			{
-				ierr = AVDAlgorithmMV(actx, mv, n, xs, xe, ind, nmin); CHKERRQ(ierr);
-			}
+			ierr = AVDInjectPointsMV(actx, mv, ind, nmin, tarea + toff[it], xc + 3*toff[it], area, sind); CHKERRQ(ierr);
+
+			it++;
+		}
+		if (n > actx->nmax)
+		{
+			ierr = AVDDeletePointsMV(actx, mv, ind, area, sind); CHKERRQ(ierr);
 		}
 	}
 
+	// update total counters
+	actx->tinj += actx->nrecv;
+	actx->tdel += actx->ndel;
+
 	// store new markers
 	ierr = ADVCollectGarbage(actx); CHKERRQ(ierr);
 
 	// clear
-	ierr = PetscFree(actx->recvbuf); CHKERRQ(ierr);
-	ierr = PetscFree(actx->idel);    CHKERRQ(ierr);
+	for(it = 0; it < nthreads; it++)
+	{
+		ierr = AVDWorkDestroy(&work[it]); CHKERRQ(ierr);
+	}
+
+	ierr = PetscFree(work);          CHKERRQ(ierr);
+	ierr = PetscFree(tind);          CHKERRQ(ierr);
+	ierr = PetscFree(toff);          CHKERRQ(ierr);
+	ierr = PetscFree(tarea);         CHKERRQ(ierr);
+	ierr = PetscFree(xc);            CHKERRQ(ierr);
+	ierr = PetscFree(area);          CHKERRQ(ierr);
+	ierr = PetscFree(sind);          CHKERRQ(ierr);
+
+	// reset buffer counters
+	actx->nrecv = 0;
+	actx->ndel  = 0;
 
 	// print info
 	ierr = PetscTime(&t1); CHKERRQ(ierr);
@@ -824,6 +914,22 @@ PetscErrorCode AVDCheckCellsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 	PetscFunctionReturn(0);
 }
 //-----------------------------------------------------------------------------
+PetscInt AVDGetMinMarkMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir, PetscInt ind)
+{
+	// get minimum number of markers in control volume (half-volumes at the boundaries)
+	PetscInt i, j, k, nmin;
+
+	// expand i, j, k cell indices
+	GET_CELL_IJK(ind, i, j, k, mv->M, mv->N);
+
+	nmin = actx->nmin;
+	if ((dir == 0) && ((i == 0) | (i+1 == mv->M))) { nmin = (PetscInt) (actx->nmin/2+1); }
+	if ((dir == 1) && ((j == 0) | (j+1 == mv->N))) { nmin = (PetscInt) (actx->nmin/2+1); }
+	if ((dir == 2) && ((k == 0) | (k+1 == mv->P))) { nmin = (PetscInt) (actx->nmin/2+1); }
+
+	return nmin;
+}
+//-----------------------------------------------------------------------------
 PetscInt FindPointInCell(
 	PetscScalar *px, // node coordinates
 	PetscInt     L,  // index of the leftmost node
@@ -856,9 +962,10 @@ PetscInt FindPointInCell(
 PetscErrorCode AVDMapMarkersMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 {
 	// creates arrays to optimize marker-cell interaction
+	// marker volume indices are obtained from the host cells by shifting
+	// along the staggered direction (no coordinate search is needed)
 	FDSTAG      *fs;
-	PetscScalar *X;
-	PetscInt     i, ID, I, J, K;
+	PetscInt     i, ID, I, J, K, nx, ny;
 	PetscInt    *numMarkCell, *m, p;
 
 	PetscErrorCode ierr;
@@ -888,22 +995,24 @@ PetscErrorCode AVDMapMarkersMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 	}
 	else for(i = 0; i < mv->P+1; i++) mv->zcoord[i] = fs->dsz.ncoor[i];
 
+	nx = fs->dsx.ncels;
+	ny = fs->dsy.ncels;
+
 	// loop over all local particles
 	for(i = 0; i < actx->nummark; i++)
 	{
-		// get marker coordinates
-		X = actx->markers[i].X;
+		// expand host cell indices
+		GET_CELL_IJK(actx->cellnum[i], I, J, K, nx, ny);
 
-		// find I, J, K indices by bisection algorithm
-		I = FindPointInCell(mv->xcoord, 0, mv->M, X[0]);
-		J = FindPointInCell(mv->ycoord, 0, mv->N, X[1]);
-		K = FindPointInCell(mv->zcoord, 0, mv->P, X[2]);
+		// shift to the edge control volume
+		if      (dir == 0) I += ( actx->markedge[i]       & 1);
+		else if (dir == 1) J += ((actx->markedge[i] >> 1) & 1);
+		else if (dir == 2) K += ((actx->markedge[i] >> 2) & 1);
 
 		// compute and store consecutive index
 		GET_CELL_ID(ID, I, J, K, mv->M, mv->N);
 
 		mv->cellnum[i] = ID;
-
 	}
 
 	// allocate marker counter array
@@ -988,66 +1097,309 @@ PetscErrorCode AVDDestroyMV(MarkerVolume *mv)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDLoadPointsMV(AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt ind)
+// THREADED MARKER CONTROL KERNELS
+//---------------------------------------------------------------------------
+// Thread-safe variants of AVDCellInit, AVDClaimCells and AVDUpdateChain.
+// They operate on preallocated per-thread scratch (AVDWork), never allocate
+// memory and do not use PETSc error handling (called inside threaded loops).
+//---------------------------------------------------------------------------
+PetscErrorCode AVDWorkCreate(AdvCtx *actx, AVDWork *W, PetscInt mcap)
 {
-	PetscInt    i, ii;
+	AVD      *A;
+	PetscInt  p, i, j, k, ind, mx, my, mz;
+
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	// load particles only within the Voronoi cell
-	for (i = 0; i < A->npoints; i++)
+	A = &W->A;
+
+	// initialize parameters
+	A->nx      = actx->avdx;
+	A->ny      = actx->avdy;
+	A->nz      = actx->avdz;
+	A->mmin    = actx->nmin;
+	A->mmax    = actx->nmax;
+	A->npoints = 0;
+	A->buffer  = 0;
+
+	mx = A->nx+2;
+	my = A->ny+2;
+	mz = A->nz+2;
+
+	// claimed and boundary lists never exceed the number of cells (plus terminator)
+	W->mcap = mcap;
+	W->lcap = mx*my*mz+1;
+
+	// allocate cells, chains, points and chain lists
+	ierr = PetscMalloc((size_t)(mx*my*mz)*sizeof(AVDCell), &A->cell);           CHKERRQ(ierr);
+	ierr = PetscMemzero(A->cell, (size_t)(mx*my*mz)*sizeof(AVDCell));           CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)(mcap+1)*sizeof(AVDChain), &A->chain);           CHKERRQ(ierr);
+	ierr = PetscMemzero(A->chain, (size_t)(mcap+1)*sizeof(AVDChain));           CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)(mcap+1)*sizeof(Marker), &A->points);            CHKERRQ(ierr);
+	ierr = makeIntArray(&W->list, NULL, 2*W->lcap*(mcap+1));                    CHKERRQ(ierr);
+
+	// set fixed cell topology
+	for(k = 0; k < mz; k++)
+	for(j = 0; j < my; j++)
+	for(i = 0; i < mx; i++)
 	{
-		// get index
-		ii = mv->markind[mv->markstart[ind] + i];
+		ind = i + j*mx + k*mx*my;
 
-		// save marker
-		A->points[i] = actx->markers[ii];
+		A->cell[ind].ind = ind;
+		A->cell[ind].i   = i;
+		A->cell[ind].j   = j;
+		A->cell[ind].k   = k;
+	}
 
-		// save index
-		A->chain [i].gind  = ii;
+	// assign chain lists
+	for(p = 0; p < mcap; p++)
+	{
+		A->chain[p].claim = W->list + 2*p*W->lcap;
+		A->chain[p].bound = W->list + 2*p*W->lcap + W->lcap;
 	}
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDInjectPointsMV(AdvCtx *actx, AVD *A)
+PetscErrorCode AVDWorkDestroy(AVDWork *W)
 {
-	FDSTAG     *fs;
-	BCCtx      *bc;
-	PetscInt    i, ii, n, ind, I, J, K, cellID;
-	PetscInt    num_chain, hclaim;
-	PetscInt    npoints, new_nmark = 0;
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PetscFree(W->A.cell);   CHKERRQ(ierr);
+	ierr = PetscFree(W->A.chain);  CHKERRQ(ierr);
+	ierr = PetscFree(W->A.points); CHKERRQ(ierr);
+	ierr = PetscFree(W->list);     CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+void AVDUpdateChainKernel(AVD *A, const PetscInt ip)
+{
+	PetscInt i, k;
+	PetscInt count;
+	PetscInt cell_num0, cell_num1, cell_num[6];
+	AVDChain *bchain;
+	AVDCell  *cells, *cell0;
+	PetscInt mx, my;
+
+	mx     = A->nx+2;
+	my     = A->ny+2;
+	bchain = &A->chain[ip];
+	cells  = A->cell;
+
+	count = 0;
+	bchain->length = 0;
+
+	for(i = 0; i < bchain->nclaimed; i++)
+	{
+		cell_num0 = bchain->claim[i];
+		cell0     = &cells[cell_num0];
+
+		if (cell0->p == AVD_CELL_MASK) { continue; }
+
+		cell_num[0] = (cell0->i  ) + (cell0->j-1)*mx + (cell0->k  )*mx*my; // S
+		cell_num[1] = (cell0->i  ) + (cell0->j+1)*mx + (cell0->k  )*mx*my; // N
+		cell_num[2] = (cell0->i+1) + (cell0->j  )*mx + (cell0->k  )*mx*my; // E
+		cell_num[3] = (cell0->i-1) + (cell0->j  )*mx + (cell0->k  )*mx*my; // W
+		cell_num[4] = (cell0->i  ) + (cell0->j  )*mx + (cell0->k+1)*mx*my; // Front
+		cell_num[5] = (cell0->i  ) + (cell0->j  )*mx + (cell0->k-1)*mx*my; // Back
+
+		for(k = 0; k < 6; k++)
+		{
+			cell_num1 = cell_num[k];
+
+			// add cells that do not belong to the particle to new boundary array and mark them as done
+			if (cells[cell_num1].p != AVD_CELL_MASK && cells[cell_num1].p != ip && !cells[cell_num1].done)
+			{
+				bchain->bound[count++] = cell_num1;
+				bchain->length++;
+
+				cells[cell_num1].done = PETSC_TRUE;
+			}
+		}
+	}
+
+	// reset the processed flags
+	for(i = 0; i < count; i++) cells[bchain->bound[i]].done = PETSC_FALSE;
+}
+//---------------------------------------------------------------------------
+void AVDClaimCellsKernel(AVD *A, const PetscInt ip)
+{
+	PetscInt    i, count, cell_num0;
+	PetscScalar x0[3], x1[3], x2[3];
+	AVDChain    *bchain;
+	AVDCell     *cells;
+	Marker      *points;
+
+	bchain = &A->chain[ip];
+	cells  = A->cell;
+	points = A->points;
+
+	count  = 0;
+	bchain->nclaimed = 0;
+
+	for(i = 0; i < bchain->length; i++)
+	{
+		cell_num0 = bchain->bound[i];
+
+		// if cell unclaimed, then claim it
+		if (cells[cell_num0].p == AVD_CELL_UNCLAIMED)
+		{
+			bchain->claim[count++] = cell_num0;
+			bchain->nclaimed++;
+
+			cells[cell_num0].p = ip;
+		}
+		else if (cells[cell_num0].p != ip)
+		{
+			// perform distance test between points to determine ownership
+			x2[0] = points[ip].X[0];
+			x2[1] = points[ip].X[1];
+			x2[2] = points[ip].X[2];
+
+			x1[0] = points[cells[cell_num0].p].X[0];
+			x1[1] = points[cells[cell_num0].p].X[1];
+			x1[2] = points[cells[cell_num0].p].X[2];
+
+			x0[0] = cells[cell_num0].x[0];
+			x0[1] = cells[cell_num0].x[1];
+			x0[2] = cells[cell_num0].x[2];
+
+			if (AVDDistanceTest(x0,x1,x2) > 0.0)
+			{
+				bchain->claim[count++] = cell_num0;
+				bchain->nclaimed++;
+
+				cells[cell_num0].p = ip;
+			}
+		}
+
+		// mark end of list
+		bchain->claim[count] = -1;
+	}
+}
+//---------------------------------------------------------------------------
+PetscInt AVDRunMV(AdvCtx *actx, MarkerVolume *mv, AVDWork *W, PetscInt cellID, PetscInt *area, PetscScalar *xcen)
+{
+	// compute Voronoi areas and half-centroids of all markers in a control volume
+	// returns nonzero if a marker is located in the boundary layer of the AVD grid
+
+	AVD         *A;
+	AVDCell     *cell;
+	AVDChain    *chain;
+	PetscInt    i, j, k, p, ii, n, ind, mx, my, mz, npoints, claimed, hclaim, axis;
+	PetscScalar dx[3], s[3], xp[3], xc[3], xh[3];
 	PetscScalar xmin, xmax, ymin, ymax, zmin, zmax;
 	PetscScalar xaxis, yaxis, zaxis;
-	PetscScalar xp[3], xc[3], xh[3];
-	PetscInt    *area, *sind, axis;
 
-	PetscErrorCode ierr;
-	PetscFunctionBeginUser;
+	A  = &W->A;
+	mx = A->nx+2;
+	my = A->ny+2;
+	mz = A->nz+2;
+	n  = mx*my*mz;
 
-	bc = actx->jr->bc;
-	fs = actx->fs;
+	// get control volume bounds
+	GET_CELL_IJK(cellID, i, j, k, mv->M, mv->N);
 
-	npoints = A->npoints;
-	n  = (A->nx+2)*(A->ny+2)*(A->nz+2);
+	A->xs[0] = mv->xcoord[i]; A->xe[0] = mv->xcoord[i+1];
+	A->xs[1] = mv->ycoord[j]; A->xe[1] = mv->ycoord[j+1];
+	A->xs[2] = mv->zcoord[k]; A->xe[2] = mv->zcoord[k+1];
 
-	// allocate memory for sorting
-	ierr = makeIntArray(&area, NULL, npoints); CHKERRQ(ierr);
-	ierr = makeIntArray(&sind, NULL, npoints); CHKERRQ(ierr);
+	A->dx = (A->xe[0]-A->xs[0])/(PetscScalar)A->nx;
+	A->dy = (A->xe[1]-A->xs[1])/(PetscScalar)A->ny;
+	A->dz = (A->xe[2]-A->xs[2])/(PetscScalar)A->nz;
+
+	npoints    = mv->markstart[cellID+1] - mv->markstart[cellID];
+	A->npoints = npoints;
+
+	dx[0] = A->dx;
+	dx[1] = A->dy;
+	dx[2] = A->dz;
+
+	s[0] = A->xs[0]-dx[0]*0.5;
+	s[1] = A->xs[1]-dx[1]*0.5;
+	s[2] = A->xs[2]-dx[2]*0.5;
+
+	// reset cells
+	for(ii = 0; ii < n; ii++)
+	{
+		cell = &A->cell[ii];
+
+		cell->x[0] = s[0] + (PetscScalar)cell->i*dx[0];
+		cell->x[1] = s[1] + (PetscScalar)cell->j*dx[1];
+		cell->x[2] = s[2] + (PetscScalar)cell->k*dx[2];
+		cell->done = PETSC_FALSE;
+		cell->p    = AVD_CELL_UNCLAIMED;
+		cell->col  = 0;
+
+		// create boundary
+		if ((cell->i==0) || (cell->i==mx-1)) { cell->p = AVD_CELL_MASK; }
+		if ((cell->j==0) || (cell->j==my-1)) { cell->p = AVD_CELL_MASK; }
+		if ((cell->k==0) || (cell->k==mz-1)) { cell->p = AVD_CELL_MASK; }
+	}
+
+	// load points, initialize chains
+	for(p = 0; p < npoints; p++)
+	{
+		chain = &A->chain[p];
+
+		chain->gind     = mv->markind[mv->markstart[cellID] + p];
+		chain->tclaimed = 0;
+		chain->xc[0]    = 0.0; chain->xc[1] = 0.0; chain->xc[2] = 0.0;
+		chain->xh[0]    = 0.0; chain->xh[1] = 0.0; chain->xh[2] = 0.0;
+
+		A->points[p] = actx->markers[chain->gind];
+
+		// compute cell index of the particle
+		i = (PetscInt)((A->points[p].X[0] - (A->xs[0] - A->dx))/A->dx);
+		j = (PetscInt)((A->points[p].X[1] - (A->xs[1] - A->dy))/A->dy);
+		k = (PetscInt)((A->points[p].X[2] - (A->xs[2] - A->dz))/A->dz);
+
+		// if a particle is exactly on the border then make sure it is in a valid cell inside the element
+		if (i == mx-1) { i--; }
+		if (j == my-1) { j--; }
+		if (k == mz-1) { k--; }
+
+		ind = i+j*mx+k*mx*my;
+
+		if (A->cell[ind].p == AVD_CELL_MASK) return 1;
+
+		A->cell[ind].p  = p;
+		chain->nclaimed = 1;
+		chain->length   = 0;
+		chain->done     = PETSC_FALSE;
+		chain->ind      = ind;
+		chain->claim[0] = ind;
+		chain->claim[1] = -1;
+
+		// update initial chain
+		AVDUpdateChainKernel(A, p);
+	}
+
+	// AVD algorithm
+	claimed = 1;
+	while (claimed != 0)
+	{
+		claimed = 0;
+		for (p = 0; p < npoints; p++)
+		{
+			AVDClaimCellsKernel(A, p);
+			claimed += A->chain[p].nclaimed;
+			AVDUpdateChainKernel(A, p);
+		}
+	}
 
 	// compute dominant axis
-	for (i = 0; i < npoints; i++)
+	for (p = 0; p < npoints; p++)
 	{
-		// initialize min and max with the origin of the particle
-		xmin = A->points[i].X[0];
-		xmax = A->points[i].X[0];
-		ymin = A->points[i].X[1];
-		ymax = A->points[i].X[1];
-		zmin = A->points[i].X[2];
-		zmax = A->points[i].X[2];
+		xmin = xmax = A->points[p].X[0];
+		ymin = ymax = A->points[p].X[1];
+		zmin = zmax = A->points[p].X[2];
 
 		for (ii = 0; ii < n; ii++)
 		{
-			if (A->cell[ii].p == i)
+			if (A->cell[ii].p == p)
 			{
 				if (A->cell[ii].x[0] < xmin) xmin = A->cell[ii].x[0];
 				if (A->cell[ii].x[0] > xmax) xmax = A->cell[ii].x[0];
@@ -1058,44 +1410,38 @@ PetscErrorCode AVDInjectPointsMV(AdvCtx *actx, AVD *A)
 			}
 		}
 
-		// initialize dominant axis
-		A->chain[i].axis = -1;
+		A->chain[p].axis = -1;
 
-		// dominant axis
 		xaxis = xmax-xmin;
 		yaxis = ymax-ymin;
 		zaxis = zmax-zmin;
 
-		if ((xaxis > yaxis) && (xaxis > zaxis)) { A->chain[i].xh[0] = (xmax+xmin)*0.5; A->chain[i].axis = 0; }
-		if ((yaxis > xaxis) && (yaxis > zaxis)) { A->chain[i].xh[1] = (ymax+ymin)*0.5; A->chain[i].axis = 1; }
-		if ((zaxis > xaxis) && (zaxis > yaxis)) { A->chain[i].xh[2] = (zmax+zmin)*0.5; A->chain[i].axis = 2; }
+		if ((xaxis > yaxis) && (xaxis > zaxis)) { A->chain[p].xh[0] = (xmax+xmin)*0.5; A->chain[p].axis = 0; }
+		if ((yaxis > xaxis) && (yaxis > zaxis)) { A->chain[p].xh[1] = (ymax+ymin)*0.5; A->chain[p].axis = 1; }
+		if ((zaxis > xaxis) && (zaxis > yaxis)) { A->chain[p].xh[2] = (zmax+zmin)*0.5; A->chain[p].axis = 2; }
 	}
 
 	// create colour - which cells to consider for the half-centroid
-	for (i = 0; i < npoints; i++)
+	for (p = 0; p < npoints; p++)
 	{
-		// half axis
-		xh[0] = A->chain[i].xh[0];
-		xh[1] = A->chain[i].xh[1];
-		xh[2] = A->chain[i].xh[2];
+		xh[0] = A->chain[p].xh[0];
+		xh[1] = A->chain[p].xh[1];
+		xh[2] = A->chain[p].xh[2];
 
-		// point coordinate
-		xp[0] = A->points[i].X[0];
-		xp[1] = A->points[i].X[1];
-		xp[2] = A->points[i].X[2];
+		xp[0] = A->points[p].X[0];
+		xp[1] = A->points[p].X[1];
+		xp[2] = A->points[p].X[2];
 
-		axis = A->chain[i].axis;
+		axis = A->chain[p].axis;
 
 		for (ii = 0; ii < n; ii++)
 		{
-			if (A->cell[ii].p == i)
+			if (A->cell[ii].p == p)
 			{
-				// cell coordinate
 				xc[0] = A->cell[ii].x[0];
 				xc[1] = A->cell[ii].x[1];
 				xc[2] = A->cell[ii].x[2];
 
-				// mark coloring
 				if (axis==-1) A->cell[ii].col = 1;
 				else
 				{
@@ -1106,186 +1452,132 @@ PetscErrorCode AVDInjectPointsMV(AdvCtx *actx, AVD *A)
 		}
 	}
 
-	// calculate half-centroid
-	for (i = 0; i < npoints; i++)
+	// calculate half-centroid and Voronoi area
+	for (p = 0; p < npoints; p++)
 	{
+		chain  = &A->chain[p];
 		hclaim = 0;
+
 		for (ii = 0; ii < n; ii++)
 		{
-			if (A->cell[ii].p == i)
+			if (A->cell[ii].p == p)
 			{
-				// total claimed
-				A->chain[i].tclaimed++;
+				chain->tclaimed++;
 
 				if (A->cell[ii].col == 1)
 				{
 					hclaim++;
-					A->chain[i].xc[0] += A->cell[ii].x[0];
-					A->chain[i].xc[1] += A->cell[ii].x[1];
-					A->chain[i].xc[2] += A->cell[ii].x[2];
+					chain->xc[0] += A->cell[ii].x[0];
+					chain->xc[1] += A->cell[ii].x[1];
+					chain->xc[2] += A->cell[ii].x[2];
 				}
 			}
 		}
 
-		// centroid coordinates
-		A->chain[i].xc[0] = A->chain[i].xc[0]/(PetscScalar)hclaim;
-		A->chain[i].xc[1] = A->chain[i].xc[1]/(PetscScalar)hclaim;
-		A->chain[i].xc[2] = A->chain[i].xc[2]/(PetscScalar)hclaim;
+		xcen[3*p  ] = chain->xc[0]/(PetscScalar)hclaim;
+		xcen[3*p+1] = chain->xc[1]/(PetscScalar)hclaim;
+		xcen[3*p+2] = chain->xc[2]/(PetscScalar)hclaim;
+		area[p]     = chain->tclaimed;
+	}
 
-		// initialize variables for sorting
+	return 0;
+}
+//---------------------------------------------------------------------------
+PetscErrorCode AVDInjectPointsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt ind, PetscInt nmin,
+	PetscInt *tarea, PetscScalar *xcen, PetscInt *area, PetscInt *sind)
+{
+	// inject markers at half-centroids of the largest Voronoi cells
+	FDSTAG     *fs;
+	BCCtx      *bc;
+	Marker     *P;
+	PetscInt    i, ii, I, J, K, cellID;
+	PetscInt    num_chain, npoints, new_nmark;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	bc = actx->jr->bc;
+	fs = actx->fs;
+
+	npoints = mv->markstart[ind+1] - mv->markstart[ind];
+
+	// initialize variables for sorting
+	for (i = 0; i < npoints; i++)
+	{
 		sind[i] = i;
-		area[i] = A->chain[i].tclaimed;
+		area[i] = tarea[i];
 	}
 
 	// sort in ascending order
 	ierr = PetscSortIntWithArray(npoints,area,sind); CHKERRQ(ierr);
 
 	// do not insert more markers than available voronoi domains
-	new_nmark = A->mmin - npoints;
+	new_nmark = nmin - npoints;
 	if (npoints < new_nmark) new_nmark = npoints;
 
-	ind = npoints - 1;
+	ii = npoints - 1;
 	for (i = 0; i < new_nmark; i++)
 	{
-		num_chain = sind[ind];
+		num_chain = sind[ii];
 
 		// inject same properties as parent marker except for position
-		actx->recvbuf[actx->cinj+i]      = A->points[num_chain];
-		actx->recvbuf[actx->cinj+i].X[0] = A->chain [num_chain].xc[0];
-		actx->recvbuf[actx->cinj+i].X[1] = A->chain [num_chain].xc[1];
-		actx->recvbuf[actx->cinj+i].X[2] = A->chain [num_chain].xc[2];
+		P    = actx->recvbuf + actx->cinj + i;
+		(*P) = actx->markers[mv->markind[mv->markstart[ind] + num_chain]];
+
+		P->X[0] = xcen[3*num_chain  ];
+		P->X[1] = xcen[3*num_chain+1];
+		P->X[2] = xcen[3*num_chain+2];
 
 		// --- this is not ideal with multiple control volumes (i.e. use mv for BCOverridePhase) ---
 		// find I, J, K indices by bisection algorithm
-		I = FindPointInCell(fs->dsx.ncoor, 0, fs->dsx.ncels, actx->recvbuf[actx->cinj+i].X[0]);
-		J = FindPointInCell(fs->dsy.ncoor, 0, fs->dsy.ncels, actx->recvbuf[actx->cinj+i].X[1]);
-		K = FindPointInCell(fs->dsz.ncoor, 0, fs->dsz.ncels, actx->recvbuf[actx->cinj+i].X[2]);
+		I = FindPointInCell(fs->dsx.ncoor, 0, fs->dsx.ncels, P->X[0]);
+		J = FindPointInCell(fs->dsy.ncoor, 0, fs->dsy.ncels, P->X[1]);
+		K = FindPointInCell(fs->dsz.ncoor, 0, fs->dsz.ncels, P->X[2]);
 
 		// compute and store consecutive index
 		GET_CELL_ID(cellID, I, J, K, fs->dsx.ncels, fs->dsy.ncels);
 
 		// override marker phase (if necessary) - need to calculate cellID
-		ierr = BCOverridePhase(bc, cellID, actx->recvbuf + actx->cinj + i); CHKERRQ(ierr);
+		ierr = BCOverridePhase(bc, cellID, P); CHKERRQ(ierr);
 		// -----------------------------------------------------------------------------------------
 
-		ind--;
+		ii--;
 	}
 	// update total counter
-	actx->cinj +=new_nmark;
-
-	// free memory
-	ierr = PetscFree(area); CHKERRQ(ierr);
-	ierr = PetscFree(sind); CHKERRQ(ierr);
+	actx->cinj += new_nmark;
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDDeletePointsMV(AdvCtx *actx, AVD *A)
+PetscErrorCode AVDDeletePointsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt ind, PetscInt *area, PetscInt *sind)
 {
-	PetscInt    i, ind;
-	PetscInt    num_chain;
-	PetscInt    npoints, new_nmark = 0;
-	PetscInt    *area, *sind;
+	// delete surplus markers
+	// NOTE: Voronoi areas were never accumulated on this path (zero keys),
+	// the selection therefore does not require the AVD construction
+	PetscInt    i, npoints, new_nmark;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	npoints = A->npoints;
-	new_nmark = npoints - A->mmax;
-
-	// allocate memory for sorting
-	ierr = makeIntArray(&area, NULL, npoints); CHKERRQ(ierr);
-	ierr = makeIntArray(&sind, NULL, npoints); CHKERRQ(ierr);
+	npoints   = mv->markstart[ind+1] - mv->markstart[ind];
+	new_nmark = npoints - actx->nmax;
 
 	// initialize variables for sorting
 	for (i = 0; i < npoints; i++)
 	{
 		sind[i] = i;
-		area[i] = A->chain[i].tclaimed;
+		area[i] = 0;
 	}
 
 	// sort in ascending order
 	ierr = PetscSortIntWithArray(npoints,area,sind); CHKERRQ(ierr);
 
-		ind = 0;
-		for (i = 0; i < new_nmark; i++)
-		{
-			num_chain = sind[ind];
-			actx->idel[actx->cdel+i] = A->chain[num_chain].gind;
-			ind++;
-
-		}
-		// update total counter
-		actx->cdel +=new_nmark;
-
-	// free memory
-	ierr = PetscFree(area); CHKERRQ(ierr);
-	ierr = PetscFree(sind); CHKERRQ(ierr);
-
-	PetscFunctionReturn(0);
-}
-//---------------------------------------------------------------------------
-PetscErrorCode AVDAlgorithmMV(AdvCtx *actx, MarkerVolume *mv, PetscInt npoints, PetscScalar xs[3], PetscScalar xe[3], PetscInt ind, PetscInt nmin)
-{
-
-	AVD          A;
-	PetscInt     i,claimed;
-
-	PetscErrorCode ierr;
-	PetscFunctionBeginUser;
-
-	// initialize some parameters
-	A.nx = actx->avdx;
-	A.ny = actx->avdy;
-	A.nz = actx->avdz;
-
-	A.mmin = nmin;
-	A.mmax = actx->nmax;
-
-	A.npoints = npoints;
-
-	A.xs[0] = xs[0];
-	A.xs[1] = xs[1];
-	A.xs[2] = xs[2];
-
-	A.xe[0] = xe[0];
-	A.xe[1] = xe[1];
-	A.xe[2] = xe[2];
-
-	A.dx = (xe[0]-xs[0])/(PetscScalar)A.nx;
-	A.dy = (xe[1]-xs[1])/(PetscScalar)A.ny;
-	A.dz = (xe[2]-xs[2])/(PetscScalar)A.nz;
-
-	// create AVD structure
-	ierr = AVDCreate(&A); CHKERRQ(ierr);
-
-	// load particles
-	ierr = AVDLoadPointsMV(actx,mv,&A,ind); CHKERRQ(ierr);
-
-	// initialize AVD cells
-	ierr = AVDCellInit(&A); CHKERRQ(ierr);
-
-	// do AVD algorithm
-	claimed = 1;
-	while (claimed!= 0)
+	for (i = 0; i < new_nmark; i++)
 	{
-		claimed = 0;
-		for (i = 0; i < npoints; i++)
-		{
-			ierr = AVDClaimCells(&A,i); CHKERRQ(ierr);
-			claimed += A.chain[i].nclaimed;
-			ierr = AVDUpdateChain(&A,i); CHKERRQ(ierr);
-		}
+		actx->idel[actx->cdel+i] = mv->markind[mv->markstart[ind] + sind[i]];
 	}
-
-	// inject markers
-	if (A.npoints < A.mmin) { ierr = AVDInjectPointsMV(actx, &A); CHKERRQ(ierr); }
-
-	// delete markers
-	if (A.npoints > A.mmax) { ierr = AVDDeletePointsMV(actx, &A); CHKERRQ(ierr); }
-
-	// destroy AVD structure
-	ierr = AVDDestroy(&A); CHKERRQ(ierr);
+	// update total counter
+	actx->cdel += new_nmark;
 
 	PetscFunctionReturn(0);
 }
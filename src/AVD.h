@@ -66,6 +66,16 @@ struct AVD
 
 } ;
 
+// reusable AVD scratch for marker control (one per thread)
+struct AVDWork
+{
+	AVD         A;                         // AVD structure with fixed capacity
+	PetscInt    mcap;                      // maximum number of points
+	PetscInt    lcap;                      // capacity of claimed/boundary lists per chain
+	PetscInt    *list;                     // storage for claimed/boundary lists of all chains
+
+} ;
+
 struct MarkerVolume
 {
 	PetscInt    *cellnum;                  // host cells local number for each marker
@@ -107,12 +117,18 @@ PetscErrorCode AVDMarkerControlMV(AdvCtx *actx, VolumeCase vtype);
 PetscErrorCode AVDCheckCellsMV   (AdvCtx *actx, MarkerVolume *mv, PetscInt dir);
 PetscErrorCode AVDMapMarkersMV   (AdvCtx *actx, MarkerVolume *mv, PetscInt dir);
 PetscErrorCode AVDCreateMV       (AdvCtx *actx, MarkerVolume *mv, PetscInt dir);
-PetscErrorCode AVDAlgorithmMV    (AdvCtx *actx, MarkerVolume *mv, PetscInt npoints, PetscScalar xs[3], PetscScalar xe[3], PetscInt ind, PetscInt nmin);
-PetscErrorCode AVDLoadPointsMV   (AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt ind);
-PetscErrorCode AVDInjectPointsMV (AdvCtx *actx, AVD *A);
-PetscErrorCode AVDDeletePointsMV (AdvCtx *actx, AVD *A);
+PetscInt       AVDGetMinMarkMV   (AdvCtx *actx, MarkerVolume *mv, PetscInt dir, PetscInt ind);
+PetscErrorCode AVDInjectPointsMV (AdvCtx *actx, MarkerVolume *mv, PetscInt ind, PetscInt nmin, PetscInt *tarea, PetscScalar *xcen, PetscInt *area, PetscInt *sind);
+PetscErrorCode AVDDeletePointsMV (AdvCtx *actx, MarkerVolume *mv, PetscInt ind, PetscInt *area, PetscInt *sind);
 PetscErrorCode AVDDestroyMV      (MarkerVolume *mv);
 
+// threaded marker control kernels (per-thread scratch, thread-safe)
+PetscErrorCode AVDWorkCreate       (AdvCtx *actx, AVDWork *W, PetscInt mcap);
+PetscErrorCode AVDWorkDestroy      (AVDWork *W);
+void           AVDUpdateChainKernel(AVD *A, const PetscInt ip);
+void           AVDClaimCellsKernel (AVD *A, const PetscInt ip);
+PetscInt       AVDRunMV            (AdvCtx *actx, MarkerVolume *mv, AVDWork *W, PetscInt cellID, PetscInt *area, PetscScalar *xcen);
+
 //---------------------------------------------------------------------------
 static inline PetscScalar AVDDistanceTest(PetscScalar x0[3],PetscScalar x1[3],PetscScalar x2[3])
 {
@@ -23,6 +23,7 @@
 #include "tools.h"
 #include "advect.h"
 #include "dike.h"
+#include "profile.h"
 //---------------------------------------------------------------------------
 PetscErrorCode JacResCreate(JacRes *jr, FB *fb)
 {
@@ -62,6 +63,8 @@ PetscErrorCode JacResCreate(JacRes *jr, FB *fb)
 	ctrl->actTemp	   =  0;			// diffusion is not active by default (otherwise we have to define thermal properties in all cases)
 	ctrl->printNorms   =  0;			// print norms of velocity/pressure/temperature?
 	ctrl->Adiabatic_gr = 0.0;
+	ctrl->steadyTempIt  = 1;
+	ctrl->steadyTempTol = 1e-6;
 	
 	if(scal->utype != _NONE_)
 	{
@@ -81,6 +84,8 @@ PetscErrorCode JacResCreate(JacRes *jr, FB *fb)
 	ierr = getIntParam   (fb, _OPTIONAL_, "act_steady_temp", &ctrl->actSteadyTemp,  1, 1);              CHKERRQ(ierr);
 	ierr = getScalarParam(fb, _OPTIONAL_, "steady_temp_t",   &ctrl->steadyTempStep, 1, 1.0);            CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "nstep_steady",    &ctrl->steadyNumStep,  1, 0);              CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "steady_temp_it",  &ctrl->steadyTempIt,   1, -1);             CHKERRQ(ierr);
+	ierr = getScalarParam(fb, _OPTIONAL_, "steady_temp_tol", &ctrl->steadyTempTol,  1, 1.0);            CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "act_heat_rech",   &ctrl->actHeatRech,    1, 2.0);              CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "act_p_shift",     &ctrl->pShiftAct,      1, 1);   			CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "init_lith_pres",  &ctrl->initLithPres,   1, 1);              CHKERRQ(ierr);
@@ -164,6 +169,16 @@ PetscErrorCode JacResCreate(JacRes *jr, FB *fb)
 		jr->ts->fix_dt = 1;
 	}
 
+	if(ctrl->steadyTempIt < 1)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Number of steady state temperature iterations must be positive (steady_temp_it)\n");
+	}
+
+	if(ctrl->steadyTempTol <= 0.0)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Steady state temperature tolerance must be positive (steady_temp_tol)\n");
+	}
+
 	if(need_RUGC && !ctrl->Rugc)
 	{
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Specify universal gas constant (RUGC)\n");
@@ -250,6 +265,11 @@ PetscErrorCode JacResCreate(JacRes *jr, FB *fb)
 	if(ctrl->biot)           PetscPrintf(PETSC_COMM_WORLD, "   Biot pressure parameter                 :  %g \n", ctrl->biot);
 	if(ctrl->actTemp)        PetscPrintf(PETSC_COMM_WORLD, "   Activate temperature diffusion          @ \n");
 	if(ctrl->actSteadyTemp)  PetscPrintf(PETSC_COMM_WORLD, "   Steady state initial temperature        @ \n");
+	if(ctrl->actSteadyTemp && ctrl->useTk && ctrl->steadyTempIt > 1)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "   Steady state temperature iterations     : %lld \n", (LLD)ctrl->steadyTempIt);
+		PetscPrintf(PETSC_COMM_WORLD, "   Steady state temperature rel. tolerance : %g \n", ctrl->steadyTempTol);
+	}
 	if(ctrl->steadyTempStep) PetscPrintf(PETSC_COMM_WORLD, "   Steady state initial temperature step   : %g %s \n", ctrl->steadyTempStep, scal->lbl_time);
 	if(ctrl->initGuess)      PetscPrintf(PETSC_COMM_WORLD, "   Compute initial guess                   @ \n");
 	if(ctrl->pLithoVisc)     PetscPrintf(PETSC_COMM_WORLD, "   Use lithostatic pressure for creep      @ \n");
@@ -384,9 +404,6 @@ PetscErrorCode JacResCreateData(JacRes *jr)
 	ierr = DMCreateLocalVector (fs->DA_XY,  &jr->ldxy); CHKERRQ(ierr);
 	ierr = DMCreateLocalVector (fs->DA_XZ,  &jr->ldxz); CHKERRQ(ierr);
 	ierr = DMCreateLocalVector (fs->DA_YZ,  &jr->ldyz); CHKERRQ(ierr);
-	ierr = DMCreateGlobalVector(fs->DA_XY,  &jr->gdxy); CHKERRQ(ierr);
-	ierr = DMCreateGlobalVector(fs->DA_XZ,  &jr->gdxz); CHKERRQ(ierr);
-	ierr = DMCreateGlobalVector(fs->DA_YZ,  &jr->gdyz); CHKERRQ(ierr);
 
 	// velocity gradient tensor components   // control structure to create and destroy them
 
@@ -532,9 +549,6 @@ PetscErrorCode JacResDestroy(JacRes *jr)
 	ierr = VecDestroy(&jr->ldxz);    CHKERRQ(ierr);
 	ierr = VecDestroy(&jr->ldyz);    CHKERRQ(ierr);
 
-	ierr = VecDestroy(&jr->gdxy);    CHKERRQ(ierr);
-	ierr = VecDestroy(&jr->gdxz);    CHKERRQ(ierr);
-	ierr = VecDestroy(&jr->gdyz);    CHKERRQ(ierr);
 
 	ierr = VecDestroy(&jr->gp);      CHKERRQ(ierr);
 	ierr = VecDestroy(&jr->lp);      CHKERRQ(ierr);
@@ -746,6 +760,8 @@ PetscErrorCode JacResGetEffStrainRate(JacRes *jr)
 
 	fs = jr->fs;
 
+	ierr = PetscLogEventBegin(LaMEM_StrainRate, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	// access local (ghosted) velocity components
 	ierr = DMDAVecGetArray(fs->DA_X,   jr->lvx,  &vx);  CHKERRQ(ierr);
 	ierr = DMDAVecGetArray(fs->DA_Y,   jr->lvy,  &vy);  CHKERRQ(ierr);
@@ -973,6 +989,11 @@ PetscErrorCode JacResGetEffStrainRate(JacRes *jr)
 		LOCAL_TO_LOCAL(fs->DA_YZ,  jr->dvzdy);
 		LOCAL_TO_LOCAL(fs->DA_CEN, jr->dvzdz);
 
+	// stencil operations per cell & edge
+	ierr = PetscLogFlops(21.0*(PetscLogDouble)fs->nCells + 10.0*(PetscLogDouble)(fs->nXYEdg + fs->nXZEdg + fs->nYZEdg)); CHKERRQ(ierr);
+
+	ierr = PetscLogEventEnd(LaMEM_StrainRate, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -1111,6 +1132,8 @@ PetscErrorCode JacResGetResidual(JacRes *jr)
 	fs = jr->fs;
 	bc = jr->bc;
 
+	ierr = PetscLogEventBegin(LaMEM_Residual, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	// initialize index bounds
 	mcx = fs->dsx.tcels - 1;
 	mcy = fs->dsy.tcels - 1;
@@ -1651,6 +1674,11 @@ PetscErrorCode JacResGetResidual(JacRes *jr)
 	// check convergence of constitutive equations
 	ierr = checkConvConstEq(&ctx); CHKERRQ(ierr);
 
+	// stencil operations per cell & edge (constitutive update is not counted)
+	ierr = PetscLogFlops(85.0*(PetscLogDouble)fs->nCells + 45.0*(PetscLogDouble)(fs->nXYEdg + fs->nXZEdg + fs->nYZEdg)); CHKERRQ(ierr);
+
+	ierr = PetscLogEventEnd(LaMEM_Residual, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -25,6 +25,7 @@ struct Dike;
 struct Tensor2RN;
 struct PData;
 struct AdvCtx;
+struct TMG;
 
 //---------------------------------------------------------------------------
 //.....................   Deviatoric solution variables   ...................
@@ -38,6 +39,7 @@ struct SolVarDev
 	PetscScalar  Hr;     // shear heating term contribution
 	PetscScalar  APS;    // accumulated plastic strain
 	PetscScalar  PSR;    // plastic strain-rate contribution
+	PetscScalar  DII;    // effective strain rate (second invariant)
 
 };
 
@@ -129,6 +131,8 @@ struct Controls
 	PetscInt    actSteadyTemp;  // steady-state temperature initial guess flag
 	PetscScalar steadyTempStep; // time for (quasi-)steady-state temperature initial guess
 	PetscInt    steadyNumStep;  // number of steps for (quasi-)steady-state temperature initial guess
+	PetscInt    steadyTempIt;   // maximum number of nonlinear steady-state temperature iterations (useTk)
+	PetscScalar steadyTempTol;  // relative residual tolerance of nonlinear steady-state temperature iterations
 	PetscInt    actHeatRech;    // heat recharge setting
 	PetscInt    initLithPres;   // set initial pressure to lithostatic pressure
 	PetscInt    initGuess;      // initial guess activation flag
@@ -202,14 +206,6 @@ struct JacRes
 
 	// strain-rate components (also used as buffer vectors)
 	Vec ldxx, ldyy, ldzz, ldxy, ldxz, ldyz; // local (ghosted)
-	Vec                   gdxy, gdxz, gdyz; // global
-	// (ADVInterpMarkToEdge & ADVInterpFieldToMark is the only
-	//  couple of functions where global vectors (gdxy, gdxz, gdyz) are used.
-	//  Get a fuck rid of this ugly averaging between markers & edges!
-	//  In ADVInterpFieldToMark it's easy.
-	//  In ADVInterpMarkToEdge it's impossible because of assembly operation.
-	//  Really really really need to switch to ghost marker approach!
-	//  Also to get communication pattern independent of number of phases.
 
 	// For almost all the purposes only one center-based array is necessary instead of three
 	// for example - strain rate contributions from centers can be stored in one array
@@ -253,6 +249,7 @@ struct JacRes
 	Vec dT;   // temperature increment (global)
 	Vec ge;   // energy residual (global)
 	KSP tksp; // temperature diffusion solver
+	TMG *tmg; // temperature multigrid preconditioner (optional)
 
 	//==========================
 	// 2D integration primitives
@@ -17,6 +17,7 @@
 #include "tools.h"
 #include "Tensor.h"
 #include "parsing.h"
+#include "profile.h"
 //---------------------------------------------------------------------------
 #define gradComp(v, dx, bdx1, fdx1, bdx2, fdx2, dvdx, dvdx1, dvdx2, vc) \
 	dvdx  = ( v[9] - v[4])/dx; \
@@ -306,6 +307,8 @@ PetscErrorCode JacResGetLithoStaticPressure(JacRes *jr)
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	ierr = PetscLogEventBegin(LaMEM_LithoPres, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	// access context
 	fs  =  jr->fs;
 	dsz = &fs->dsz;
@@ -392,6 +395,11 @@ PetscErrorCode JacResGetLithoStaticPressure(JacRes *jr)
 	// fill ghost points
 	LOCAL_TO_LOCAL(fs->DA_CEN, jr->lp_lith)
 
+	// integration operations per cell
+	ierr = PetscLogFlops(6.0*(PetscLogDouble)fs->nCells); CHKERRQ(ierr);
+
+	ierr = PetscLogEventEnd(LaMEM_LithoPres, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
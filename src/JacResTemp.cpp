@@ -20,6 +20,7 @@
 #include "matrix.h"
 #include "surf.h"
 #include "dike.h"
+#include "multigrid.h"
 
 //---------------------------------------------------------------------------
 
@@ -171,10 +172,13 @@ PetscErrorCode JacResCreateTempParam(JacRes *jr)
 
 	FDSTAG *fs;
 	const PetscInt *lx, *ly, *lz;
+	char      pc_type[_str_len_];
+	PetscBool flg;
 
 	PetscFunctionBeginUser;
 
-	fs = jr->fs;
+	fs      = jr->fs;
+	jr->tmg = NULL;
 
 	// create local temperature vector using box-stencil central DMDA
 	PetscCall(DMCreateLocalVector(fs->DA_CEN, &jr->lT));
@@ -222,6 +226,16 @@ PetscErrorCode JacResCreateTempParam(JacRes *jr)
 	PetscCall(KSPSetOptionsPrefix(jr->tksp,"ts_"));
 	PetscCall(KSPSetFromOptions(jr->tksp));
 
+	// check whether built-in temperature multigrid is requested
+	PetscCall(PetscOptionsGetString(NULL, NULL, "-tmg_pc_type", pc_type, _str_len_, &flg));
+
+	if(flg == PETSC_TRUE && !strcmp(pc_type, "mg"))
+	{
+		PetscCall(PetscMalloc(sizeof(TMG), &jr->tmg));
+		PetscCall(TMGCreate(jr->tmg, jr));
+		PetscCall(TMGSetPC(jr->tmg, jr->tksp));
+	}
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -246,6 +260,12 @@ PetscErrorCode JacResDestroyTempParam(JacRes *jr)
 
 	PetscCall(KSPDestroy(&jr->tksp));
 
+	if(jr->tmg)
+	{
+		PetscCall(TMGDestroy(jr->tmg));
+		PetscCall(PetscFree(jr->tmg));
+	}
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
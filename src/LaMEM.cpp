@@ -13,6 +13,7 @@
 #include "parsing.h"
 #include "adjoint.h"
 #include "phase.h"
+#include "profile.h"
 //---------------------------------------------------------------------------
 static char help[] = "Solves 3D Stokes equations using multigrid .\n\n";
 //---------------------------------------------------------------------------
@@ -24,6 +25,7 @@ int main(int argc, char **argv)
 	ierr = PetscInitialize(&argc,&argv,(char *)0, help); CHKERRQ(ierr);
 	ModParam IOparam;
 	char      str[_str_len_];
+	PetscBool ensemble;
 
 	// set default to be a forward run and overwrite it with input file options
 	ierr = PetscMalloc(sizeof(ModParam), &IOparam);  CHKERRQ(ierr);
@@ -47,7 +49,18 @@ int main(int argc, char **argv)
 	PetscCall(PetscLogStageRegister("Advect markers", &IOparam.stages[2])); 
 	PetscCall(PetscLogStageRegister("I/O",            &IOparam.stages[3]));
 
-	if(IOparam.use == 0)
+	/* Register profiling events */
+	ierr = LaMEMLogEventRegister(); CHKERRQ(ierr);
+
+	// ensemble of forward models?
+	ierr = PetscOptionsHasName(NULL, NULL, "-ensemble_file", &ensemble); CHKERRQ(ierr);
+
+	if(IOparam.use == 0 && ensemble)
+	{
+		// Ensemble of forward simulations
+		ierr = LaMEMLibEnsembleMain(IOparam.stages); CHKERRQ(ierr);
+	}
+	else if(IOparam.use == 0)
 	{
 		// Forward simulation	
 		ierr = LaMEMLibMain(NULL,IOparam.stages); CHKERRQ(ierr);
@@ -56,6 +69,9 @@ int main(int argc, char **argv)
 	{
 		// Inversion or adjoint gradient computation
 		ierr = LaMEMAdjointMain(&IOparam); CHKERRQ(ierr);
+
+		// release forward model kept in memory
+		ierr = LaMEMLibDestroyModel(&IOparam); CHKERRQ(ierr);
 	}
 
 	// destroy file buffer
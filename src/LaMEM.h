@@ -41,6 +41,9 @@
 // marker storage capacity overhead
 #define _cap_overhead_ 1.61803398875
 
+// maximum number of compact marker records per restart I/O chunk
+#define _max_pack_chunk_ 65536
+
 // maximum marker per cell per direction
 #define _max_nmark_ 5
 
@@ -191,5 +194,15 @@ typedef pair <PetscInt,    PetscInt> ipair;
 
 PetscErrorCode LaMEMLibMain(void *param,PetscLogStage stages[4]);
 
+// run ensemble of independent forward models on groups of ranks
+
+PetscErrorCode LaMEMLibEnsembleMain(PetscLogStage stages[4]);
+
+PetscErrorCode LaMEMLibEnsembleMember(const char *name, const char *opts, char *cwd, PetscBool *moved, PetscLogStage stages[4]);
+
+// release forward model kept in memory between LaMEMLibMain calls
+
+PetscErrorCode LaMEMLibDestroyModel(void *param);
+
 //-----------------------------------------------------------------------------
 #endif
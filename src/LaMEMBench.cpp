@@ -0,0 +1,526 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+//.......................... LaMEM kernel microbenchmarks ....................
+//---------------------------------------------------------------------------
+//
+// Builds a synthetic model (FDSTAG grid, marker cloud with a phase mix of
+// linear viscous, power-law and plastic material) in memory and times the
+// hot kernels in isolation. Run on any number of ranks:
+//
+//   mpiexec -n 8 ./LaMEMBench -bench_nel 64,64,64 -bench_nrep 20
+//
+// Options:
+//   -bench_nel    <nx,ny,nz>  number of cells (default 32,32,32)
+//   -bench_nmark  <n>         markers per cell per direction (default 3)
+//   -bench_nlvl   <n>         multigrid levels (default 3)
+//   -bench_nrep   <n>         number of repetitions per kernel (default 10)
+//   -bench_kernel <name>      run single kernel only
+//
+// Reported time is the maximum over ranks, throughput refers to global
+// number of cells or markers processed per second.
+//---------------------------------------------------------------------------
+#include "LaMEM.h"
+#include "phase.h"
+#include "dike.h"
+#include "parsing.h"
+#include "scaling.h"
+#include "tssolve.h"
+#include "tools.h"
+#include "fdstag.h"
+#include "bc.h"
+#include "JacRes.h"
+#include "constEq.h"
+#include "interpolate.h"
+#include "surf.h"
+#include "paraViewOutBin.h"
+#include "paraViewOutSurf.h"
+#include "multigrid.h"
+#include "matrix.h"
+#include "lsolve.h"
+#include "nlsolve.h"
+#include "Tensor.h"
+#include "advect.h"
+#include "AVD.h"
+#include "marker.h"
+#include "paraViewOutMark.h"
+#include "paraViewOutAVD.h"
+#include "objFunct.h"
+#include "adjoint.h"
+#include "paraViewOutPassiveTracers.h"
+#include "profile.h"
+#include "LaMEMLib.h"
+//---------------------------------------------------------------------------
+static char help[] = "Times LaMEM kernels on synthetic models.\n\n";
+//---------------------------------------------------------------------------
+struct Bench
+{
+	LaMEMLib    lm;                  // library context
+	LaMEMSolver sol;                 // forward solver objects
+	PetscInt    nrep;                // number of repetitions
+	PetscBool   single;              // run single kernel
+	char        kernel[_str_len_];   // kernel name
+};
+//---------------------------------------------------------------------------
+static PetscErrorCode BenchCreate(Bench *b)
+{
+	// create synthetic model from in-memory input parameters
+
+	PetscInt  nel[3], nmark, nlvl, nmax;
+	PetscBool found;
+	size_t    nbuff;
+	char      *buff;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	nel[0] = nel[1] = nel[2] = 32;
+	nmark  = 3;
+	nlvl   = 3;
+	nmax   = 3;
+
+	b->nrep = 10;
+
+	ierr = PetscOptionsGetIntArray(NULL, NULL, "-bench_nel",    nel, &nmax, NULL); CHKERRQ(ierr);
+	ierr = PetscOptionsGetInt     (NULL, NULL, "-bench_nmark", &nmark,      NULL); CHKERRQ(ierr);
+	ierr = PetscOptionsGetInt     (NULL, NULL, "-bench_nlvl",  &nlvl,       NULL); CHKERRQ(ierr);
+	ierr = PetscOptionsGetInt     (NULL, NULL, "-bench_nrep",  &b->nrep,    NULL); CHKERRQ(ierr);
+
+	ierr = PetscOptionsGetCheckString("-bench_kernel", b->kernel, &found); CHKERRQ(ierr);
+
+	b->single = found;
+
+	if(b->nrep < 1) b->nrep = 1;
+
+	// compile input parameters
+	// phase 0 - linear viscous matrix
+	// phase 1 - power-law sphere
+	// phase 2 - visco-plastic bottom layer
+	nbuff = 4096;
+
+	ierr = PetscMalloc(nbuff*sizeof(char), &buff); CHKERRQ(ierr);
+
+	ierr = PetscSNPrintf(buff, nbuff,
+		"units = none\n"
+		"time_end = 1.0\n dt = 1e-3\n dt_min = 1e-6\n dt_max = 1.0\n"
+		"nstep_max = 1\n nstep_out = 0\n nstep_rdb = 0\n"
+		"nel_x = %lld\n nel_y = %lld\n nel_z = %lld\n"
+		"coord_x = 0.0 1.0\n coord_y = 0.0 1.0\n coord_z = 0.0 1.0\n"
+		"gravity = 0.0 0.0 -1.0\n init_guess = 0\n eta_min = 1e-3\n eta_max = 1e6\n"
+		"SolverType = multigrid\n MGLevels = %lld\n MGSweeps = 10\n MGSmoother = jacobi\n MGCoarseSolver = redundant\n"
+		"msetup = geom\n nmark_x = %lld\n nmark_y = %lld\n nmark_z = %lld\n"
+		"bg_phase = 0\n rand_noise = 1\n advect = rk2\n interp = stagp\n"
+		"mark_ctrl = avd\n nmark_lim = %lld %lld\n"
+		"<SphereStart>\n phase = 1\n center = 0.5 0.5 0.5\n radius = 0.25\n <SphereEnd>\n"
+		"<BoxStart>\n phase = 2\n bounds = 0.0 1.0 0.0 1.0 0.0 0.2\n <BoxEnd>\n"
+		"out_file_name = bench\n out_pvd = 0\n"
+		"<MaterialStart>\n ID = 0\n rho = 1.0\n eta = 1.0\n <MaterialEnd>\n"
+		"<MaterialStart>\n ID = 1\n rho = 2.0\n Bn = 1.0\n n = 3.0\n <MaterialEnd>\n"
+		"<MaterialStart>\n ID = 2\n rho = 1.5\n eta = 10.0\n ch = 0.1\n fr = 30.0\n <MaterialEnd>\n"
+		"<PetscOptionsStart>\n -snes_type ksponly\n -pcmat_type mono\n -jp_type mg\n <PetscOptionsEnd>\n",
+		(LLD)nel[0], (LLD)nel[1], (LLD)nel[2], (LLD)nlvl,
+		(LLD)nmark, (LLD)nmark, (LLD)nmark,
+		(LLD)(nmark*nmark*nmark), (LLD)(8*nmark*nmark*nmark)); CHKERRQ(ierr);
+
+	// setup cross-references between library objects
+	ierr = LaMEMLibSetLinks(&b->lm); CHKERRQ(ierr);
+
+	// create library objects
+	ierr = FBSetInputBuffer(buff);       CHKERRQ(ierr);
+	ierr = LaMEMLibCreate(&b->lm, NULL); CHKERRQ(ierr);
+	ierr = FBSetInputBuffer(NULL);       CHKERRQ(ierr);
+
+	ierr = PetscFree(buff); CHKERRQ(ierr);
+
+	// create Stokes preconditioner, matrix and nonlinear solver
+	ierr = LaMEMLibSolverCreate(&b->lm, &b->sol); CHKERRQ(ierr);
+
+	if(b->sol.pc->type != _STOKES_MG_)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Benchmark requires coupled multigrid preconditioner (-pcmat_type mono -jp_type mg)");
+	}
+
+	// initialize boundary conditions, temperature, pressure & residual
+	ierr = LaMEMLibInitGuess(&b->lm, b->sol.snes); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode BenchDestroy(Bench *b)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = LaMEMLibSolverDestroy(&b->sol); CHKERRQ(ierr);
+	ierr = LaMEMLibDestroy(&b->lm);        CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscBool BenchActive(Bench *b, const char *name)
+{
+	if(!b->single) return PETSC_TRUE;
+
+	return (PetscBool)(!strcmp(b->kernel, name));
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode BenchReport(
+	Bench          *b,
+	const char     *name,  // kernel name
+	const char     *unit,  // processed items
+	PetscLogDouble  t,     // local time of all repetitions
+	PetscInt        nloc)  // local number of items per repetition
+{
+	PetscLogDouble tmax, nglob, n;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	n = (PetscLogDouble)nloc;
+
+	ierr = MPI_Allreduce(&t, &tmax,  1, MPI_DOUBLE, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+	ierr = MPI_Allreduce(&n, &nglob, 1, MPI_DOUBLE, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	tmax /= (PetscLogDouble)b->nrep;
+
+	PetscPrintf(PETSC_COMM_WORLD, "%-20s %12.4e %12.0f %-8s %12.4e\n", name, tmax, nglob, unit, tmax > 0.0 ? nglob/tmax : 0.0);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode BenchConstEq(Bench *b)
+{
+	// deviatoric constitutive equations over the phase mix (cell centers)
+
+	JacRes        *jr;
+	SolVarCell    *svCell;
+	ConstEqCtx     ctx;
+	PetscInt       i, it;
+	PetscLogDouble t0, t1;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!BenchActive(b, "devConstEq")) PetscFunctionReturn(0);
+
+	jr = &b->lm.jr;
+
+	ierr = setUpConstEq(&ctx, jr); CHKERRQ(ierr);
+
+	PetscTime(&t0);
+
+	for(it = 0; it < b->nrep; it++)
+	{
+		for(i = 0; i < jr->fs->nCells; i++)
+		{
+			svCell = &jr->svCell[i];
+
+			ierr = setUpCtrlVol(&ctx, svCell->phRat, &svCell->svDev, &svCell->svBulk,
+				0.1, 0.1, 0.0, svCell->svBulk.Tn, 1.0 + 1e-3*(PetscScalar)i, 0.5, 1.0); CHKERRQ(ierr);
+
+			ierr = devConstEq(&ctx); CHKERRQ(ierr);
+		}
+	}
+
+	PetscTime(&t1);
+
+	ierr = BenchReport(b, "devConstEq", "cells", t1 - t0, jr->fs->nCells); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode BenchResidual(Bench *b)
+{
+	// momentum & mass residual (includes constitutive update on cells & edges)
+
+	JacRes        *jr;
+	PetscInt       it;
+	PetscLogDouble t0, t1;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!BenchActive(b, "JacResGetResidual")) PetscFunctionReturn(0);
+
+	jr = &b->lm.jr;
+
+	// set random velocity & compute strain rates
+	ierr = VecSetRandom(jr->gsol, NULL);             CHKERRQ(ierr);
+	ierr = JacResCopySol(jr, jr->gsol);              CHKERRQ(ierr);
+	ierr = JacResGetEffStrainRate(jr);               CHKERRQ(ierr);
+
+	PetscTime(&t0);
+
+	for(it = 0; it < b->nrep; it++)
+	{
+		ierr = JacResGetResidual(jr); CHKERRQ(ierr);
+	}
+
+	PetscTime(&t1);
+
+	ierr = BenchReport(b, "JacResGetResidual", "cells", t1 - t0, jr->fs->nCells); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode BenchAssemble(Bench *b)
+{
+	// monolithic preconditioner matrix assembly
+
+	PetscInt       it;
+	PetscLogDouble t0, t1;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!BenchActive(b, "PMatMonoAssemble")) PetscFunctionReturn(0);
+
+	PetscTime(&t0);
+
+	for(it = 0; it < b->nrep; it++)
+	{
+		ierr = PMatAssemble(b->sol.pm); CHKERRQ(ierr);
+	}
+
+	PetscTime(&t1);
+
+	ierr = BenchReport(b, "PMatMonoAssemble", "cells", t1 - t0, b->lm.fs.nCells); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode BenchMGApply(Bench *b)
+{
+	// one application of the coupled multigrid preconditioner
+
+	PCStokesMG    *mg;
+	Vec            x, y;
+	PetscInt       it;
+	PetscLogDouble t0, t1;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!BenchActive(b, "MGApply")) PetscFunctionReturn(0);
+
+	// assemble matrix & setup multigrid hierarchy
+	ierr = PMatAssemble(b->sol.pm);    CHKERRQ(ierr);
+	ierr = PCStokesSetup(b->sol.pc);   CHKERRQ(ierr);
+
+	mg = (PCStokesMG*)b->sol.pc->data;
+
+	ierr = VecDuplicate(b->lm.jr.gsol, &x); CHKERRQ(ierr);
+	ierr = VecDuplicate(b->lm.jr.gsol, &y); CHKERRQ(ierr);
+	ierr = VecSetRandom(x, NULL);           CHKERRQ(ierr);
+
+	PetscTime(&t0);
+
+	for(it = 0; it < b->nrep; it++)
+	{
+		ierr = PCApply(mg->mg.pc, x, y); CHKERRQ(ierr);
+	}
+
+	PetscTime(&t1);
+
+	ierr = VecDestroy(&x); CHKERRQ(ierr);
+	ierr = VecDestroy(&y); CHKERRQ(ierr);
+
+	ierr = BenchReport(b, "MGApply", "cells", t1 - t0, b->lm.fs.nCells); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode BenchMapMark(Bench *b)
+{
+	// host cell search & marker cell lists
+
+	PetscInt       it;
+	PetscLogDouble t0, t1;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!BenchActive(b, "ADVMapMarkToCells")) PetscFunctionReturn(0);
+
+	PetscTime(&t0);
+
+	for(it = 0; it < b->nrep; it++)
+	{
+		ierr = ADVMapMarkToCells(&b->lm.actx); CHKERRQ(ierr);
+	}
+
+	PetscTime(&t1);
+
+	ierr = BenchReport(b, "ADVMapMarkToCells", "markers", t1 - t0, b->lm.actx.nummark); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode BenchInterpEdge(Bench *b)
+{
+	// marker-to-edge projection (ghost markers are exchanged once)
+
+	PetscInt       it;
+	PetscLogDouble t0, t1;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!BenchActive(b, "ADVInterpMarkToEdge")) PetscFunctionReturn(0);
+
+	ierr = ADVExchangeGhost(&b->lm.actx); CHKERRQ(ierr);
+
+	PetscTime(&t0);
+
+	for(it = 0; it < b->nrep; it++)
+	{
+		ierr = ADVInterpMarkToEdge(&b->lm.actx); CHKERRQ(ierr);
+	}
+
+	PetscTime(&t1);
+
+	ierr = BenchReport(b, "ADVInterpMarkToEdge", "markers", t1 - t0, b->lm.actx.nummark + b->lm.actx.nghost); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode BenchMarkerControl(Bench *b)
+{
+	// AVD marker control, every repetition starts from the same marker cloud
+	// (markers are thinned out to force injection in every cell)
+
+	AdvCtx        *actx;
+	Marker        *markers;
+	PetscInt       i, it, nummark;
+	PetscLogDouble t, t0, t1;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!BenchActive(b, "AVDMarkerControl")) PetscFunctionReturn(0);
+
+	actx = &b->lm.actx;
+
+	// keep every other marker
+	for(i = 0, nummark = 0; i < actx->nummark; i += 2)
+	{
+		actx->markers[nummark++] = actx->markers[i];
+	}
+
+	actx->nummark = nummark;
+
+	// store marker cloud
+	ierr = PetscMalloc((size_t)nummark*sizeof(Marker), &markers); CHKERRQ(ierr);
+	ierr = PetscMemcpy(markers, actx->markers, (size_t)nummark*sizeof(Marker)); CHKERRQ(ierr);
+
+	t = 0.0;
+
+	for(it = 0; it < b->nrep; it++)
+	{
+		// restore marker cloud (storage can only grow)
+		ierr = PetscMemcpy(actx->markers, markers, (size_t)nummark*sizeof(Marker)); CHKERRQ(ierr);
+
+		actx->nummark = nummark;
+
+		ierr = ADVMapMarkToCells(actx); CHKERRQ(ierr);
+
+		PetscTime(&t0);
+
+		ierr = AVDMarkerControl(actx); CHKERRQ(ierr);
+
+		PetscTime(&t1);
+
+		t += t1 - t0;
+	}
+
+	ierr = PetscFree(markers); CHKERRQ(ierr);
+
+	ierr = BenchReport(b, "AVDMarkerControl", "markers", t, nummark); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode BenchOutBuf(Bench *b)
+{
+	// copy 3-component corner vector to output buffer
+
+	OutBuf        *outbuf;
+	PetscInt       it, n;
+	PetscLogDouble t0, t1;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!BenchActive(b, "OutBufPut3DVecComp")) PetscFunctionReturn(0);
+
+	outbuf = &b->lm.pvout.outbuf;
+
+	PetscTime(&t0);
+
+	for(it = 0; it < b->nrep; it++)
+	{
+		outbuf->cn = 0;
+
+		ierr = OutBufPut3DVecComp(outbuf, 3, 0, 1.0, 0.0); CHKERRQ(ierr);
+		ierr = OutBufPut3DVecComp(outbuf, 3, 1, 1.0, 0.0); CHKERRQ(ierr);
+		ierr = OutBufPut3DVecComp(outbuf, 3, 2, 1.0, 0.0); CHKERRQ(ierr);
+	}
+
+	PetscTime(&t1);
+
+	n = outbuf->cn;
+
+	outbuf->cn = 0;
+
+	ierr = BenchReport(b, "OutBufPut3DVecComp", "values", t1 - t0, n); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+	Bench       b;
+	PetscMPIInt size;
+
+	PetscErrorCode ierr;
+
+	ierr = PetscInitialize(&argc, &argv, (char *)0, help); CHKERRQ(ierr);
+
+	ierr = LaMEMLogEventRegister(); CHKERRQ(ierr);
+
+	ierr = PetscMemzero(&b, sizeof(Bench)); CHKERRQ(ierr);
+
+	ierr = BenchCreate(&b); CHKERRQ(ierr);
+
+	ierr = MPI_Comm_size(PETSC_COMM_WORLD, &size); CHKERRQ(ierr);
+
+	PetscPrintf(PETSC_COMM_WORLD, "==========================================================================\n");
+	PetscPrintf(PETSC_COMM_WORLD, "LaMEM kernel benchmarks: %lld ranks, %lld repetitions\n", (LLD)size, (LLD)b.nrep);
+	PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
+	PetscPrintf(PETSC_COMM_WORLD, "%-20s %12s %12s %-8s %12s\n", "kernel", "time [s]", "items", "", "items/s");
+	PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
+
+	ierr = BenchConstEq      (&b); CHKERRQ(ierr);
+	ierr = BenchResidual     (&b); CHKERRQ(ierr);
+	ierr = BenchAssemble     (&b); CHKERRQ(ierr);
+	ierr = BenchMGApply      (&b); CHKERRQ(ierr);
+	ierr = BenchMapMark      (&b); CHKERRQ(ierr);
+	ierr = BenchInterpEdge   (&b); CHKERRQ(ierr);
+	ierr = BenchOutBuf       (&b); CHKERRQ(ierr);
+	ierr = BenchMarkerControl(&b); CHKERRQ(ierr);
+
+	PetscPrintf(PETSC_COMM_WORLD, "==========================================================================\n");
+
+	ierr = BenchDestroy(&b); CHKERRQ(ierr);
+
+	ierr = PetscFinalize(); CHKERRQ(ierr);
+
+	return 0;
+}
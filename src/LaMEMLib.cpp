@@ -37,6 +37,7 @@
 #include "objFunct.h"
 #include "adjoint.h"
 #include "paraViewOutPassiveTracers.h"
+#include "profile.h"
 #include "LaMEMLib.h"
 #include "phase_transition.h"
 #include "passive_tracer.h"
@@ -90,6 +91,19 @@ PetscErrorCode LaMEMLibMain(void *param,PetscLogStage stages[4])
 		}
 	}
 
+	// solve forward model kept in memory (repeated runs of inversion)
+	if(mode == _NORMAL_ && param && ((ModParam*)param)->reuse)
+	{
+		ierr = LaMEMLibSolveModel((ModParam*)param, stages); CHKERRQ(ierr);
+
+		PetscTime(&cputime_end);
+
+		PetscPrintf(PETSC_COMM_WORLD, "Total solution time : %g (sec) \n", cputime_end - cputime_start);
+		PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
+
+		PetscFunctionReturn(0);
+	}
+
 	//===========
 	// INITIALIZE
 	//===========
@@ -125,12 +139,19 @@ PetscErrorCode LaMEMLibMain(void *param,PetscLogStage stages[4])
 	if(mode == _DRY_RUN_)
 	{
 		// compute initial residual, output & stop
-		ierr = LaMEMLibDryRun(&lm); CHKERRQ(ierr);
+		ierr = LaMEMLibDryRun(&lm);
 	}
 	else if(mode == _NORMAL_ || mode == _RESTART_)
 	{
 		// solve coupled nonlinear equations
-		ierr = LaMEMLibSolve(&lm, param,stages); CHKERRQ(ierr);
+		ierr = LaMEMLibSolve(&lm, param,stages);
+	}
+
+	// release library objects after failed solution (caller may continue, e.g. ensemble)
+	// NOTE: objects of a failed LaMEMLibCreate cannot be released individually
+	if(ierr)
+	{
+		LaMEMLibDestroy(&lm); CHKERRQ(ierr);
 	}
 
 	// destroy library objects
@@ -144,6 +165,245 @@ PetscErrorCode LaMEMLibMain(void *param,PetscLogStage stages[4])
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibEnsembleMain(PetscLogStage stages[4])
+{
+	/*
+		Runs an ensemble of independent forward models.
+		Every line of the ensemble file (-ensemble_file) lists the command-line
+		options of one member (e.g. "-rho[1] 3300 -eta[0] 1e21"), empty lines
+		and lines starting with # are skipped. The world communicator is split
+		into groups of ranks (-ensemble_groups), each group runs its members
+		one after another (see RankGroupSwitch).
+		Members run in their own directories (Member_<ID>). Output of all members
+		of a group is written to a single log file (Group_<ID>.log), because the
+		stdout viewer of the group communicator keeps the stream of its first use.
+		A failing member is reported and skipped, the group continues with the
+		next member. The number of failed members is reported at the end.
+		NOTE: an error raised on a subset of ranks of a group (e.g. by a local
+		check) before the next collective call still blocks the group, since MPI
+		provides no means to abort pending collective operations.
+		NOTE: additional input files must be specified with absolute paths.
+	*/
+
+	MPI_Comm    world, gcomm;
+	PetscMPIInt rank, grank, merr_loc, merr_max;
+	PetscInt    i, nchar, nmem, ngroups, color, nfail, nfail_loc, *beg;
+	FILE        *fp, *out, *log;
+	PetscBool   found, moved;
+	char        file[_str_len_], name[_str_len_], path[PETSC_MAX_PATH_LEN], cwd[PETSC_MAX_PATH_LEN];
+	char        *buff, *line, *opts;
+
+	PetscErrorCode ierr, merr;
+	PetscFunctionBeginUser;
+
+	world = PETSC_COMM_WORLD;
+
+	ierr = MPI_Comm_rank(world, &rank); CHKERRQ(ierr);
+
+	ierr = PetscOptionsGetCheckString("-ensemble_file", file, &found); CHKERRQ(ierr);
+
+	if(!found)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Ensemble file is not specified (-ensemble_file)\n");
+	}
+
+	ngroups = 1;
+
+	ierr = PetscOptionsGetInt(NULL, NULL, "-ensemble_groups", &ngroups, NULL); CHKERRQ(ierr);
+
+	ierr = RankGroupSplit(world, &ngroups, &color, &gcomm, &grank); CHKERRQ(ierr);
+
+	//==========================
+	// read ensemble member list
+	//==========================
+
+	nchar = 0;
+	buff  = NULL;
+
+	if(!rank)
+	{
+		fp = fopen(file, "rb");
+
+		if(fp == NULL)
+		{
+			SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Cannot open ensemble file %s\n", file);
+		}
+
+		fseek(fp, 0L, SEEK_END);
+
+		nchar = (PetscInt)ftell(fp) + 1;
+
+		rewind(fp);
+
+		ierr = PetscMalloc((size_t)nchar*sizeof(char), &buff); CHKERRQ(ierr);
+
+		fread(buff, (size_t)(nchar-1)*sizeof(char), 1, fp);
+
+		fclose(fp);
+
+		buff[nchar-1] = '\0';
+	}
+
+	// broadcast
+	ierr = MPI_Bcast(&nchar, 1, MPIU_INT, 0, world); CHKERRQ(ierr);
+
+	if(rank)
+	{
+		ierr = PetscMalloc((size_t)nchar*sizeof(char), &buff); CHKERRQ(ierr);
+	}
+
+	ierr = MPI_Bcast(buff, (PetscMPIInt)nchar, MPI_CHAR, 0, world); CHKERRQ(ierr);
+
+	// split lines, store beginning of every member
+	ierr = PetscMalloc((size_t)nchar*sizeof(PetscInt), &beg); CHKERRQ(ierr);
+
+	nmem = 0;
+	line = buff;
+
+	for(i = 0; i < nchar; i++)
+	{
+		if(buff[i] == '\n' || buff[i] == '\r' || buff[i] == '\0')
+		{
+			buff[i] = '\0';
+
+			// skip leading spaces, comments & empty lines
+			while(*line == ' ' || *line == '\t') line++;
+
+			if(*line && *line != '#') beg[nmem++] = (PetscInt)(line - buff);
+
+			line = buff + i + 1;
+		}
+	}
+
+	PetscPrintf(world, "Running %lld ensemble members on %lld groups of ranks \n", (LLD)nmem, (LLD)ngroups);
+	PetscPrintf(world, "--------------------------------------------------------------------------\n");
+
+	//====================
+	// run ensemble members
+	//====================
+
+	// input file is accessed from member directories
+	ierr = PetscOptionsGetCheckString("-ParamFile", file, &found); CHKERRQ(ierr);
+
+	if(found && file[0] != '/')
+	{
+		ierr = PetscGetWorkingDirectory(cwd, PETSC_MAX_PATH_LEN); CHKERRQ(ierr);
+
+		snprintf(path, PETSC_MAX_PATH_LEN, "%s/%s", cwd, file);
+
+		ierr = PetscOptionsSetValue(NULL, "-ParamFile", path); CHKERRQ(ierr);
+	}
+
+	// store options database (restored after every member)
+	ierr = PetscOptionsGetAll(NULL, &opts); CHKERRQ(ierr);
+
+	// open group log file (kept open, see above)
+	out = PETSC_STDOUT;
+	log = NULL;
+
+	if(!grank)
+	{
+		sprintf(name, "Group_%1.6lld.log", (LLD)color);
+
+		log = fopen(name, "w");
+	}
+
+	nfail_loc = 0;
+
+	for(i = color; i < nmem; i += ngroups)
+	{
+		// run model on group communicator, redirect output to log file
+		RankGroupSwitch(gcomm);
+
+		if(log) PETSC_STDOUT = log;
+
+		sprintf(name, "Member_%1.6lld", (LLD)i);
+
+		moved = PETSC_FALSE;
+
+		merr = LaMEMLibEnsembleMember(name, buff + beg[i], cwd, &moved, stages);
+
+		// errors can be raised on a subset of ranks of the group
+		merr_loc = (PetscMPIInt)merr;
+
+		ierr = MPI_Allreduce(&merr_loc, &merr_max, 1, MPI_INT, MPI_MAX, gcomm); CHKERRQ(ierr);
+
+		// restore output, directory, communicator & options (also after failure)
+		PETSC_STDOUT = out;
+
+		if(moved)
+		{
+			ierr = DirChange(cwd, NULL); CHKERRQ(ierr);
+		}
+
+		RankGroupSwitch(world);
+
+		ierr = PetscOptionsClear(NULL);               CHKERRQ(ierr);
+		ierr = PetscOptionsInsertString(NULL, opts);  CHKERRQ(ierr);
+
+		if(merr_max)
+		{
+			nfail_loc++;
+
+			if(!grank)
+			{
+				PetscPrintf(PETSC_COMM_SELF, "Ensemble member %lld on group %lld FAILED (error code %lld) \n", (LLD)i, (LLD)color, (LLD)merr_max);
+			}
+		}
+		else if(!grank)
+		{
+			PetscPrintf(PETSC_COMM_SELF, "Finished ensemble member %lld on group %lld \n", (LLD)i, (LLD)color);
+		}
+	}
+
+	// synchronize, count failed members
+	if(grank) nfail_loc = 0;
+
+	ierr = MPI_Allreduce(&nfail_loc, &nfail, 1, MPIU_INT, MPI_SUM, world); CHKERRQ(ierr);
+
+	if(log) fclose(log);
+
+	PetscPrintf(world, "--------------------------------------------------------------------------\n");
+	PetscPrintf(world, "Finished %lld ensemble members (%lld failed) \n", (LLD)nmem, (LLD)nfail);
+
+	// clean
+	ierr = PetscFree(opts);  CHKERRQ(ierr);
+	ierr = PetscFree(buff);  CHKERRQ(ierr);
+	ierr = PetscFree(beg);   CHKERRQ(ierr);
+
+	ierr = MPI_Comm_free(&gcomm); CHKERRQ(ierr);
+
+	if(nfail)
+	{
+		SETERRQ(world, PETSC_ERR_LIB, "%lld ensemble member(s) failed\n", (LLD)nfail);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibEnsembleMember(const char *name, const char *opts, char *cwd, PetscBool *moved, PetscLogStage stages[4])
+{
+	// run single ensemble member in its own directory
+	// (caller restores directory, communicator & options, also after failure)
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	PetscPrintf(PETSC_COMM_WORLD, "Ensemble member %s: %s \n", name, opts);
+
+	ierr = DirMake(name);        CHKERRQ(ierr);
+	ierr = DirChange(name, cwd); CHKERRQ(ierr);
+
+	(*moved) = PETSC_TRUE;
+
+	// set member options
+	ierr = PetscOptionsInsertString(NULL, opts); CHKERRQ(ierr);
+
+	ierr = LaMEMLibMain(NULL, stages); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode LaMEMLibCreate(LaMEMLib *lm, void *param )
 {
 	FB *fb;
@@ -192,6 +452,10 @@ PetscErrorCode LaMEMLibCreate(LaMEMLib *lm, void *param )
 	// create output object for all requested output variables
 	ierr = PVOutCreate(&lm->pvout, fb); 			CHKERRQ(ierr);
 
+	// omit optional fields from compact marker record unless requested for output
+	lm->actx.packATS = lm->pvout.omask.tot_strain;
+	lm->actx.packU   = lm->pvout.omask.tot_displ;
+
 	// create output object for the free surface
 	ierr = PVSurfCreate(&lm->pvsurf, fb); 			CHKERRQ(ierr);
 
@@ -266,42 +530,9 @@ PetscErrorCode LaMEMLibLoadRestart(LaMEMLib *lm)
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Cannot open restart file %s\n", fileName);
 	}
 
-	// read LaMEM library database
-	fread(lm, sizeof(LaMEMLib), 1, fp);
-
-	// setup cross-references between library objects
-	ierr = LaMEMLibSetLinks(lm); CHKERRQ(ierr);
-
-	// staggered grid
-	ierr = FDSTAGReadRestart(&lm->fs, fp); CHKERRQ(ierr);
-
-	// free surface
-	ierr = FreeSurfReadRestart(&lm->surf, fp); CHKERRQ(ierr);
-
-	// boundary conditions context
-	ierr = BCReadRestart(&lm->bc, fp); CHKERRQ(ierr);
-
-	// solution variables
-	ierr = JacResReadRestart(&lm->jr, fp); CHKERRQ(ierr);
-
-	// markers
-	ierr = ADVReadRestart(&lm->actx, fp); CHKERRQ(ierr);
+	// read library state
+	ierr = LaMEMLibReadRestart(lm, fp); CHKERRQ(ierr);
 
-	// passive tracers read restart
-	ierr = ReadPassive_Tracers(&lm->actx,fp); CHKERRQ(ierr);
-
-	// main output driver
-	ierr = PVOutCreateData(&lm->pvout); CHKERRQ(ierr);
-
-	// surface output driver
-	ierr = PVSurfCreateData(&lm->pvsurf); CHKERRQ(ierr);
-
-	// arrays for dynamic NotInAir phase_trans
-	ierr = DynamicPhTr_ReadRestart(&lm->jr, fp); CHKERRQ(ierr);
-
-	// read from input file, create arrays for dynamic diking, and read from restart file
-	ierr = DynamicDike_ReadRestart(&lm->dbdike, &lm->dbm, &lm->jr, &lm->ts, fp);  CHKERRQ(ierr);
- 
 	// close temporary restart file
 	fclose(fp);
 
@@ -362,6 +593,33 @@ PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm)
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Cannot open restart file %s\n", fileNameTmp);
 	}
 
+	// write library state
+	ierr = LaMEMLibWriteRestart(lm, fp); CHKERRQ(ierr);
+
+	// count output volume & close temporary restart file
+	LogBytesWritten(fp);
+
+	fclose(fp);
+
+	// delete existing restart database
+	ierr = LaMEMLibDeleteRestart(); CHKERRQ(ierr);
+
+	// push temporary database to actual
+	ierr = DirRename("./restart-tmp", "./restart");
+
+	// free space
+	free(fileNameTmp);
+
+	PrintDone(t);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibWriteRestart(LaMEMLib *lm, FILE *fp)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
 	// write LaMEM library database
 	fwrite(lm, sizeof(LaMEMLib), 1, fp);
 
@@ -389,19 +647,112 @@ PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm)
 	// dynamic dike 
 	ierr = DynamicDike_WriteRestart(&lm->jr, fp); CHKERRQ(ierr);
 
-	// close temporary restart file
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibReadRestart(LaMEMLib *lm, FILE *fp)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// read LaMEM library database
+	fread(lm, sizeof(LaMEMLib), 1, fp);
+
+	// setup cross-references between library objects
+	ierr = LaMEMLibSetLinks(lm); CHKERRQ(ierr);
+
+	// staggered grid
+	ierr = FDSTAGReadRestart(&lm->fs, fp); CHKERRQ(ierr);
+
+	// free surface
+	ierr = FreeSurfReadRestart(&lm->surf, fp); CHKERRQ(ierr);
+
+	// boundary conditions context
+	ierr = BCReadRestart(&lm->bc, fp); CHKERRQ(ierr);
+
+	// solution variables
+	ierr = JacResReadRestart(&lm->jr, fp); CHKERRQ(ierr);
+
+	// markers
+	ierr = ADVReadRestart(&lm->actx, fp); CHKERRQ(ierr);
+
+	// passive tracers read restart
+	ierr = ReadPassive_Tracers(&lm->actx,fp); CHKERRQ(ierr);
+
+	// main output driver
+	ierr = PVOutCreateData(&lm->pvout); CHKERRQ(ierr);
+
+	// surface output driver
+	ierr = PVSurfCreateData(&lm->pvsurf); CHKERRQ(ierr);
+
+	// arrays for dynamic NotInAir phase_trans
+	ierr = DynamicPhTr_ReadRestart(&lm->jr, fp); CHKERRQ(ierr);
+
+	// read from input file, create arrays for dynamic diking, and read from restart file
+	ierr = DynamicDike_ReadRestart(&lm->dbdike, &lm->dbm, &lm->jr, &lm->ts, fp);  CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibSaveState(LaMEMLib *lm, char **buff, size_t *size)
+{
+	// serialize library state into a memory buffer (same layout as restart database)
+
+	FILE *fp;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+#ifdef _WIN32
+	fp = tmpfile();
+#else
+	fp = open_memstream(buff, size);
+#endif
+
+	if(fp == NULL)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Cannot open memory stream to save library state\n");
+	}
+
+	ierr = LaMEMLibWriteRestart(lm, fp); CHKERRQ(ierr);
+
+#ifdef _WIN32
+	// copy temporary file to memory buffer
+	(*size) = (size_t)ftell(fp);
+	(*buff) = (char*)malloc(*size);
+	rewind(fp);
+	fread(*buff, 1, *size, fp);
+#endif
+
 	fclose(fp);
 
-	// delete existing restart database
-	ierr = LaMEMLibDeleteRestart(); CHKERRQ(ierr);
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibLoadState(LaMEMLib *lm, char *buff, size_t size)
+{
+	// recreate library objects from a state saved in memory
 
-	// push temporary database to actual
-	ierr = DirRename("./restart-tmp", "./restart");
+	FILE *fp;
 
-	// free space
-	free(fileNameTmp);
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
 
-	PrintDone(t);
+#ifdef _WIN32
+	fp = tmpfile();
+	if(fp) { fwrite(buff, 1, size, fp); rewind(fp); }
+#else
+	fp = fmemopen(buff, size, "rb");
+#endif
+
+	if(fp == NULL)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Cannot open memory stream to load library state\n");
+	}
+
+	ierr = LaMEMLibReadRestart(lm, fp); CHKERRQ(ierr);
+
+	fclose(fp);
 
 	PetscFunctionReturn(0);
 }
@@ -420,47 +771,126 @@ PetscErrorCode LaMEMLibDeleteRestart()
 	// get MPI processor rank
 	MPI_Comm_rank(PETSC_COMM_WORLD, &rank);
 
-	asprintf(&fileName, "./restart/rdb.%1.8lld.dat", (LLD)rank);
+	asprintf(&fileName, "./restart/rdb.%1.8lld.dat", (LLD)rank);
+
+	// check for existing restart database
+	ierr = DirCheck("./restart", &exists); CHKERRQ(ierr);
+
+	if(exists)
+	{
+		// delete existing database
+		status = remove(fileName);
+
+		if(status && errno != ENOENT)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Failed to delete file %s", fileName);
+		}
+
+		ierr = DirRemove("./restart"); CHKERRQ(ierr);
+	}
+
+	// free space
+	free(fileName);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibDestroy(LaMEMLib *lm)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = FDSTAGDestroy  (&lm->fs);     CHKERRQ(ierr);
+	ierr = FreeSurfDestroy(&lm->surf);   CHKERRQ(ierr);
+	ierr = BCDestroy      (&lm->bc);     CHKERRQ(ierr);
+	ierr = JacResDestroy  (&lm->jr);     CHKERRQ(ierr);
+	ierr = ADVPtrDestroy  (&lm->actx);   CHKERRQ(ierr);
+	ierr = ADVDestroy     (&lm->actx);   CHKERRQ(ierr);
+	ierr = PVOutDestroy   (&lm->pvout);  CHKERRQ(ierr);
+	ierr = PVSurfDestroy  (&lm->pvsurf); CHKERRQ(ierr);
+
+	ierr = DynamicPhTrDestroy (&lm->dbm); CHKERRQ(ierr);
+	ierr = DynamicDike_Destroy(&lm->jr); CHKERRQ(ierr);
+
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibSolveModel(ModParam *IOparam, PetscLogStage stages[4])
+{
+	// solve forward model that is kept in memory between calls
+	// (created once, initial state is restored from a memory snapshot)
+
+	LaMEMModel     *model;
+	PetscLogDouble  t;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	model = (LaMEMModel*)IOparam->model;
+
+	if(!model)
+	{
+		// create library objects
+		ierr = PetscMalloc(sizeof(LaMEMModel), &model); CHKERRQ(ierr);
+		ierr = PetscMemzero(model, sizeof(LaMEMModel)); CHKERRQ(ierr);
+
+		ierr = LaMEMLibSetLinks(&model->lm); CHKERRQ(ierr);
+
+		ierr = LaMEMLibCreate(&model->lm, IOparam); CHKERRQ(ierr);
+
+		// store initial state
+		PrintStart(&t, "Saving initial model state", NULL);
+
+		ierr = LaMEMLibSaveState(&model->lm, &model->buff, &model->size); CHKERRQ(ierr);
 
-	// check for existing restart database
-	ierr = DirCheck("./restart", &exists); CHKERRQ(ierr);
+		PrintDone(t);
 
-	if(exists)
+		IOparam->model = model;
+	}
+	else
 	{
-		// delete existing database
-		status = remove(fileName);
+		// restore initial state
+		PrintStart(&t, "Restoring initial model state", NULL);
 
-		if(status && errno != ENOENT)
-		{
-			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Failed to delete file %s", fileName);
-		}
+		ierr = LaMEMLibDestroy(&model->lm); CHKERRQ(ierr);
 
-		ierr = DirRemove("./restart"); CHKERRQ(ierr);
+		ierr = LaMEMLibLoadState(&model->lm, model->buff, model->size); CHKERRQ(ierr);
+
+		// apply current material parameters
+		ierr = DBMatCreate(&model->lm.dbm, IOparam->fb, PETSC_FALSE); CHKERRQ(ierr);
+
+		PrintDone(t);
 	}
 
-	// free space
-	free(fileName);
+	// solve coupled nonlinear equations
+	ierr = LaMEMLibSolve(&model->lm, IOparam, stages); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode LaMEMLibDestroy(LaMEMLib *lm)
+PetscErrorCode LaMEMLibDestroyModel(void *param)
 {
+	ModParam   *IOparam;
+	LaMEMModel *model;
+
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	ierr = FDSTAGDestroy  (&lm->fs);     CHKERRQ(ierr);
-	ierr = FreeSurfDestroy(&lm->surf);   CHKERRQ(ierr);
-	ierr = BCDestroy      (&lm->bc);     CHKERRQ(ierr);
-	ierr = JacResDestroy  (&lm->jr);     CHKERRQ(ierr);
-	ierr = ADVPtrDestroy  (&lm->actx);   CHKERRQ(ierr);
-	ierr = ADVDestroy     (&lm->actx);   CHKERRQ(ierr);
-	ierr = PVOutDestroy   (&lm->pvout);  CHKERRQ(ierr);
-	ierr = PVSurfDestroy  (&lm->pvsurf); CHKERRQ(ierr);
+	if(!param) PetscFunctionReturn(0);
 
-	ierr = DynamicPhTrDestroy (&lm->dbm); CHKERRQ(ierr);
-	ierr = DynamicDike_Destroy(&lm->jr); CHKERRQ(ierr);
+	IOparam = (ModParam*)param;
+	model   = (LaMEMModel*)IOparam->model;
+
+	if(!model) PetscFunctionReturn(0);
 
+	ierr = LaMEMLibDestroy(&model->lm); CHKERRQ(ierr);
+
+	free(model->buff);
+
+	ierr = PetscFree(model); CHKERRQ(ierr);
+
+	IOparam->model = NULL;
 
 	PetscFunctionReturn(0);
 }
@@ -606,32 +1036,31 @@ PetscErrorCode LaMEMLibSaveOutput(LaMEMLib *lm)
 //---------------------------------------------------------------------------
 PetscErrorCode LaMEMLibSolve(LaMEMLib *lm, void *param, PetscLogStage stages[4])
 {
-	PMat           pm;     // preconditioner matrix    (to be removed!)
-	PCStokes       pc;     // Stokes preconditioner    (to be removed!)
-	NLSol          nl;     // nonlinear solver context (to be removed!)
+	LaMEMSolver    sol;    // forward solver objects
  	AdjGrad        aop;    // Adjoint options          (to be removed!)
-	SNES           snes;   // PETSc nonlinear solver
 	PetscInt       restart;
-	PetscLogDouble t;
-
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// create Stokes preconditioner, matrix and nonlinear solver
-	ierr = PMatCreate(&pm, &lm->jr);    CHKERRQ(ierr);
-	ierr = PCStokesCreate(&pc, pm);     CHKERRQ(ierr);
-	ierr = NLSolCreate(&nl, pc, &snes); CHKERRQ(ierr);
+	ierr = LaMEMLibSolverCreate(lm, &sol); CHKERRQ(ierr);
 
 	//==============
 	// INITIAL GUESS
 	//==============
 	PetscCall(PetscLogStagePush(stages[0])); /* Start profiling stage*/
 
-	ierr = LaMEMLibInitGuess(lm, snes); CHKERRQ(ierr);
+	ierr = LaMEMLibInitGuess(lm, sol.snes); CHKERRQ(ierr);
+
+	// save output for inspection
+	ierr = LaMEMLibSaveOutput(lm); CHKERRQ(ierr);
 
 	PetscCall(PetscLogStagePop()); /* Stop profiling stage*/
 
+	// exclude initial guess from performance log
+	ierr = PerfLogStart(&sol.plog); CHKERRQ(ierr);
+
 	if (param)
 	{
 		ierr = AdjointCreate(&aop, &lm->jr, (ModParam *)param); CHKERRQ(ierr);
@@ -643,100 +1072,17 @@ PetscErrorCode LaMEMLibSolve(LaMEMLib *lm, void *param, PetscLogStage stages[4])
 
 	while(!TSSolIsDone(&lm->ts))
 	{
-		//====================================
-		//	NONLINEAR THERMO-MECHANICAL SOLVER
-		//====================================
-
-		// apply phase transitions on particles
-		ierr = Phase_Transition(&lm->actx); CHKERRQ(ierr);
-		
-		// initialize boundary constraint vectors
-		ierr = BCApply(&lm->bc); CHKERRQ(ierr);
-
-	
-		// initialize temperature
-		ierr = JacResInitTemp(&lm->jr); CHKERRQ(ierr);
-
-		// compute elastic parameters
-		ierr = JacResGetI2Gdt(&lm->jr); CHKERRQ(ierr);
-
-		// solve nonlinear equation system with SNES
-		PetscTime(&t);
-
-		PetscCall(PetscLogStagePush(stages[1])); /* Start profiling stage*/
-
-		ierr = SNESSolve(snes, NULL, lm->jr.gsol); CHKERRQ(ierr);
-
-		PetscCall(PetscLogStagePop()); /* Stop profiling stage*/
-		// print analyze convergence/divergence reason & iteration count
-		ierr = SNESPrintConvergedReason(snes, t); CHKERRQ(ierr);
-
-		// view nonlinear residual
-		ierr = JacResViewRes(&lm->jr); CHKERRQ(ierr);
-
-		// Compute adjoint gradients every TS
-		if (param)
-		{
-			
-			ModParam      *IOparam;
-			IOparam       = (ModParam *)param;	
-			if (IOparam->use == _adjointgradients_ || IOparam->use == _gradientdescent_ || IOparam->use == _inversion_ )
-			{	/* 	Compute the adjoint gradients 
-				 	
-					This is done here, as the adjoint should be cmputed with the current residual that does not take advection etc.
-					into account. It does compute it every dt; one can perhaps only activate it for the last dt.
-				*/
-				ierr = AdjointObjectiveAndGradientFunction(&aop, &lm->jr, &nl, (ModParam *)param, snes, &lm->surf); CHKERRQ(ierr);
-			}
-		}
-
-		//==========================================
-		// MARKER & FREE SURFACE ADVECTION + EROSION
-		//==========================================
+		// solve & advect
+		ierr = LaMEMLibSolveTimeStep(lm, &sol, param, &aop, stages, &restart); CHKERRQ(ierr);
 
-		PetscCall(PetscLogStagePush(stages[2])); /* Start profiling stage*/
-
-		// calculate current time step
-		ierr = ADVSelectTimeStep(&lm->actx, &restart); CHKERRQ(ierr);
-		
 		// restart if fixed time step is larger than CFLMAX
 		if(restart) continue;
 
-		// advect free surface
-		ierr = FreeSurfAdvect(&lm->surf); CHKERRQ(ierr);
-
-		// advect markers
-		ierr = ADVAdvect(&lm->actx); CHKERRQ(ierr);
-
-		// apply background strain-rate "DWINDLAR" BC (Bob Shaw "Ship of Strangers")
-		ierr = BCStretchGrid(&lm->bc); CHKERRQ(ierr);
-
-		// exchange markers between the processors (after mesh advection)
-		ierr = ADVExchange(&lm->actx); CHKERRQ(ierr);
-
-		// Advect Passive tracers
-		ierr = ADVAdvectPassiveTracer(&lm->actx); CHKERRQ(ierr);
-
-		PetscCall(PetscLogStagePop()); /* Stop profiling stage*/
-
-		// apply erosion to the free surface
-		ierr = FreeSurfAppErosion(&lm->surf); CHKERRQ(ierr);
-
-		// apply sedimentation to the free surface
-		ierr = FreeSurfAppSedimentation(&lm->surf); CHKERRQ(ierr);
-
-		// remap markers onto (stretched) grid
-		ierr = ADVRemap(&lm->actx); CHKERRQ(ierr);
-
-		// update phase ratios taking into account actual free surface position
-		ierr = FreeSurfGetAirPhaseRatio(&lm->surf); CHKERRQ(ierr);
-
 		//==================
 		// Save data to disk
 		//==================
-	
-		// update time stamp and counter
-		ierr = TSSolStepForward(&lm->ts); CHKERRQ(ierr);
+
+		ierr = PerfLogBegin(&sol.plog, _perf_output_); CHKERRQ(ierr);
 
 		PetscCall(PetscLogStagePush(stages[3])); /* Start profiling stage*/
 
@@ -748,6 +1094,9 @@ PetscErrorCode LaMEMLibSolve(LaMEMLib *lm, void *param, PetscLogStage stages[4])
 		// restart database
 		ierr = LaMEMLibSaveRestart(lm); CHKERRQ(ierr);
 
+		// append performance log record
+		ierr = PerfLogStep(&sol.plog, &lm->actx, &lm->ts); CHKERRQ(ierr);
+
 	}
 
 	//======================
@@ -771,10 +1120,7 @@ PetscErrorCode LaMEMLibSolve(LaMEMLib *lm, void *param, PetscLogStage stages[4])
 	}
 
 	// destroy objects
-	ierr = PCStokesDestroy(pc);    			CHKERRQ(ierr);
-	ierr = PMatDestroy    (pm);    			CHKERRQ(ierr);
-	ierr = SNESDestroy    (&snes); 			CHKERRQ(ierr);
-	ierr = NLSolDestroy   (&nl);   			CHKERRQ(ierr);
+	ierr = LaMEMLibSolverDestroy(&sol); CHKERRQ(ierr);
 
 	// save marker database
 	ierr = ADVMarkSave(&lm->actx); CHKERRQ(ierr);
@@ -782,6 +1128,170 @@ PetscErrorCode LaMEMLibSolve(LaMEMLib *lm, void *param, PetscLogStage stages[4])
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibSolverCreate(LaMEMLib *lm, LaMEMSolver *sol)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// create Stokes preconditioner, matrix and nonlinear solver
+	ierr = PMatCreate(&sol->pm, &lm->jr);                 CHKERRQ(ierr);
+	ierr = PCStokesCreate(&sol->pc, sol->pm);             CHKERRQ(ierr);
+	ierr = NLSolCreate(&sol->nl, sol->pc, &sol->snes);    CHKERRQ(ierr);
+
+	// create performance log (if requested)
+	ierr = PerfLogCreate(&sol->plog); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibSolverDestroy(LaMEMSolver *sol)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PCStokesDestroy(sol->pc);    CHKERRQ(ierr);
+	ierr = PMatDestroy    (sol->pm);    CHKERRQ(ierr);
+	ierr = SNESDestroy    (&sol->snes); CHKERRQ(ierr);
+	ierr = NLSolDestroy   (&sol->nl);   CHKERRQ(ierr);
+	ierr = PerfLogDestroy (&sol->plog); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibSolveTimeStep(
+		LaMEMLib      *lm,      // library context
+		LaMEMSolver   *sol,     // forward solver objects
+		void          *param,   // adjoint parameters (optional)
+		AdjGrad       *aop,     // adjoint context (used if param is set)
+		PetscLogStage  stages[4],
+		PetscInt      *restart) // time step must be repeated (no step is taken)
+{
+	// solve one time step (nonlinear solve, advection & erosion), no disk output
+
+	PetscLogDouble t;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	//====================================
+	//	NONLINEAR THERMO-MECHANICAL SOLVER
+	//====================================
+
+	ierr = PerfLogBegin(&sol->plog, _perf_setup_); CHKERRQ(ierr);
+
+	// apply phase transitions on particles
+	ierr = Phase_Transition(&lm->actx); CHKERRQ(ierr);
+
+	// initialize boundary constraint vectors
+	ierr = BCApply(&lm->bc); CHKERRQ(ierr);
+
+	// initialize temperature
+	ierr = JacResInitTemp(&lm->jr); CHKERRQ(ierr);
+
+	// compute elastic parameters
+	ierr = JacResGetI2Gdt(&lm->jr); CHKERRQ(ierr);
+
+	// solve nonlinear equation system with SNES
+	ierr = PerfLogBegin(&sol->plog, _perf_solve_); CHKERRQ(ierr);
+
+	PetscTime(&t);
+
+	PetscCall(PetscLogStagePush(stages[1])); /* Start profiling stage*/
+
+	// extrapolate initial guess from previous time steps (if requested)
+	ierr = NLSolPredict(&sol->nl, sol->snes, lm->jr.gsol); CHKERRQ(ierr);
+
+	ierr = SNESSolve(sol->snes, NULL, lm->jr.gsol); CHKERRQ(ierr);
+
+	// store converged solution for extrapolation
+	ierr = NLSolPredictStore(&sol->nl, sol->snes, lm->jr.gsol); CHKERRQ(ierr);
+
+	PetscCall(PetscLogStagePop()); /* Stop profiling stage*/
+	// print analyze convergence/divergence reason & iteration count
+	ierr = SNESPrintConvergedReason(sol->snes, t); CHKERRQ(ierr);
+
+	// view nonlinear residual
+	ierr = JacResViewRes(&lm->jr); CHKERRQ(ierr);
+
+	// store iteration counts
+	ierr = PerfLogSetIterations(&sol->plog, sol->snes); CHKERRQ(ierr);
+
+	// Compute adjoint gradients every TS
+	if (param)
+	{
+		
+		ModParam      *IOparam;
+		IOparam       = (ModParam *)param;	
+		if (IOparam->use == _adjointgradients_ || IOparam->use == _gradientdescent_ || IOparam->use == _inversion_ )
+		{	/* 	Compute the adjoint gradients 
+			 	
+				This is done here, as the adjoint should be cmputed with the current residual that does not take advection etc.
+				into account. It does compute it every dt; one can perhaps only activate it for the last dt.
+			*/
+			ierr = PerfLogBegin(&sol->plog, _perf_adjoint_); CHKERRQ(ierr);
+
+			ierr = AdjointObjectiveAndGradientFunction(aop, &lm->jr, &sol->nl, IOparam, sol->snes, &lm->surf); CHKERRQ(ierr);
+		}
+	}
+
+	//==========================================
+	// MARKER & FREE SURFACE ADVECTION + EROSION
+	//==========================================
+
+	ierr = PerfLogBegin(&sol->plog, _perf_advect_); CHKERRQ(ierr);
+
+	PetscCall(PetscLogStagePush(stages[2])); /* Start profiling stage*/
+
+	// calculate current time step
+	ierr = ADVSelectTimeStep(&lm->actx, restart); CHKERRQ(ierr);
+	
+	// restart if fixed time step is larger than CFLMAX
+	if(*restart)
+	{
+		PetscCall(PetscLogStagePop()); /* Stop profiling stage*/
+
+		PetscFunctionReturn(0);
+	}
+
+	// advect free surface
+	ierr = FreeSurfAdvect(&lm->surf); CHKERRQ(ierr);
+
+	// advect markers
+	ierr = ADVAdvect(&lm->actx); CHKERRQ(ierr);
+
+	// apply background strain-rate "DWINDLAR" BC (Bob Shaw "Ship of Strangers")
+	ierr = BCStretchGrid(&lm->bc); CHKERRQ(ierr);
+
+	// exchange markers between the processors (after mesh advection)
+	ierr = ADVExchange(&lm->actx); CHKERRQ(ierr);
+
+	// Advect Passive tracers
+	ierr = ADVAdvectPassiveTracer(&lm->actx); CHKERRQ(ierr);
+
+	PetscCall(PetscLogStagePop()); /* Stop profiling stage*/
+
+	ierr = PerfLogBegin(&sol->plog, _perf_remap_); CHKERRQ(ierr);
+
+	// apply erosion to the free surface
+	ierr = FreeSurfAppErosion(&lm->surf); CHKERRQ(ierr);
+
+	// apply sedimentation to the free surface
+	ierr = FreeSurfAppSedimentation(&lm->surf); CHKERRQ(ierr);
+
+	// remap markers onto (stretched) grid
+	ierr = ADVRemap(&lm->actx); CHKERRQ(ierr);
+
+	// update phase ratios taking into account actual free surface position
+	ierr = FreeSurfGetAirPhaseRatio(&lm->surf); CHKERRQ(ierr);
+
+	// update time stamp and counter
+	ierr = TSSolStepForward(&lm->ts); CHKERRQ(ierr);
+
+	ierr = PerfLogEnd(&sol->plog); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode LaMEMLibDryRun(LaMEMLib *lm)
 {
 	PetscErrorCode ierr;
@@ -855,9 +1365,6 @@ PetscErrorCode LaMEMLibInitGuess(LaMEMLib *lm, SNES snes)
 		ierr = JacResFormResidual(&lm->jr, lm->jr.gsol, lm->jr.gres); CHKERRQ(ierr);
 	}
 
-	// save output for inspection
-	ierr = LaMEMLibSaveOutput(lm); CHKERRQ(ierr);
-
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -867,6 +1374,7 @@ PetscErrorCode LaMEMLibDiffuseTemp(LaMEMLib *lm)
 	TSSol          *ts;
 	Controls       *ctrl;
 	AdvCtx         *actx;
+	KSP            tksp;
 	PetscLogDouble t;
 	PetscScalar    diff_step;
 	PetscInt       i, num_steps;
@@ -880,8 +1388,14 @@ PetscErrorCode LaMEMLibDiffuseTemp(LaMEMLib *lm)
 	ctrl    = &jr->ctrl;
 	actx    = &lm->actx;
 
+	// check activation
+	if(!ctrl->actTemp || ts->istep || (!ctrl->actSteadyTemp && !ctrl->steadyTempStep)) PetscFunctionReturn(0);
+
+	// create initial temperature solver (shared by all initial solves)
+	ierr = LaMEMLibCreateTempSolver(lm, &tksp); CHKERRQ(ierr);
+
 	// check for infinite diffusion
-	if (ctrl->actTemp && ctrl->actSteadyTemp && ts->istep==0)
+	if (ctrl->actSteadyTemp)
 	{
 		PrintStart(&t,"Computing steady-state temperature distribution", NULL);
 
@@ -890,7 +1404,16 @@ PetscErrorCode LaMEMLibDiffuseTemp(LaMEMLib *lm)
 		ierr = JacResApplyTempBC(jr); CHKERRQ(ierr);
 
 		// compute steady-state temperature distribution
-		ierr = LaMEMLibSolveTemp(lm, 0.0); CHKERRQ(ierr);
+		ierr = LaMEMLibSolveSteadyTemp(lm, tksp); CHKERRQ(ierr);
+
+		// copy temperature to markers
+		ierr = ADVMarkSetTempVector(actx); CHKERRQ(ierr);
+
+		// project temperature from markers to grid
+		ierr = ADVProjHistMarkToGrid(actx); CHKERRQ(ierr);
+
+		// initialize temperature
+		ierr = JacResInitTemp(&lm->jr); CHKERRQ(ierr);
 
 		// overwrite markers where T(phase) is set
 		ierr = ADVMarkSetTempPhase(actx); CHKERRQ(ierr);
@@ -905,7 +1428,7 @@ PetscErrorCode LaMEMLibDiffuseTemp(LaMEMLib *lm)
 	}
 
 	// check for additional limited diffusion
-	if (ctrl->actTemp && ctrl->steadyTempStep && ts->istep==0)
+	if (ctrl->steadyTempStep)
 	{
 		PrintStart(&t,"Diffusing temperature", NULL);
 
@@ -917,11 +1440,20 @@ PetscErrorCode LaMEMLibDiffuseTemp(LaMEMLib *lm)
 			num_steps = ctrl->steadyNumStep;
 			diff_step = diff_step/((PetscScalar) num_steps);
 		}
-		
+
 		for(i=0;i<num_steps;i++)
 		{
 			// diffuse
-			ierr = LaMEMLibSolveTemp(lm, diff_step); CHKERRQ(ierr);
+			ierr = LaMEMLibSolveTemp(lm, tksp, diff_step); CHKERRQ(ierr);
+
+			// copy temperature to markers
+			ierr = ADVMarkSetTempVector(actx); CHKERRQ(ierr);
+
+			// project temperature from markers to grid
+			ierr = ADVProjHistMarkToGrid(actx); CHKERRQ(ierr);
+
+			// initialize temperature
+			ierr = JacResInitTemp(&lm->jr); CHKERRQ(ierr);
 
 			// reset temperature in anomalous phases every step
 			if (ctrl->actHeatRech > 1)
@@ -953,22 +1485,23 @@ PetscErrorCode LaMEMLibDiffuseTemp(LaMEMLib *lm)
 		PrintDone(t);		
 	}
 
+	// destroy initial temperature solver
+	ierr = KSPDestroy(&tksp); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode LaMEMLibSolveTemp(LaMEMLib *lm, PetscScalar dt)
+PetscErrorCode LaMEMLibCreateTempSolver(LaMEMLib *lm, KSP *p_tksp)
 {
-	JacRes         *jr;
-	AdvCtx         *actx;
-	KSP            tksp;
-	
+	JacRes *jr;
+	KSP    tksp;
+
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// access context
-	jr   = &lm->jr;
-	actx = &lm->actx;
-	
+	jr = &lm->jr;
+
 	// create temperature diffusion solver
 	ierr = KSPCreate(PETSC_COMM_WORLD, &tksp); CHKERRQ(ierr);
 
@@ -980,9 +1513,100 @@ PetscErrorCode LaMEMLibSolveTemp(LaMEMLib *lm, PetscScalar dt)
 	ierr = KSPSetOptionsPrefix(tksp,"its_");   CHKERRQ(ierr);
 	ierr = KSPSetFromOptions(tksp);            CHKERRQ(ierr);
 
-	// compute matrix and rhs
+	// use built-in temperature multigrid if requested
+	if(jr->tmg)
+	{
+		ierr = TMGSetPC(jr->tmg, tksp); CHKERRQ(ierr);
+	}
+
+	(*p_tksp) = tksp;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibSolveSteadyTemp(LaMEMLib *lm, KSP tksp)
+{
+	// solve steady-state heat equation (zero time step)
+	// temperature-dependent conductivity is resolved by Picard iterations
+
+	JacRes      *jr;
+	Controls    *ctrl;
+	PetscInt    it, maxit;
+	PetscScalar nrm, nrm0;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// access context
+	jr   = &lm->jr;
+	ctrl = &jr->ctrl;
+
+	// single linear solve if conductivity does not depend on temperature
+	maxit = 1;
+
+	if(ctrl->useTk) maxit = ctrl->steadyTempIt;
+
+	// evaluate initial residual
+	ierr = JacResGetTempRes(jr, 0.0);     CHKERRQ(ierr);
+	ierr = VecNorm(jr->ge, NORM_2, &nrm0); CHKERRQ(ierr);
+
+	if(maxit > 1)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "   Steady temperature iteration %lld : |eRes|_2 = %12.12e \n", (LLD)0, nrm0);
+	}
+
+	for(it = 1; it <= maxit; it++)
+	{
+		// solve linearized problem (residual is up to date)
+		ierr = LaMEMLibSolveTempSystem(lm, tksp, 0.0); CHKERRQ(ierr);
+
+		if(maxit == 1) break;
+
+		// update conductivity, evaluate nonlinear residual (reused by next solve)
+		ierr = JacResGetTempRes(jr, 0.0);     CHKERRQ(ierr);
+		ierr = VecNorm(jr->ge, NORM_2, &nrm); CHKERRQ(ierr);
+
+		PetscPrintf(PETSC_COMM_WORLD, "   Steady temperature iteration %lld : |eRes|_2 = %12.12e \n", (LLD)it, nrm);
+
+		if(nrm <= ctrl->steadyTempTol*nrm0) break;
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibSolveTemp(LaMEMLib *lm, KSP tksp, PetscScalar dt)
+{
+	JacRes *jr;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// access context
+	jr = &lm->jr;
+
+	// compute rhs
 	// STEADY STATE solution is activated by setting time step to zero
 	ierr = JacResGetTempRes(jr, dt); CHKERRQ(ierr);
+
+	// compute matrix, solve linear system
+	ierr = LaMEMLibSolveTempSystem(lm, tksp, dt); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibSolveTempSystem(LaMEMLib *lm, KSP tksp, PetscScalar dt)
+{
+	// solve linearized heat equation (residual must be evaluated before)
+
+	JacRes *jr;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// access context
+	jr = &lm->jr;
+
+	// compute matrix
 	ierr = JacResGetTempMat(jr, dt); CHKERRQ(ierr);
 
 	// solve linear system
@@ -990,21 +1614,9 @@ PetscErrorCode LaMEMLibSolveTemp(LaMEMLib *lm, PetscScalar dt)
 	ierr = KSPSetUp(tksp);                          CHKERRQ(ierr);
 	ierr = KSPSolve(tksp, jr->ge, jr->dT);          CHKERRQ(ierr);
 
-	// destroy initial temperature solver
-	ierr = KSPDestroy(&tksp); CHKERRQ(ierr);
-
 	// store computed temperature, enforce boundary constraints
 	ierr = JacResUpdateTemp(jr); CHKERRQ(ierr);
 
-	// copy temperature to markers
-	ierr = ADVMarkSetTempVector(actx); CHKERRQ(ierr);
-
-	// project temperature from markers to grid
-	ierr = ADVProjHistMarkToGrid(actx); CHKERRQ(ierr);
-	
-	// initialize temperature
-	ierr = JacResInitTemp(&lm->jr); CHKERRQ(ierr);
-
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -48,6 +48,22 @@ struct LaMEMLib
 	PVPtr    pvptr;  // paraview out passive tracers
 };
 
+//---------------------------------------------------------------------------
+struct LaMEMModel
+{
+	LaMEMLib  lm;    // library context
+	char     *buff;  // initial state (same layout as restart database)
+	size_t    size;  // size of initial state buffer
+};
+//---------------------------------------------------------------------------
+struct LaMEMSolver
+{
+	PMat      pm;    // preconditioner matrix
+	PCStokes  pc;    // Stokes preconditioner
+	NLSol     nl;    // nonlinear solver context
+	SNES      snes;  // PETSc nonlinear solver
+	PerfLog   plog;  // per-step performance log
+};
 //---------------------------------------------------------------------------
 // LAMEM LIBRARY FUNCTIONS
 //---------------------------------------------------------------------------
@@ -59,10 +75,15 @@ PetscErrorCode LaMEMLibSaveGrid(LaMEMLib *lm);
 PetscErrorCode LaMEMLibLoadRestart(LaMEMLib *lm);
 
 PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm);
+PetscErrorCode LaMEMLibWriteRestart(LaMEMLib *lm, FILE *fp);
+PetscErrorCode LaMEMLibReadRestart(LaMEMLib *lm, FILE *fp);
+PetscErrorCode LaMEMLibSaveState(LaMEMLib *lm, char **buff, size_t *size);
+PetscErrorCode LaMEMLibLoadState(LaMEMLib *lm, char *buff, size_t size);
 
 PetscErrorCode LaMEMLibDeleteRestart();
 
 PetscErrorCode LaMEMLibDestroy(LaMEMLib *lm);
+PetscErrorCode LaMEMLibSolveModel(ModParam *IOparam, PetscLogStage stages[4]);
 
 PetscErrorCode LaMEMLibSetLinks(LaMEMLib *lm);
 
@@ -70,11 +91,23 @@ PetscErrorCode LaMEMLibSaveOutput(LaMEMLib *lm, PetscInt dirInd);
 
 PetscErrorCode LaMEMLibSolve(LaMEMLib *lm, void *param, PetscLogStage stages[4]);
 
+PetscErrorCode LaMEMLibSolverCreate(LaMEMLib *lm, LaMEMSolver *sol);
+
+PetscErrorCode LaMEMLibSolverDestroy(LaMEMSolver *sol);
+
+PetscErrorCode LaMEMLibSolveTimeStep(LaMEMLib *lm, LaMEMSolver *sol, void *param, AdjGrad *aop, PetscLogStage stages[4], PetscInt *restart);
+
 PetscErrorCode LaMEMLibDryRun(LaMEMLib *lm);
 
 PetscErrorCode LaMEMLibInitGuess(LaMEMLib *lm, SNES snes);
 
-PetscErrorCode LaMEMLibSolveTemp(LaMEMLib *lm, PetscScalar dt);
+PetscErrorCode LaMEMLibCreateTempSolver(LaMEMLib *lm, KSP *p_tksp);
+
+PetscErrorCode LaMEMLibSolveSteadyTemp(LaMEMLib *lm, KSP tksp);
+
+PetscErrorCode LaMEMLibSolveTemp(LaMEMLib *lm, KSP tksp, PetscScalar dt);
+
+PetscErrorCode LaMEMLibSolveTempSystem(LaMEMLib *lm, KSP tksp, PetscScalar dt);
 
 PetscErrorCode LaMEMLibDiffuseTemp(LaMEMLib *lm);
 
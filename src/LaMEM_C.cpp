@@ -0,0 +1,470 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+// LAMEM C-CALLABLE LIBRARY API
+//---------------------------------------------------------------------------
+#include "LaMEM.h"
+#include "phase.h"
+#include "dike.h"
+#include "parsing.h"
+#include "scaling.h"
+#include "tssolve.h"
+#include "tools.h"
+#include "fdstag.h"
+#include "bc.h"
+#include "JacRes.h"
+#include "interpolate.h"
+#include "surf.h"
+#include "paraViewOutBin.h"
+#include "paraViewOutSurf.h"
+#include "multigrid.h"
+#include "matrix.h"
+#include "lsolve.h"
+#include "nlsolve.h"
+#include "Tensor.h"
+#include "advect.h"
+#include "marker.h"
+#include "paraViewOutMark.h"
+#include "paraViewOutAVD.h"
+#include "objFunct.h"
+#include "adjoint.h"
+#include "paraViewOutPassiveTracers.h"
+#include "profile.h"
+#include "LaMEMLib.h"
+#include "LaMEM_C.h"
+
+//---------------------------------------------------------------------------
+struct _p_LaMEMHandle
+{
+	LaMEMLib     lm;    // library context
+	LaMEMSolver  sol;   // forward solver objects
+	PetscInt     init;  // initial guess flag
+	char        *opts;  // options database before model creation
+};
+//---------------------------------------------------------------------------
+static PetscInt      LaMEMOwnsPetsc = 0; // PETSc is initialized by LaMEMInitialize
+static PetscInt      LaMEMNumStages = 0; // profiling stages are registered
+static PetscLogStage LaMEMStages[4];     // profiling stages
+//---------------------------------------------------------------------------
+int LaMEMInitialize(int *argc, char ***argv)
+{
+	PetscBool flg;
+
+	PetscErrorCode ierr;
+
+	ierr = PetscInitialized(&flg); if(ierr) return ierr;
+
+	if(!flg)
+	{
+		ierr = PetscInitialize(argc, argv, (char *)0, NULL); if(ierr) return ierr;
+
+		LaMEMOwnsPetsc = 1;
+	}
+
+	PetscFunctionBeginUser;
+
+	if(!LaMEMNumStages)
+	{
+		ierr = PetscLogStageRegister("Initial guess",  &LaMEMStages[0]); CHKERRQ(ierr);
+		ierr = PetscLogStageRegister("SNES solve",     &LaMEMStages[1]); CHKERRQ(ierr);
+		ierr = PetscLogStageRegister("Advect markers", &LaMEMStages[2]); CHKERRQ(ierr);
+		ierr = PetscLogStageRegister("I/O",            &LaMEMStages[3]); CHKERRQ(ierr);
+
+		LaMEMNumStages = 4;
+	}
+
+	ierr = LaMEMLogEventRegister(); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+int LaMEMFinalize(void)
+{
+	PetscErrorCode ierr;
+
+	if(!LaMEMOwnsPetsc) return 0;
+
+	ierr = PetscFinalize(); if(ierr) return ierr;
+
+	LaMEMOwnsPetsc = 0;
+	LaMEMNumStages = 0;
+
+	return 0;
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode LaMEMCreateRollback(LaMEMHandle h, PetscBool lib)
+{
+	// release partially created model after an error in LaMEMCreate
+	// NOTE: errors are ignored, the original error is reported by the caller
+	// NOTE: objects of a failed LaMEMLibCreate cannot be released individually
+
+	// detach input buffer
+	FBSetInputBuffer(NULL);
+
+	// destroy library objects
+	if(lib) LaMEMLibDestroy(&h->lm);
+
+	// restore options database
+	if(h->opts)
+	{
+		PetscOptionsClear(NULL);
+		PetscOptionsInsertString(NULL, h->opts);
+		PetscFree(h->opts);
+	}
+
+	PetscFree(h);
+
+	return 0;
+}
+//---------------------------------------------------------------------------
+int LaMEMCreate(const char *params, const char *options, LaMEMHandle *handle)
+{
+	LaMEMHandle h;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!params)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Input parameters are not specified\n");
+	}
+
+	(*handle) = NULL;
+
+	ierr = PetscMalloc(sizeof(struct _p_LaMEMHandle), &h); CHKERRQ(ierr);
+	ierr = PetscMemzero(h, sizeof(struct _p_LaMEMHandle)); CHKERRQ(ierr);
+
+	// store options database (restored on destroy, models do not interfere)
+	ierr = PetscOptionsGetAll(NULL, &h->opts);
+	if(ierr) { LaMEMCreateRollback(h, PETSC_FALSE); CHKERRQ(ierr); }
+
+	if(options)
+	{
+		ierr = PetscOptionsInsertString(NULL, options);
+		if(ierr) { LaMEMCreateRollback(h, PETSC_FALSE); CHKERRQ(ierr); }
+	}
+
+	// setup cross-references between library objects
+	ierr = LaMEMLibSetLinks(&h->lm);
+	if(ierr) { LaMEMCreateRollback(h, PETSC_FALSE); CHKERRQ(ierr); }
+
+	// create library objects from input parameters in memory
+	ierr = FBSetInputBuffer(params);
+	if(!ierr) ierr = LaMEMLibCreate(&h->lm, NULL);
+	if(ierr) { LaMEMCreateRollback(h, PETSC_FALSE); CHKERRQ(ierr); }
+
+	ierr = FBSetInputBuffer(NULL);
+	if(ierr) { LaMEMCreateRollback(h, PETSC_TRUE); CHKERRQ(ierr); }
+
+	// create Stokes preconditioner, matrix and nonlinear solver
+	ierr = LaMEMLibSolverCreate(&h->lm, &h->sol);
+	if(ierr) { LaMEMCreateRollback(h, PETSC_TRUE); CHKERRQ(ierr); }
+
+	(*handle) = h;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+int LaMEMStep(LaMEMHandle h, int nstep, int *done)
+{
+	PetscInt n, restart;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// compute initial guess before the first step (fields & markers can be set before)
+	if(!h->init)
+	{
+		ierr = LaMEMLibInitGuess(&h->lm, h->sol.snes); CHKERRQ(ierr);
+
+		h->init = 1;
+	}
+
+	// exclude initial guess & work of the caller from performance log
+	ierr = PerfLogStart(&h->sol.plog); CHKERRQ(ierr);
+
+	n = 0;
+
+	while(n < nstep && !TSSolIsDone(&h->lm.ts))
+	{
+		ierr = LaMEMLibSolveTimeStep(&h->lm, &h->sol, NULL, NULL, LaMEMStages, &restart); CHKERRQ(ierr);
+
+		if(restart) continue;
+
+		// append performance log record
+		ierr = PerfLogStep(&h->sol.plog, &h->lm.actx, &h->lm.ts); CHKERRQ(ierr);
+
+		n++;
+	}
+
+	if(done) (*done) = (int)TSSolIsDone(&h->lm.ts);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+int LaMEMGetTime(LaMEMHandle h, double *time, int *step)
+{
+	PetscFunctionBeginUser;
+
+	if(time) (*time) = (double)(h->lm.ts.time*h->lm.scal.time);
+	if(step) (*step) = (int)h->lm.ts.istep;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+int LaMEMGetLocalSize(LaMEMHandle h, int size[3], int start[3])
+{
+	FDSTAG *fs;
+
+	PetscFunctionBeginUser;
+
+	fs = &h->lm.fs;
+
+	size[0]  = (int)fs->dsx.ncels;  size[1]  = (int)fs->dsy.ncels;  size[2]  = (int)fs->dsz.ncels;
+	start[0] = (int)fs->dsx.pstart; start[1] = (int)fs->dsy.pstart; start[2] = (int)fs->dsz.pstart;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+int LaMEMGetField(LaMEMHandle h, const char *name, double *data)
+{
+	FDSTAG      *fs;
+	JacRes      *jr;
+	Scaling     *scal;
+	SolVarCell  *svCell;
+	PetscInt    i, j, k, nx, ny, nz, sx, sy, sz, iter, ph, numPhases;
+	PetscScalar ***T, ***p, ***vx, ***vy, ***vz, val;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// access context
+	fs        = &h->lm.fs;
+	jr        = &h->lm.jr;
+	scal      = &h->lm.scal;
+	numPhases =  h->lm.dbm.numPhases;
+
+	if(strcmp(name, "temperature") && strcmp(name, "pressure")
+	&& strcmp(name, "density")     && strcmp(name, "viscosity")
+	&& strcmp(name, "phase")       && strcmp(name, "velocity_x")
+	&& strcmp(name, "velocity_y")  && strcmp(name, "velocity_z"))
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Unknown field name: %s\n", name);
+	}
+
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->lT,  &T);  CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->lp,  &p);  CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_X,   jr->lvx, &vx); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_Y,   jr->lvy, &vy); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_Z,   jr->lvz, &vz); CHKERRQ(ierr);
+
+	iter = 0;
+	GET_CELL_RANGE(nx, sx, fs->dsx)
+	GET_CELL_RANGE(ny, sy, fs->dsy)
+	GET_CELL_RANGE(nz, sz, fs->dsz)
+
+	START_STD_LOOP
+	{
+		svCell = &jr->svCell[iter];
+
+		if     (!strcmp(name, "temperature")) val = T[k][j][i]*scal->temperature - scal->Tshift;
+		else if(!strcmp(name, "pressure"))    val = p[k][j][i]*scal->stress;
+		else if(!strcmp(name, "density"))     val = svCell->svBulk.rho*scal->density;
+		else if(!strcmp(name, "viscosity"))   val = svCell->svDev.eta*scal->viscosity;
+		else if(!strcmp(name, "velocity_x"))  val = (vx[k][j][i] + vx[k][j][i+1])/2.0*scal->velocity;
+		else if(!strcmp(name, "velocity_y"))  val = (vy[k][j][i] + vy[k][j+1][i])/2.0*scal->velocity;
+		else if(!strcmp(name, "velocity_z"))  val = (vz[k][j][i] + vz[k+1][j][i])/2.0*scal->velocity;
+		else
+		{
+			// dominant phase
+			val = 0.0;
+
+			for(ph = 1; ph < numPhases; ph++)
+			{
+				if(svCell->phRat[ph] > svCell->phRat[(PetscInt)val]) val = (PetscScalar)ph;
+			}
+		}
+
+		data[iter++] = (double)val;
+	}
+	END_STD_LOOP
+
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->lT,  &T);  CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->lp,  &p);  CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_X,   jr->lvx, &vx); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_Y,   jr->lvy, &vy); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_Z,   jr->lvz, &vz); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+int LaMEMSetField(LaMEMHandle h, const char *name, const double *data)
+{
+	FDSTAG      *fs;
+	JacRes      *jr;
+	Scaling     *scal;
+	Vec         gT;
+	PetscInt    i, j, k, nx, ny, nz, sx, sy, sz, iter;
+	PetscScalar ***T;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// access context
+	fs   = &h->lm.fs;
+	jr   = &h->lm.jr;
+	scal = &h->lm.scal;
+
+	if(strcmp(name, "temperature"))
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Field cannot be set: %s\n", name);
+	}
+
+	// copy temperature to grid
+	ierr = DMGetGlobalVector(fs->DA_CEN, &gT);    CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_CEN, gT, &T);   CHKERRQ(ierr);
+
+	iter = 0;
+	GET_CELL_RANGE(nx, sx, fs->dsx)
+	GET_CELL_RANGE(ny, sy, fs->dsy)
+	GET_CELL_RANGE(nz, sz, fs->dsz)
+
+	START_STD_LOOP
+	{
+		T[k][j][i] = ((PetscScalar)data[iter++] + scal->Tshift)/scal->temperature;
+	}
+	END_STD_LOOP
+
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, gT, &T); CHKERRQ(ierr);
+
+	GLOBAL_TO_LOCAL(fs->DA_CEN, gT, jr->lT)
+
+	ierr = DMRestoreGlobalVector(fs->DA_CEN, &gT); CHKERRQ(ierr);
+
+	ierr = JacResApplyTempBC(jr); CHKERRQ(ierr);
+
+	// copy temperature to markers
+	ierr = ADVMarkSetTempVector(&h->lm.actx); CHKERRQ(ierr);
+
+	// project temperature from markers to grid
+	ierr = ADVProjHistMarkToGrid(&h->lm.actx); CHKERRQ(ierr);
+
+	// initialize temperature
+	ierr = JacResInitTemp(jr); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+int LaMEMGetNumMarkers(LaMEMHandle h, int *num)
+{
+	PetscFunctionBeginUser;
+
+	(*num) = (int)h->lm.actx.nummark;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+int LaMEMGetMarkers(LaMEMHandle h, double *x, double *y, double *z, int *phase, double *T)
+{
+	Scaling  *scal;
+	Marker   *P;
+	PetscInt  jj;
+
+	PetscFunctionBeginUser;
+
+	scal = &h->lm.scal;
+
+	for(jj = 0; jj < h->lm.actx.nummark; jj++)
+	{
+		P = &h->lm.actx.markers[jj];
+
+		if(x)     x[jj]     = (double)(P->X[0]*scal->length);
+		if(y)     y[jj]     = (double)(P->X[1]*scal->length);
+		if(z)     z[jj]     = (double)(P->X[2]*scal->length);
+		if(phase) phase[jj] = (int)P->phase;
+		if(T)     T[jj]     = (double)(P->T*scal->temperature - scal->Tshift);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+int LaMEMSetMarkers(LaMEMHandle h, const int *phase, const double *T)
+{
+	Scaling  *scal;
+	Marker   *P;
+	PetscInt  jj, numPhases, ninv_loc, ninv;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	scal      = &h->lm.scal;
+	numPhases = h->lm.dbm.numPhases;
+
+	// check phase IDs before modifying markers (error is raised on all ranks)
+	ninv_loc = 0;
+
+	if(phase)
+	{
+		for(jj = 0; jj < h->lm.actx.nummark; jj++)
+		{
+			if(phase[jj] < 0 || (PetscInt)phase[jj] >= numPhases) ninv_loc++;
+		}
+	}
+
+	ierr = MPI_Allreduce(&ninv_loc, &ninv, 1, MPIU_INT, MPI_SUM, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	if(ninv)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "%lld markers have invalid phase ID (valid range: 0 - %lld)\n", (LLD)ninv, (LLD)(numPhases-1));
+	}
+
+	for(jj = 0; jj < h->lm.actx.nummark; jj++)
+	{
+		P = &h->lm.actx.markers[jj];
+
+		if(phase) P->phase = (PetscInt)phase[jj];
+		if(T)     P->T     = ((PetscScalar)T[jj] + scal->Tshift)/scal->temperature;
+	}
+
+	// project history fields from markers to grid
+	ierr = ADVProjHistMarkToGrid(&h->lm.actx); CHKERRQ(ierr);
+
+	// initialize temperature
+	ierr = JacResInitTemp(&h->lm.jr); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+int LaMEMDestroy(LaMEMHandle *handle)
+{
+	LaMEMHandle h;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	h = (*handle);
+
+	if(!h) PetscFunctionReturn(0);
+
+	ierr = LaMEMLibSolverDestroy(&h->sol); CHKERRQ(ierr);
+	ierr = LaMEMLibDestroy(&h->lm);        CHKERRQ(ierr);
+
+	// restore options database
+	ierr = PetscOptionsClear(NULL);                  CHKERRQ(ierr);
+	ierr = PetscOptionsInsertString(NULL, h->opts);  CHKERRQ(ierr);
+	ierr = PetscFree(h->opts);                       CHKERRQ(ierr);
+
+	ierr = PetscFree(h); CHKERRQ(ierr);
+
+	(*handle) = NULL;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
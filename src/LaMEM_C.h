@@ -0,0 +1,89 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+//........................ LaMEM C-callable library API ......................
+//---------------------------------------------------------------------------
+//
+// Runs LaMEM models in memory, without input files or output to disk:
+//
+//   LaMEMInitialize(&argc, &argv);
+//   LaMEMCreate(params, "-nstep_max 10", &h);  // params: input file contents
+//   LaMEMSetMarkers(h, phase, T);              // optional
+//   LaMEMStep(h, 5, &done);
+//   LaMEMGetField(h, "velocity_z", buff);
+//   LaMEMDestroy(&h);
+//   LaMEMFinalize();
+//
+// All functions are collective on PETSC_COMM_WORLD and return zero on success.
+// Field arrays cover the local block of cells (see LaMEMGetLocalSize),
+// x-index is running fastest. Marker arrays cover local markers.
+// All values are in the units of the input parameters (dimensional).
+//
+// LaMEMCreate takes a snapshot of the PETSc options database, which is
+// restored by LaMEMDestroy. Options of a model therefore stay active until
+// it is destroyed, and several concurrently alive handles are not supported
+// (create and destroy one model at a time).
+//---------------------------------------------------------------------------
+#ifndef __LaMEM_C_h__
+#define __LaMEM_C_h__
+//---------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _p_LaMEMHandle *LaMEMHandle;
+
+// initialize PETSc (if not done yet) and register profiling stages
+int LaMEMInitialize(int *argc, char ***argv);
+
+// finalize PETSc (if initialized by LaMEMInitialize)
+int LaMEMFinalize(void);
+
+// create model from input parameters in memory (same syntax as input file)
+// options are additional PETSc/LaMEM command-line options (can be NULL)
+int LaMEMCreate(const char *params, const char *options, LaMEMHandle *handle);
+
+// perform up to nstep time steps, done is set once the simulation is finished
+int LaMEMStep(LaMEMHandle handle, int nstep, int *done);
+
+// get current time and step number
+int LaMEMGetTime(LaMEMHandle handle, double *time, int *step);
+
+// get size and starting global indices of the local block of cells
+int LaMEMGetLocalSize(LaMEMHandle handle, int size[3], int start[3]);
+
+// read cell field (temperature, pressure, density, viscosity, phase, velocity_x, velocity_y, velocity_z)
+int LaMEMGetField(LaMEMHandle handle, const char *name, double *data);
+
+// set cell field (temperature)
+// values are passed to markers and projected back to the grid, reading the
+// field afterwards returns marker-averaged (smoothed) values
+int LaMEMSetField(LaMEMHandle handle, const char *name, const double *data);
+
+// get number of local markers
+int LaMEMGetNumMarkers(LaMEMHandle handle, int *num);
+
+// read local markers (any array can be NULL)
+int LaMEMGetMarkers(LaMEMHandle handle, double *x, double *y, double *z, int *phase, double *T);
+
+// set phase and temperature of local markers (any array can be NULL)
+// phase IDs must be in the range 0 <= phase < number of phases
+int LaMEMSetMarkers(LaMEMHandle handle, const int *phase, const double *T);
+
+// destroy model
+int LaMEMDestroy(LaMEMHandle *handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+//---------------------------------------------------------------------------
+#endif
@@ -8,7 +8,82 @@ module LaMEM_C
 #   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
 #
 # ==============================================================================
+#
+# Thin wrappers around the C-callable LaMEM library API (see LaMEM_C.h).
+# Build the shared library with "make mode=opt dylib" and set LAMEM_LIB if it
+# is not located in the default directory.
+#
+#   LaMEM_C.initialize()
+#   h = LaMEM_C.create(read("model.dat", String), "-nstep_max 10")
+#   LaMEM_C.step(h, 5)
+#   Vz = LaMEM_C.get_field(h, "velocity_z")
+#   LaMEM_C.destroy(h)
+#   LaMEM_C.finalize()
+#
+# ==============================================================================
+
+const libLaMEM = get(ENV, "LAMEM_LIB", joinpath(@__DIR__, "..", "lib", "opt", "LaMEMLib.dylib"))
+
+check(ierr) = ierr == 0 || error("LaMEM C API returned error code $ierr")
+
+initialize() = check(ccall((:LaMEMInitialize, libLaMEM), Cint, (Ptr{Cint}, Ptr{Ptr{Ptr{Cchar}}}), C_NULL, C_NULL))
+
+finalize()   = check(ccall((:LaMEMFinalize, libLaMEM), Cint, ()))
+
+function create(params::String, options::String="")
+    h = Ref{Ptr{Cvoid}}(C_NULL)
+    check(ccall((:LaMEMCreate, libLaMEM), Cint, (Cstring, Cstring, Ref{Ptr{Cvoid}}), params, options, h))
+    return h[]
+end
+
+function step(h::Ptr{Cvoid}, nstep::Integer=1)
+    done = Ref{Cint}(0)
+    check(ccall((:LaMEMStep, libLaMEM), Cint, (Ptr{Cvoid}, Cint, Ref{Cint}), h, nstep, done))
+    return done[] != 0
+end
+
+function get_time(h::Ptr{Cvoid})
+    time = Ref{Cdouble}(0.0)
+    istep = Ref{Cint}(0)
+    check(ccall((:LaMEMGetTime, libLaMEM), Cint, (Ptr{Cvoid}, Ref{Cdouble}, Ref{Cint}), h, time, istep))
+    return time[], istep[]
+end
+
+function local_size(h::Ptr{Cvoid})
+    size  = zeros(Cint, 3)
+    start = zeros(Cint, 3)
+    check(ccall((:LaMEMGetLocalSize, libLaMEM), Cint, (Ptr{Cvoid}, Ptr{Cint}, Ptr{Cint}), h, size, start))
+    return Tuple(size), Tuple(start)
+end
+
+function get_field(h::Ptr{Cvoid}, name::String)
+    size, _ = local_size(h)
+    data    = zeros(Cdouble, size)
+    check(ccall((:LaMEMGetField, libLaMEM), Cint, (Ptr{Cvoid}, Cstring, Ptr{Cdouble}), h, name, data))
+    return data
+end
+
+# values are passed to markers and projected back (get_field returns smoothed values)
+function set_field!(h::Ptr{Cvoid}, name::String, data::Array{Float64,3})
+    check(ccall((:LaMEMSetField, libLaMEM), Cint, (Ptr{Cvoid}, Cstring, Ptr{Cdouble}), h, name, data))
+end
+
+function get_markers(h::Ptr{Cvoid})
+    n = Ref{Cint}(0)
+    check(ccall((:LaMEMGetNumMarkers, libLaMEM), Cint, (Ptr{Cvoid}, Ref{Cint}), h, n))
+    x, y, z, T = zeros(n[]), zeros(n[]), zeros(n[]), zeros(n[])
+    phase      = zeros(Cint, n[])
+    check(ccall((:LaMEMGetMarkers, libLaMEM), Cint, (Ptr{Cvoid}, Ptr{Cdouble}, Ptr{Cdouble}, Ptr{Cdouble}, Ptr{Cint}, Ptr{Cdouble}), h, x, y, z, phase, T))
+    return (x=x, y=y, z=z, phase=phase, T=T)
+end
 
+function set_markers!(h::Ptr{Cvoid}, phase::Vector{Cint}, T::Vector{Float64})
+    check(ccall((:LaMEMSetMarkers, libLaMEM), Cint, (Ptr{Cvoid}, Ptr{Cint}, Ptr{Cdouble}), h, phase, T))
+end
 
+function destroy(h::Ptr{Cvoid})
+    r = Ref{Ptr{Cvoid}}(h)
+    check(ccall((:LaMEMDestroy, libLaMEM), Cint, (Ref{Ptr{Cvoid}},), r))
+end
 
 end # module LaMEM_C
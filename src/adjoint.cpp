@@ -472,6 +472,7 @@ PetscErrorCode LaMEMAdjointReadInputSetDefaults(ModParam *IOparam, Adjoint_Vecs
 	ierr = getScalarParam(fb, _OPTIONAL_, "Inversion_facB"      			, &IOparam->facB,      1, 1        ); CHKERRQ(ierr);  // backtrack factor that multiplies current line search parameter if GD update was not successful
 	ierr = getScalarParam(fb, _OPTIONAL_, "Inversion_maxfac"    			, &IOparam->maxfac,    1, 1        ); CHKERRQ(ierr);  // limit on the factor (only used without tao)
 	ierr = getScalarParam(fb, _OPTIONAL_, "Inversion_Scale_Grad"			, &IOparam->Scale_Grad,1, 1        ); CHKERRQ(ierr);  // Magnitude of initial parameter update (factor_ini = Scale_Grad/Grad)
+	ierr = getIntParam   (fb, _OPTIONAL_, "Inversion_ReuseModel"			, &IOparam->reuse,     1, 1        ); CHKERRQ(ierr);  // Keep forward model in memory between runs?
 
 	PetscPrintf(PETSC_COMM_WORLD,"| ------------------------------------------------------------------------- \n");
 	PetscPrintf(PETSC_COMM_WORLD,"|                                      LaMEM                                \n");
@@ -518,6 +519,7 @@ PetscErrorCode LaMEMAdjointReadInputSetDefaults(ModParam *IOparam, Adjoint_Vecs
 		PetscPrintf(PETSC_COMM_WORLD, "|    Maximum linesearch iterations            : %lld    \n", (LLD) IOparam->maxitLS);
 		PetscPrintf(PETSC_COMM_WORLD, "|    Apply bounds                             : %lld    \n", (LLD) IOparam->Ab);
 		PetscPrintf(PETSC_COMM_WORLD, "|    Tolerance (F/Fini)                       : %.5e  \n", IOparam->tol);
+		PetscPrintf(PETSC_COMM_WORLD, "|    Reuse forward model in memory            : %lld    \n", (LLD) IOparam->reuse);
 		if (IOparam->Tao == 0)
 		{
 			PetscPrintf(PETSC_COMM_WORLD, "|    Not employing TAO, but instead our build-in gradient algorithm, with the following parameters: \n");
@@ -1156,6 +1158,9 @@ PetscErrorCode AdjointCreate(AdjGrad *aop, JacRes *jr, ModParam *IOparam)
 	ierr = VecDuplicate(jr->gsol, &aop->pro);             CHKERRQ(ierr);
 	ierr = VecDuplicate(jr->gsol, &IOparam->xini);  	  CHKERRQ(ierr);  // create a new one
 
+	// adjoint solver is created on first use
+	aop->ksp = NULL;
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -1175,6 +1180,7 @@ PetscErrorCode AdjointDestroy(AdjGrad *aop, ModParam *IOparam)
 	ierr = VecDestroy(&aop->dF);         CHKERRQ(ierr);
 	ierr = VecDestroy(&aop->pro);        CHKERRQ(ierr);
 	ierr = VecDestroy(&IOparam->xini); 	 CHKERRQ(ierr); 
+	ierr = KSPDestroy(&aop->ksp);        CHKERRQ(ierr);
 
 	// Destroy the Adjoint gradients structures
 	// ierr = PetscMemzero(aop, sizeof(AdjGrad)); CHKERRQ(ierr);
@@ -1795,7 +1801,7 @@ PetscErrorCode AdjointOptimisationTAO(Tao tao, Vec P, PetscReal *F, Vec grad, vo
 PetscErrorCode AdjointFiniteDifferenceGradients(ModParam *IOparam)
 {
 	PetscErrorCode 	ierr;
-	PetscInt 		j;
+	PetscInt 		j, FD_gradients_groups = 1;
 	PetscScalar 	*Par, Perturb, Misfit_ref, Misfit_pert, FD_gradients_eps=1e-6, FD_eps, Grad; 
 	char 			CurName[_str_len_];
 	PetscBool 		flg, FD_Adjoint = PETSC_FALSE;
@@ -1809,6 +1815,8 @@ PetscErrorCode AdjointFiniteDifferenceGradients(ModParam *IOparam)
 		PetscPrintf(PETSC_COMM_WORLD,"| Updated eps used for computing finite difference gradients to: %2.5e  \n",FD_gradients_eps);
     }
 
+	ierr = PetscOptionsGetInt(NULL, NULL,"-FD_gradients_groups",&FD_gradients_groups,NULL); CHKERRQ(ierr);
+
 	// 1) Compute 'reference' state using LaMEM & the current set of parameters
 	// Set parameters as command-line options
 	VecGetArray(IOparam->P,&Par);
@@ -1824,7 +1832,12 @@ PetscErrorCode AdjointFiniteDifferenceGradients(ModParam *IOparam)
 		}
 	}
 
-	if (FD_Adjoint){
+	if (FD_Adjoint && FD_gradients_groups > 1){
+
+		// run reference & perturbed models concurrently on groups of ranks
+		ierr = AdjointFiniteDifferenceGradientsGroups(IOparam, FD_gradients_eps, FD_gradients_groups); CHKERRQ(ierr);
+	}
+	else if (FD_Adjoint){
 
 		// Call LaMEM
 		ierr 		= 	LaMEMLibMain(IOparam,IOparam->stages); CHKERRQ(ierr);		// call LaMEM
@@ -1885,6 +1898,156 @@ PetscErrorCode AdjointFiniteDifferenceGradients(ModParam *IOparam)
  	PetscFunctionReturn(0);
  }
 
+//---------------------------------------------------------------------------
+PetscErrorCode AdjointFiniteDifferenceGradientsGroups(ModParam *IOparam, PetscScalar FD_gradients_eps, PetscInt ngroups)
+{
+	/*
+		Splits the world communicator into groups of ranks and runs the reference and
+		the perturbed forward models concurrently, one model per group at a time
+		(see RankGroupSwitch). Parameters are passed through the options database,
+		which is private to every process.
+	*/
+
+	PetscErrorCode 	ierr;
+	MPI_Comm 		world, gcomm;
+	PetscMPIInt 	grank;
+	PetscInt 		j, k, color, ntask, reuse, fail_loc, fail, *tpar;
+	PetscScalar 	*Par, *Perturb, *mfit_loc, *mfit, FD_eps, Grad;
+	char 			outname[_str_len_], grpname[_str_len_];
+	PetscBool 		flg;
+
+ 	PetscFunctionBeginUser;
+
+	world = PETSC_COMM_WORLD;
+
+	ierr = RankGroupSplit(world, &ngroups, &color, &gcomm, &grank); CHKERRQ(ierr);
+
+	// list of runs: reference (-1) followed by all perturbed parameters
+	ierr = PetscMalloc((size_t)(IOparam->mdN+1)*sizeof(PetscInt),    &tpar);     CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)(IOparam->mdN+1)*sizeof(PetscScalar), &Perturb);  CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)(IOparam->mdN+1)*sizeof(PetscScalar), &mfit_loc); CHKERRQ(ierr);
+	ierr = PetscMalloc((size_t)(IOparam->mdN+1)*sizeof(PetscScalar), &mfit);     CHKERRQ(ierr);
+
+	ierr = VecGetArray(IOparam->P, &Par); CHKERRQ(ierr);
+
+	ntask            = 0;
+	tpar   [ntask]   = -1;
+	Perturb[ntask++] = 0.0;
+
+	for(j = 0; j < IOparam->mdN; j++)
+	{
+		if (IOparam->FD_gradient[j]>0)
+		{
+			FD_eps = IOparam->FD_eps[j];
+			if (FD_eps==0.0) FD_eps = FD_gradients_eps;	// use default value
+
+			tpar   [ntask]   = j;
+			Perturb[ntask++] = Par[j]*FD_eps;
+		}
+	}
+
+	PetscPrintf(world,"| Running %lld finite difference models on %lld groups of ranks \n", (LLD)ntask, (LLD)ngroups);
+
+	// separate output files of concurrent runs
+	ierr = PetscOptionsGetString(NULL, NULL, "-out_file_name", outname, _str_len_, &flg); CHKERRQ(ierr);
+	if (!flg) strcpy(outname, "output");
+
+	sprintf(grpname, "%s_FD_group_%lld", outname, (LLD)color);
+
+	ierr = PetscOptionsSetValue(NULL, "-out_file_name", grpname); CHKERRQ(ierr);
+
+	ierr = PetscMemzero(mfit_loc, (size_t)ntask*sizeof(PetscScalar)); CHKERRQ(ierr);
+
+	// model kept in memory lives on the world communicator
+	reuse          = IOparam->reuse;
+	IOparam->reuse = 0;
+
+	// errors are not returned immediately, the world communicator must be
+	// restored and all groups must reach the collective calls below
+	ierr = 0;
+
+	for(k = color; k < ntask && !ierr; k += ngroups)
+	{
+		// set (perturbed) parameters as command-line options
+		for(j = 0; j < IOparam->mdN && !ierr; j++)
+		{
+			ierr = CopyParameterToLaMEMCommandLine(IOparam, Par[j] + (j == tpar[k] ? Perturb[k] : 0.0), j);
+		}
+
+		if(ierr) break;
+
+		// run model on group communicator
+		RankGroupSwitch(gcomm);
+
+		ierr = LaMEMLibMain(IOparam, IOparam->stages);
+
+		RankGroupSwitch(world);
+
+		if (!ierr && !grank) mfit_loc[k] = IOparam->mfit;
+	}
+
+	fail_loc = (ierr != 0);
+
+	IOparam->reuse = reuse;
+
+	// set back parameters & output file name
+	for(j = 0; j < IOparam->mdN; j++)
+	{
+		ierr = CopyParameterToLaMEMCommandLine(IOparam, Par[j], j); CHKERRQ(ierr);
+	}
+
+	if (flg) { ierr = PetscOptionsSetValue  (NULL, "-out_file_name", outname); CHKERRQ(ierr); }
+	else     { ierr = PetscOptionsClearValue(NULL, "-out_file_name");          CHKERRQ(ierr); }
+
+	// check whether all groups succeeded
+	ierr = MPI_Allreduce(&fail_loc, &fail, 1, MPIU_INT, MPI_MAX, world); CHKERRQ(ierr);
+
+	if(fail)
+	{
+		ierr = VecRestoreArray(IOparam->P, &Par); CHKERRQ(ierr);
+
+		PetscFree(tpar);
+		PetscFree(Perturb);
+		PetscFree(mfit_loc);
+		PetscFree(mfit);
+
+		ierr = MPI_Comm_free(&gcomm); CHKERRQ(ierr);
+
+		SETERRQ(world, PETSC_ERR_LIB, "Finite difference model run failed in at least one group of ranks\n");
+	}
+
+	// gather misfits
+	ierr = MPI_Allreduce(mfit_loc, mfit, (PetscMPIInt)ntask, MPIU_SCALAR, MPIU_SUM, world); CHKERRQ(ierr);
+
+	PetscPrintf(world,"| ************************************************************************ \n");
+	PetscPrintf(world,"|                       FINITE DIFFERENCE GRADIENTS                        \n");
+	PetscPrintf(world,"| ************************************************************************ \n");
+	PetscPrintf(world,"| Reference objective function: %- 2.6e \n", mfit[0]);
+
+	for(k = 1; k < ntask; k++)
+	{
+		j    = tpar[k];
+		Grad = (mfit[k]-mfit[0])/Perturb[k];
+
+		IOparam->grd[j] = Grad;		// store gradient
+
+		PetscPrintf(world,"|  Perturbed Misfit value     : %- 2.6e \n", mfit[k]);
+		PetscPrintf(world,"|  Brute force FD gradient %5s[%2lld] = %e, with eps=%1.4e \n", IOparam->type_name[j], (LLD) IOparam->phs[j], Grad, Perturb[k]/Par[j]);
+	}
+
+	ierr = VecRestoreArray(IOparam->P, &Par); CHKERRQ(ierr);
+
+	IOparam->mfit = mfit[0];
+
+	PetscFree(tpar);
+	PetscFree(Perturb);
+	PetscFree(mfit_loc);
+	PetscFree(mfit);
+
+	ierr = MPI_Comm_free(&gcomm); CHKERRQ(ierr);
+
+ 	PetscFunctionReturn(0);
+}
 //---------------------------------------------------------------------------
 PetscErrorCode AdjointComputeGradients(JacRes *jr, AdjGrad *aop, NLSol *nl, SNES snes, ModParam *IOparam)
 {
@@ -1892,14 +2055,12 @@ PetscErrorCode AdjointComputeGradients(JacRes *jr, AdjGrad *aop, NLSol *nl, SNES
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	KSP                 ksp_as;
 	KSPConvergedReason  reason;
-	PetscInt            i, j;
+	PetscInt            i, j, nrho, neta, irho[_MAX_PAR_], ieta[_MAX_PAR_], ianl[_MAX_PAR_];
 	PetscScalar         grd, Perturb, *Par, CurVal;
-	Vec 				res_pert, sol, psi, psiPar, drdp, res;
-	PC                  ipc_as;
+	Vec 				res_pert, sol, psi, psiPar, drdp, res, *drdp_anl;
 	Scaling             *scal;
-    PetscBool           flg;
+    PetscBool           flg, fd_drdp, fd_rho;
     char                CurName[_str_len_];
 	BCCtx 				*bc;
 	
@@ -1923,31 +2084,29 @@ PetscErrorCode AdjointComputeGradients(JacRes *jr, AdjGrad *aop, NLSol *nl, SNES
 	//========
 	// Solve the adjoint equation (psi = J^-T * dF/dx)
 	// (A side note that I figured out, ksp still sometimes results in a > 0 gradient even if cost function is zero.. possibly really bad condition number?)
+	// the adjoint solve applies J instead of J^T, which is only valid for Picard
+	if(nl->jtype != _PICARD_ && !IOparam->warnJac)
+	{
+		PetscPrintf(PETSC_COMM_WORLD,"| WARNING: Adjoint system is solved with the non-symmetric Newton (MFFD) Jacobian instead of its transpose; gradients are inaccurate. Avoid the switch to Newton (decrease -snes_PicardSwitchToNewton_rtol) \n");
+
+		IOparam->warnJac = 1;
+	}
+
+	ierr = AdjointSolverSetup(aop, nl, snes); CHKERRQ(ierr);
+
 	if(IOparam->MfitType == 0)
 	{
 
 		ierr = Adjoint_ApplyBCs(aop->dF, bc);			CHKERRQ(ierr);		// apply BC's to dF vector
 
-		ierr = SNESGetKSP(snes, &ksp_as);         		CHKERRQ(ierr);
-		ierr = KSPSetOptionsPrefix(ksp_as,"as_"); 		CHKERRQ(ierr);
-		ierr = KSPSetFromOptions(ksp_as);         		CHKERRQ(ierr);
-		ierr = KSPGetPC(ksp_as, &ipc_as);           	CHKERRQ(ierr);
-		ierr = PCSetType(ipc_as, PCMAT);          		CHKERRQ(ierr);
-		ierr = KSPSetOperators(ksp_as,nl->J,nl->P);		CHKERRQ(ierr);
-		ierr = KSPSolve(ksp_as,aop->dF,psi);			CHKERRQ(ierr);
-		ierr = KSPGetConvergedReason(ksp_as,&reason);	CHKERRQ(ierr);
+		ierr = KSPSolve(aop->ksp,aop->dF,psi);			CHKERRQ(ierr);
+		ierr = KSPGetConvergedReason(aop->ksp,&reason);	CHKERRQ(ierr);
 	}
 	else if(IOparam->MfitType == 1)
  	{
 		ierr = Adjoint_ApplyBCs(aop->dPardu, bc);		CHKERRQ(ierr);		// apply BC's to dF vector 
- 		ierr = SNESGetKSP(snes, &ksp_as);         		CHKERRQ(ierr);
- 		ierr = KSPSetOptionsPrefix(ksp_as,"as_"); 		CHKERRQ(ierr);
- 		ierr = KSPSetFromOptions(ksp_as);         		CHKERRQ(ierr);
- 		ierr = KSPGetPC(ksp_as, &ipc_as);            	CHKERRQ(ierr);
- 		ierr = PCSetType(ipc_as, PCMAT);          		CHKERRQ(ierr);
- 		ierr = KSPSetOperators(ksp_as,nl->J,nl->P);		CHKERRQ(ierr);
- 		ierr = KSPSolve(ksp_as,aop->dPardu,psiPar);		CHKERRQ(ierr);
- 		ierr = KSPGetConvergedReason(ksp_as,&reason);	CHKERRQ(ierr);
+ 		ierr = KSPSolve(aop->ksp,aop->dPardu,psiPar);	CHKERRQ(ierr);
+ 		ierr = KSPGetConvergedReason(aop->ksp,&reason);	CHKERRQ(ierr);
  	}
 
 	// Check error
@@ -2020,9 +2179,72 @@ PetscErrorCode AdjointComputeGradients(JacRes *jr, AdjGrad *aop, NLSol *nl, SNES
 		// PARAMETER LOOP
 		//=================
 		VecGetArray(IOparam->P,&Par);
+
+		// Density & creep derivatives are computed analytically for all phases at once,
+		// unless FD is requested explicitly. Density falls back to FD if the lithostatic
+		// or pore pressure depend on density
+		fd_drdp = PETSC_FALSE;
+		ierr = PetscOptionsGetBool(NULL, NULL, "-FD_adjoint_drdp", &fd_drdp, NULL); CHKERRQ(ierr);
+
+		fd_rho = fd_drdp;
+
+		if(jr->ctrl.pLithoVisc || jr->ctrl.pLithoPlast || jr->ctrl.gwType != _GW_NONE_) fd_rho = PETSC_TRUE;
+
+		nrho     = 0;
+		neta     = 0;
+		drdp_anl = NULL;
+
 		for(j = 0; j < IOparam->mdN; j++)
 		{
-			if (!IOparam->FD_gradient[j]){	// only if we want to compute an adjoint gradient for this parameter
+			ianl[j] = -1;
+
+			if(IOparam->FD_gradient[j]) continue;
+
+			if(!fd_rho && !strcmp(IOparam->type_name[j], "rho"))
+			{
+				ianl[j]      = nrho;
+				irho[nrho++] = j;
+			}
+		}
+
+		for(j = 0; j < IOparam->mdN; j++)
+		{
+			if(fd_drdp || IOparam->FD_gradient[j]) continue;
+
+			if(!strcmp(IOparam->type_name[j], "eta")
+			|| !strcmp(IOparam->type_name[j], "Bd")
+			|| !strcmp(IOparam->type_name[j], "eta0")
+			|| !strcmp(IOparam->type_name[j], "e0")
+			|| !strcmp(IOparam->type_name[j], "Bn")
+			|| !strcmp(IOparam->type_name[j], "n"))
+			{
+				ianl[j]      = nrho + neta;
+				ieta[neta++] = j;
+			}
+		}
+
+		if(nrho + neta)
+		{
+			ierr = VecDuplicateVecs(jr->gres, nrho + neta, &drdp_anl); CHKERRQ(ierr);
+		}
+
+		if(nrho)
+		{
+			ierr = AdjointFormResidualDensityDerivatives(jr, sol, IOparam, Par, nrho, irho, drdp_anl); CHKERRQ(ierr);
+		}
+
+		if(neta)
+		{
+			ierr = AdjointFormResidualViscosityDerivatives(jr, sol, IOparam, Par, neta, ieta, drdp_anl + nrho); CHKERRQ(ierr);
+		}
+
+		for(j = 0; j < IOparam->mdN; j++)
+		{
+			if (ianl[j] != -1){	// analytic dr/dp is available for this parameter
+
+				ierr 			=	VecCopy(drdp_anl[ianl[j]],drdp);									CHKERRQ(ierr);
+			}
+			else if (!IOparam->FD_gradient[j]){	// only if we want to compute an adjoint gradient for this parameter
 
 				// Get the initial residual since it is overwritten in VecAYPX
 				ierr = VecCopy(jr->gres,res); 			CHKERRQ(ierr);
@@ -2064,6 +2286,9 @@ PetscErrorCode AdjointComputeGradients(JacRes *jr, AdjGrad *aop, NLSol *nl, SNES
 					ierr =   PetscMemzero(&nl->pc->pm->jr->dbm->phases[i],  sizeof(Material_t));   CHKERRQ(ierr);
 					swapStruct(&nl->pc->pm->jr->dbm->phases[i], &IOparam->dbm_modified.phases[i]);  
 				}
+			}
+
+			if (!IOparam->FD_gradient[j]){
 				
 				// Compute the gradient (dF/dp = -psi^T * dr/dp) & Save gradient
 				if (IOparam->MfitType == 0)
@@ -2100,6 +2325,11 @@ PetscErrorCode AdjointComputeGradients(JacRes *jr, AdjGrad *aop, NLSol *nl, SNES
 			}
 		}
 		VecRestoreArray(IOparam->P,&Par);
+
+		if(nrho + neta)
+		{
+			ierr = VecDestroyVecs(nrho + neta, &drdp_anl); CHKERRQ(ierr);
+		}
 	}
 
  	// Print overview of gradients (if requested @ this stage)
@@ -2116,6 +2346,52 @@ PetscErrorCode AdjointComputeGradients(JacRes *jr, AdjGrad *aop, NLSol *nl, SNES
 	PetscFunctionReturn(0);
 }
 
+//---------------------------------------------------------------------------
+/*
+	Sets up the adjoint linear solver on first use.
+	The solver is bound to the Jacobian and preconditioner shell matrices of
+	the forward solver, which FormJacobian updates in place. The adjoint solve
+	therefore applies the Stokes preconditioner (PMat & multigrid hierarchy)
+	that was built for the converged forward state, without another setup.
+	The forward solver itself is left untouched (it used to be re-prefixed
+	with "as_" on every call). Solver type and tolerances are inherited from
+	the forward solver, and can be overridden with "as_" options.
+	NOTE: the shell operators provide no transpose product, therefore the
+	adjoint system is solved with the forward operator, as before. This is
+	only the transpose for the (symmetric) Picard operator. If the forward
+	solve ended with the matrix-free Newton Jacobian, AdjointComputeGradients
+	issues a warning (once per run).
+*/
+PetscErrorCode AdjointSolverSetup(AdjGrad *aop, NLSol *nl, SNES snes)
+{
+	KSP         ksp_js;
+	KSPType     type;
+	PC          ipc_as;
+	PetscInt    maxits;
+	PetscReal   rtol, atol, dtol;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(aop->ksp) PetscFunctionReturn(0);
+
+	// get forward solver settings
+	ierr = SNESGetKSP(snes, &ksp_js);                              CHKERRQ(ierr);
+	ierr = KSPGetType(ksp_js, &type);                              CHKERRQ(ierr);
+	ierr = KSPGetTolerances(ksp_js, &rtol, &atol, &dtol, &maxits); CHKERRQ(ierr);
+
+	// create adjoint solver
+	ierr = KSPCreate(PETSC_COMM_WORLD, &aop->ksp);                 CHKERRQ(ierr);
+	ierr = KSPSetOptionsPrefix(aop->ksp, "as_");                   CHKERRQ(ierr);
+	ierr = KSPSetOperators(aop->ksp, nl->J, nl->P);                CHKERRQ(ierr);
+	ierr = KSPSetType(aop->ksp, type);                             CHKERRQ(ierr);
+	ierr = KSPSetTolerances(aop->ksp, rtol, atol, dtol, maxits);   CHKERRQ(ierr);
+	ierr = KSPGetPC(aop->ksp, &ipc_as);                            CHKERRQ(ierr);
+	ierr = PCSetType(ipc_as, PCMAT);                               CHKERRQ(ierr);
+	ierr = KSPSetFromOptions(aop->ksp);                            CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
 //---------------------------------------------------------------------------
 /*
     This prints the current value of the objective function
@@ -2804,6 +3080,622 @@ PetscErrorCode AdjointPointInPro(JacRes *jr, AdjGrad *aop, ModParam *IOparam, Fr
 	
 	PetscFunctionReturn(0);
 }
+
+/*---------------------------------------------------------------------------
+	Computes dr/dp analytically for all density parameters in a single sweep.
+	The effective density is linear in the reference phase densities, and
+	enters the residual only through the gravity and FSSA terms of the
+	momentum equations. Derivatives of the effective density with respect
+	to all phase densities are therefore evaluated once per cell, and then
+	distributed to the faces for each parameter separately.
+	NOTE: not applicable if lithostatic or pore pressure is used, since these
+	depend on density themselves (the caller falls back to finite differences)
+*/
+PetscErrorCode AdjointFormResidualDensityDerivatives(JacRes *jr, Vec x, ModParam *IOparam, PetscScalar *Par, PetscInt npar, PetscInt *ipar, Vec *drdp)
+{
+	ConstEqCtx  ctx;
+	FDSTAG     *fs;
+	SolVarCell *svCell;
+	PetscInt    ii, jj, iter, ncells, nrho, slot[_max_num_phases_], fssa_allVel;
+	PetscInt    i, j, k, nx, ny, nz, sx, sy, sz;
+	PetscScalar drho[_max_num_phases_], *dRho, cf;
+	PetscScalar bdx, fdx, bdy, fdy, bdz, fdz, gx, gy, gz, tx, ty, tz;
+	PetscScalar z, Tc, pc, dt, fssa, *grav, rho_dim;
+	PetscScalar ***fx, ***fy, ***fz, ***vx, ***vy, ***vz, ***p, ***T;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// access context
+	fs = jr->fs;
+
+	fssa        = jr->ctrl.FSSA;
+	fssa_allVel = jr->ctrl.FSSA_allVel;
+	grav        = jr->ctrl.grav;
+	dt          = jr->ts->dt;
+
+	// assign storage slots to the phases that have a density parameter
+	for(ii = 0; ii < _max_num_phases_; ii++) slot[ii] = -1;
+
+	nrho = 0;
+
+	for(ii = 0; ii < npar; ii++)
+	{
+		if(slot[IOparam->phs[ipar[ii]]] == -1) slot[IOparam->phs[ipar[ii]]] = nrho++;
+	}
+
+	// copy solution from global to local vectors
+	ierr = JacResCopySol(jr, x); CHKERRQ(ierr);
+
+	// setup constitutive equation evaluation context parameters
+	ierr = setUpConstEq(&ctx, jr); CHKERRQ(ierr);
+
+	// allocate storage for density derivatives
+	ncells = fs->nCells;
+
+	ierr = PetscMalloc((size_t)(ncells*nrho)*sizeof(PetscScalar), &dRho); CHKERRQ(ierr);
+
+	//=======================================================
+	// SINGLE SWEEP: density derivatives for all parameters
+	//=======================================================
+
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->lp, &p); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->lT, &T); CHKERRQ(ierr);
+
+	iter = 0;
+	GET_CELL_RANGE(nx, sx, fs->dsx)
+	GET_CELL_RANGE(ny, sy, fs->dsy)
+	GET_CELL_RANGE(nz, sz, fs->dsz)
+
+	START_STD_LOOP
+	{
+		// access solution variables
+		svCell = &jr->svCell[iter];
+
+		// access current pressure & temperature
+		pc = p[k][j][i];
+		Tc = T[k][j][i];
+
+		// z-coordinate of control volume
+		z = COORD_CELL(k, sz, fs->dsz);
+
+		// setup control volume parameters
+		ierr = setUpCtrlVol(&ctx, svCell->phRat, &svCell->svDev, &svCell->svBulk, pc, 0.0, 0.0, Tc, 0.0, z, 0.0); CHKERRQ(ierr);
+
+		// get derivatives with respect to all phase densities
+		ierr = volConstEqDensityDerivative(&ctx, drho); CHKERRQ(ierr);
+
+		for(ii = 0; ii < ctx.numPhases; ii++)
+		{
+			if(slot[ii] != -1) dRho[iter*nrho + slot[ii]] = drho[ii];
+		}
+
+		iter++;
+	}
+	END_STD_LOOP
+
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->lp, &p); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->lT, &T); CHKERRQ(ierr);
+
+	//=======================================================
+	// DISTRIBUTE: gravity & stabilization terms per parameter
+	//=======================================================
+
+	ierr = DMDAVecGetArray(fs->DA_X, jr->lvx, &vx); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_Y, jr->lvy, &vy); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_Z, jr->lvz, &vz); CHKERRQ(ierr);
+
+	for(ii = 0; ii < npar; ii++)
+	{
+		jj = slot[IOparam->phs[ipar[ii]]];
+
+		// clear local residual vectors
+		ierr = VecZeroEntries(jr->lfx); CHKERRQ(ierr);
+		ierr = VecZeroEntries(jr->lfy); CHKERRQ(ierr);
+		ierr = VecZeroEntries(jr->lfz); CHKERRQ(ierr);
+		ierr = VecZeroEntries(jr->gc);  CHKERRQ(ierr);
+
+		ierr = DMDAVecGetArray(fs->DA_X, jr->lfx, &fx); CHKERRQ(ierr);
+		ierr = DMDAVecGetArray(fs->DA_Y, jr->lfy, &fy); CHKERRQ(ierr);
+		ierr = DMDAVecGetArray(fs->DA_Z, jr->lfz, &fz); CHKERRQ(ierr);
+
+		iter = 0;
+
+		START_STD_LOOP
+		{
+			// compute gravity terms (see JacResGetResidual)
+			gx = dRho[iter*nrho + jj]*grav[0];
+			gy = dRho[iter*nrho + jj]*grav[1];
+			gz = dRho[iter*nrho + jj]*grav[2];
+
+			iter++;
+
+			// compute stabilization terms (lumped approximation)
+			tx = -fssa*dt*gx;
+			ty = -fssa*dt*gy;
+			tz = -fssa*dt*gz;
+
+			// get mesh steps for the backward and forward derivatives
+			bdx = SIZE_NODE(i, sx, fs->dsx);   fdx = SIZE_NODE(i+1, sx, fs->dsx);
+			bdy = SIZE_NODE(j, sy, fs->dsy);   fdy = SIZE_NODE(j+1, sy, fs->dsy);
+			bdz = SIZE_NODE(k, sz, fs->dsz);   fdz = SIZE_NODE(k+1, sz, fs->dsz);
+
+			// momentum
+			if(fssa_allVel)
+			{
+				fx[k][j][i] -= ((vx[k][j][i] + vy[k][j][i] + vz[k][j][i])*tx)/bdx + gx/2.0;   fx[k][j][i+1] += ((vx[k][j][i+1] + vy[k][j][i+1] + vz[k][j][i+1])*tx)/fdx - gx/2.0;
+				fy[k][j][i] -= ((vx[k][j][i] + vy[k][j][i] + vz[k][j][i])*ty)/bdy + gy/2.0;   fy[k][j+1][i] += ((vx[k][j+1][i] + vy[k][j+1][i] + vz[k][j+1][i])*ty)/fdy - gy/2.0;
+				fz[k][j][i] -= ((vx[k][j][i] + vy[k][j][i] + vz[k][j][i])*tz)/bdz + gz/2.0;   fz[k+1][j][i] += ((vx[k+1][j][i] + vy[k+1][j][i] + vz[k+1][j][i])*tz)/fdz - gz/2.0;
+			}
+			else
+			{
+				fx[k][j][i] -= (vx[k][j][i]*tx)/bdx + gx/2.0;   fx[k][j][i+1] += (vx[k][j][i+1]*tx)/fdx - gx/2.0;
+				fy[k][j][i] -= (vy[k][j][i]*ty)/bdy + gy/2.0;   fy[k][j+1][i] += (vy[k][j+1][i]*ty)/fdy - gy/2.0;
+				fz[k][j][i] -= (vz[k][j][i]*tz)/bdz + gz/2.0;   fz[k+1][j][i] += (vz[k+1][j][i]*tz)/fdz - gz/2.0;
+			}
+		}
+		END_STD_LOOP
+
+		ierr = DMDAVecRestoreArray(fs->DA_X, jr->lfx, &fx); CHKERRQ(ierr);
+		ierr = DMDAVecRestoreArray(fs->DA_Y, jr->lfy, &fy); CHKERRQ(ierr);
+		ierr = DMDAVecRestoreArray(fs->DA_Z, jr->lfz, &fz); CHKERRQ(ierr);
+
+		// assemble global residual derivative, enforce boundary constraints
+		LOCAL_TO_GLOBAL(fs->DA_X, jr->lfx, jr->gfx)
+		LOCAL_TO_GLOBAL(fs->DA_Y, jr->lfy, jr->gfy)
+		LOCAL_TO_GLOBAL(fs->DA_Z, jr->lfz, jr->gfz)
+
+		ierr = JacResCopyRes(jr, drdp[ii]); CHKERRQ(ierr);
+
+		// convert to derivative with respect to the (dimensional) inversion parameter
+		cf = 1.0/jr->scal->density;
+
+		if(IOparam->par_log10[ipar[ii]] == 1)
+		{
+			rho_dim  = pow(10.0, Par[ipar[ii]]);
+			cf      *= log(10.0)*rho_dim;
+		}
+
+		ierr = VecScale(drdp[ii], cf); CHKERRQ(ierr);
+	}
+
+	ierr = DMDAVecRestoreArray(fs->DA_X, jr->lvx, &vx); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_Y, jr->lvy, &vy); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_Z, jr->lvz, &vz); CHKERRQ(ierr);
+
+	ierr = PetscFree(dRho); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+/*---------------------------------------------------------------------------
+	Returns reference viscosity & strain rate of the dislocation creep law
+	of a phase (zero if the law is specified by Bn). These are required for
+	the derivative with respect to the power-law exponent, since in this
+	case Bn = (2*eta0)^(-n)*e0^(1-n) depends on the exponent as well.
+*/
+PetscErrorCode AdjointGetPowerLawReference(FB *fb, PetscInt ID, PetscScalar *eta0, PetscScalar *e0)
+{
+	PetscInt jj, id;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	(*eta0) = 0.0;
+	(*e0)   = 0.0;
+
+	// setup block access mode
+	ierr = FBFindBlocks(fb, _REQUIRED_, "<MaterialStart>", "<MaterialEnd>"); CHKERRQ(ierr);
+
+	for(jj = 0; jj < fb->nblocks; jj++)
+	{
+		id = -1;
+
+		ierr = getIntParam(fb, _REQUIRED_, "ID", &id, 1, _max_num_phases_); CHKERRQ(ierr);
+
+		// current values are taken from the command line (see getScalarParam)
+		fb->ID = id;
+
+		if(id == ID)
+		{
+			ierr = getScalarParam(fb, _OPTIONAL_, "eta0", eta0, 1, 1.0); CHKERRQ(ierr);
+			ierr = getScalarParam(fb, _OPTIONAL_, "e0",   e0,   1, 1.0); CHKERRQ(ierr);
+		}
+
+		fb->blockID++;
+	}
+
+	ierr = FBFreeBlocks(fb); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+/*---------------------------------------------------------------------------
+	Computes dr/dp analytically for diffusion & dislocation creep parameters
+	(eta, Bd, eta0, e0, Bn, n). At fixed velocity the creep parameters enter
+	the residual only through the effective viscosity of the deviatoric
+	stresses, i.e. dr/dp follows from the divergence of 2*(deta/dp)*D_ij.
+	The viscosity derivatives of all parameters are evaluated in a single
+	sweep over cells & edges (see devConstEqCreepDerivative), and are then
+	distributed to the faces for each parameter separately.
+*/
+PetscErrorCode AdjointFormResidualViscosityDerivatives(JacRes *jr, Vec x, ModParam *IOparam, PetscScalar *Par, PetscInt npar, PetscInt *ipar, Vec *drdp)
+{
+	ConstEqCtx  ctx;
+	FDSTAG     *fs;
+	Material_t *mat;
+	SolVarCell *svCell;
+	SolVarEdge *svEdge;
+	PetscInt    ii, jj, mm, iter, ncv, ord[_MAX_PAR_], phs[_MAX_PAR_];
+	PetscInt    i, j, k, nx, ny, nz, sx, sy, sz;
+	PetscScalar dlnBd[_MAX_PAR_], dlnBn[_MAX_PAR_], dn[_MAX_PAR_];
+	PetscScalar val, cf, eta0, e0, de, *dEta, *dXY, *dXZ, *dYZ;
+	PetscScalar bdx, fdx, bdy, fdy, bdz, fdz, dx, dy, dz, Le;
+	PetscScalar pc, Tc, pc_lith, pc_pore, sxx, syy, szz, sxy, sxz, syz;
+	PetscScalar ***fx, ***fy, ***fz, ***p, ***T, ***p_lith, ***p_pore;
+	PetscScalar ***dxx, ***dyy, ***dzz, ***dxy, ***dxz, ***dyz;
+	char       *name;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// access context
+	fs = jr->fs;
+
+	// sort parameters by phase (phase viscosity is evaluated once per phase)
+	for(ii = 0; ii < npar; ii++)
+	{
+		for(jj = ii; jj > 0 && IOparam->phs[ipar[ord[jj-1]]] > IOparam->phs[ipar[ii]]; jj--) ord[jj] = ord[jj-1];
+
+		ord[jj] = ii;
+	}
+
+	// get derivatives of creep constants with respect to the inversion parameters
+	// NOTE: nondimensional constants are proportional to the dimensional ones,
+	// except for the power-law exponent, which also enters the stress scaling
+	for(mm = 0; mm < npar; mm++)
+	{
+		ii   = ipar[ord[mm]];
+		name = IOparam->type_name[ii];
+
+		phs[mm]   = IOparam->phs[ii];
+		dlnBd[mm] = 0.0;
+		dlnBn[mm] = 0.0;
+		dn[mm]    = 0.0;
+
+		mat = jr->dbm->phases + phs[mm];
+
+		if(IOparam->par_log10[ii] == 1) val = pow(10.0, Par[ii]);
+		else                            val = Par[ii];
+
+		if     (!strcmp(name, "eta"))  dlnBd[mm] = -1.0/val;               // Bd = 1/(2*eta)
+		else if(!strcmp(name, "Bd"))   dlnBd[mm] =  1.0/val;
+		else if(!strcmp(name, "eta0")) dlnBn[mm] = -mat->n/val;            // Bn = (2*eta0)^(-n)*e0^(1-n)
+		else if(!strcmp(name, "e0"))   dlnBn[mm] =  (1.0 - mat->n)/val;
+		else if(!strcmp(name, "Bn"))   dlnBn[mm] =  1.0/val;
+		else if(!strcmp(name, "n"))
+		{
+			ierr = AdjointGetPowerLawReference(IOparam->fb, phs[mm], &eta0, &e0); CHKERRQ(ierr);
+
+			dn[mm]    = 1.0;
+			dlnBn[mm] = log(jr->scal->stress_si);
+
+			if(eta0 && e0) dlnBn[mm] -= log(2.0*eta0*e0);
+		}
+
+		// convert to derivative with respect to log10 of the parameter
+		if(IOparam->par_log10[ii] == 1)
+		{
+			cf         = log(10.0)*val;
+			dlnBd[mm] *= cf;
+			dlnBn[mm] *= cf;
+			dn[mm]    *= cf;
+		}
+	}
+
+	// evaluate residual at the solution to update effective strain rates
+	// and their second invariants (first derivative vector is used as storage)
+	ierr = JacResFormResidual(jr, x, drdp[0]); CHKERRQ(ierr);
+
+	// setup constitutive equation evaluation context parameters
+	ierr = setUpConstEq(&ctx, jr); CHKERRQ(ierr);
+
+	// allocate storage for viscosity derivatives
+	ncv = fs->nCells + fs->nXYEdg + fs->nXZEdg + fs->nYZEdg;
+
+	ierr = PetscMalloc((size_t)(ncv*npar)*sizeof(PetscScalar), &dEta); CHKERRQ(ierr);
+
+	dXY = dEta + fs->nCells*npar;
+	dXZ = dXY  + fs->nXYEdg*npar;
+	dYZ = dXZ  + fs->nXZEdg*npar;
+
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->lp,      &p);      CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->lT,      &T);      CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->lp_lith, &p_lith); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->lp_pore, &p_pore); CHKERRQ(ierr);
+
+	//=======================================================
+	// SINGLE SWEEP: viscosity derivatives for all parameters
+	//=======================================================
+
+	//-------------------------------
+	// central points
+	//-------------------------------
+	iter = 0;
+	GET_CELL_RANGE(nx, sx, fs->dsx)
+	GET_CELL_RANGE(ny, sy, fs->dsy)
+	GET_CELL_RANGE(nz, sz, fs->dsz)
+
+	START_STD_LOOP
+	{
+		// access solution variables
+		svCell = &jr->svCell[iter];
+
+		// get characteristic element size
+		dx = SIZE_CELL(i, sx, fs->dsx);
+		dy = SIZE_CELL(j, sy, fs->dsy);
+		dz = SIZE_CELL(k, sz, fs->dsz);
+		Le = sqrt(dx*dx + dy*dy + dz*dz);
+
+		// setup control volume parameters (see JacResGetResidual)
+		ierr = setUpCtrlVol(&ctx, svCell->phRat, &svCell->svDev, &svCell->svBulk, p[k][j][i], p_lith[k][j][i], p_pore[k][j][i], T[k][j][i], svCell->svDev.DII, COORD_CELL(k, sz, fs->dsz), Le); CHKERRQ(ierr);
+
+		// get viscosity derivatives
+		ierr = devConstEqCreepDerivative(&ctx, npar, phs, dlnBd, dlnBn, dn, dEta + iter*npar); CHKERRQ(ierr);
+
+		iter++;
+	}
+	END_STD_LOOP
+
+	//-------------------------------
+	// xy edge points
+	//-------------------------------
+	iter = 0;
+	GET_NODE_RANGE(nx, sx, fs->dsx)
+	GET_NODE_RANGE(ny, sy, fs->dsy)
+	GET_CELL_RANGE(nz, sz, fs->dsz)
+
+	START_STD_LOOP
+	{
+		// access solution variables
+		svEdge = &jr->svXYEdge[iter];
+
+		// access current pressure & temperature (x-y plane, i-j indices)
+		pc      = 0.25*(p     [k][j][i] + p     [k][j][i-1] + p     [k][j-1][i] + p     [k][j-1][i-1]);
+		Tc      = 0.25*(T     [k][j][i] + T     [k][j][i-1] + T     [k][j-1][i] + T     [k][j-1][i-1]);
+		pc_lith = 0.25*(p_lith[k][j][i] + p_lith[k][j][i-1] + p_lith[k][j-1][i] + p_lith[k][j-1][i-1]);
+		pc_pore = 0.25*(p_pore[k][j][i] + p_pore[k][j][i-1] + p_pore[k][j-1][i] + p_pore[k][j-1][i-1]);
+
+		// get characteristic element size
+		dx = SIZE_NODE(i, sx, fs->dsx);
+		dy = SIZE_NODE(j, sy, fs->dsy);
+		dz = SIZE_CELL(k, sz, fs->dsz);
+		Le = sqrt(dx*dx + dy*dy + dz*dz);
+
+		// setup control volume parameters
+		ierr = setUpCtrlVol(&ctx, svEdge->phRat, &svEdge->svDev, NULL, pc, pc_lith, pc_pore, Tc, svEdge->svDev.DII, DBL_MAX, Le); CHKERRQ(ierr);
+
+		// get viscosity derivatives
+		ierr = devConstEqCreepDerivative(&ctx, npar, phs, dlnBd, dlnBn, dn, dXY + iter*npar); CHKERRQ(ierr);
+
+		iter++;
+	}
+	END_STD_LOOP
+
+	//-------------------------------
+	// xz edge points
+	//-------------------------------
+	iter = 0;
+	GET_NODE_RANGE(nx, sx, fs->dsx)
+	GET_CELL_RANGE(ny, sy, fs->dsy)
+	GET_NODE_RANGE(nz, sz, fs->dsz)
+
+	START_STD_LOOP
+	{
+		// access solution variables
+		svEdge = &jr->svXZEdge[iter];
+
+		// access current pressure & temperature (x-z plane, i-k indices)
+		pc      = 0.25*(p     [k][j][i] + p     [k][j][i-1] + p     [k-1][j][i] + p     [k-1][j][i-1]);
+		Tc      = 0.25*(T     [k][j][i] + T     [k][j][i-1] + T     [k-1][j][i] + T     [k-1][j][i-1]);
+		pc_lith = 0.25*(p_lith[k][j][i] + p_lith[k][j][i-1] + p_lith[k-1][j][i] + p_lith[k-1][j][i-1]);
+		pc_pore = 0.25*(p_pore[k][j][i] + p_pore[k][j][i-1] + p_pore[k-1][j][i] + p_pore[k-1][j][i-1]);
+
+		// get characteristic element size
+		dx = SIZE_NODE(i, sx, fs->dsx);
+		dy = SIZE_CELL(j, sy, fs->dsy);
+		dz = SIZE_NODE(k, sz, fs->dsz);
+		Le = sqrt(dx*dx + dy*dy + dz*dz);
+
+		// setup control volume parameters
+		ierr = setUpCtrlVol(&ctx, svEdge->phRat, &svEdge->svDev, NULL, pc, pc_lith, pc_pore, Tc, svEdge->svDev.DII, DBL_MAX, Le); CHKERRQ(ierr);
+
+		// get viscosity derivatives
+		ierr = devConstEqCreepDerivative(&ctx, npar, phs, dlnBd, dlnBn, dn, dXZ + iter*npar); CHKERRQ(ierr);
+
+		iter++;
+	}
+	END_STD_LOOP
+
+	//-------------------------------
+	// yz edge points
+	//-------------------------------
+	iter = 0;
+	GET_CELL_RANGE(nx, sx, fs->dsx)
+	GET_NODE_RANGE(ny, sy, fs->dsy)
+	GET_NODE_RANGE(nz, sz, fs->dsz)
+
+	START_STD_LOOP
+	{
+		// access solution variables
+		svEdge = &jr->svYZEdge[iter];
+
+		// access current pressure & temperature (y-z plane, j-k indices)
+		pc      = 0.25*(p     [k][j][i] + p     [k][j-1][i] + p     [k-1][j][i] + p     [k-1][j-1][i]);
+		Tc      = 0.25*(T     [k][j][i] + T     [k][j-1][i] + T     [k-1][j][i] + T     [k-1][j-1][i]);
+		pc_lith = 0.25*(p_lith[k][j][i] + p_lith[k][j-1][i] + p_lith[k-1][j][i] + p_lith[k-1][j-1][i]);
+		pc_pore = 0.25*(p_pore[k][j][i] + p_pore[k][j-1][i] + p_pore[k-1][j][i] + p_pore[k-1][j-1][i]);
+
+		// get characteristic element size
+		dx = SIZE_CELL(i, sx, fs->dsx);
+		dy = SIZE_NODE(j, sy, fs->dsy);
+		dz = SIZE_NODE(k, sz, fs->dsz);
+		Le = sqrt(dx*dx + dy*dy + dz*dz);
+
+		// setup control volume parameters
+		ierr = setUpCtrlVol(&ctx, svEdge->phRat, &svEdge->svDev, NULL, pc, pc_lith, pc_pore, Tc, svEdge->svDev.DII, DBL_MAX, Le); CHKERRQ(ierr);
+
+		// get viscosity derivatives
+		ierr = devConstEqCreepDerivative(&ctx, npar, phs, dlnBd, dlnBn, dn, dYZ + iter*npar); CHKERRQ(ierr);
+
+		iter++;
+	}
+	END_STD_LOOP
+
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->lp,      &p);      CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->lT,      &T);      CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->lp_lith, &p_lith); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->lp_pore, &p_pore); CHKERRQ(ierr);
+
+	//=======================================================
+	// DISTRIBUTE: deviatoric stress derivatives per parameter
+	//=======================================================
+
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->ldxx, &dxx); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->ldyy, &dyy); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_CEN, jr->ldzz, &dzz); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_XY,  jr->ldxy, &dxy); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_XZ,  jr->ldxz, &dxz); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_YZ,  jr->ldyz, &dyz); CHKERRQ(ierr);
+
+	for(mm = 0; mm < npar; mm++)
+	{
+		// clear local residual vectors
+		ierr = VecZeroEntries(jr->lfx); CHKERRQ(ierr);
+		ierr = VecZeroEntries(jr->lfy); CHKERRQ(ierr);
+		ierr = VecZeroEntries(jr->lfz); CHKERRQ(ierr);
+		ierr = VecZeroEntries(jr->gc);  CHKERRQ(ierr);
+
+		ierr = DMDAVecGetArray(fs->DA_X, jr->lfx, &fx); CHKERRQ(ierr);
+		ierr = DMDAVecGetArray(fs->DA_Y, jr->lfy, &fy); CHKERRQ(ierr);
+		ierr = DMDAVecGetArray(fs->DA_Z, jr->lfz, &fz); CHKERRQ(ierr);
+
+		//-------------------------------
+		// central points
+		//-------------------------------
+		iter = 0;
+		GET_CELL_RANGE(nx, sx, fs->dsx)
+		GET_CELL_RANGE(ny, sy, fs->dsy)
+		GET_CELL_RANGE(nz, sz, fs->dsz)
+
+		START_STD_LOOP
+		{
+			de = dEta[(iter++)*npar + mm];
+
+			// compute stress derivatives
+			sxx = 2.0*de*dxx[k][j][i];
+			syy = 2.0*de*dyy[k][j][i];
+			szz = 2.0*de*dzz[k][j][i];
+
+			// get mesh steps for the backward and forward derivatives
+			bdx = SIZE_NODE(i, sx, fs->dsx);   fdx = SIZE_NODE(i+1, sx, fs->dsx);
+			bdy = SIZE_NODE(j, sy, fs->dsy);   fdy = SIZE_NODE(j+1, sy, fs->dsy);
+			bdz = SIZE_NODE(k, sz, fs->dsz);   fdz = SIZE_NODE(k+1, sz, fs->dsz);
+
+			// momentum
+			fx[k][j][i] -= sxx/bdx;   fx[k][j][i+1] += sxx/fdx;
+			fy[k][j][i] -= syy/bdy;   fy[k][j+1][i] += syy/fdy;
+			fz[k][j][i] -= szz/bdz;   fz[k+1][j][i] += szz/fdz;
+		}
+		END_STD_LOOP
+
+		//-------------------------------
+		// xy edge points
+		//-------------------------------
+		iter = 0;
+		GET_NODE_RANGE(nx, sx, fs->dsx)
+		GET_NODE_RANGE(ny, sy, fs->dsy)
+		GET_CELL_RANGE(nz, sz, fs->dsz)
+
+		START_STD_LOOP
+		{
+			sxy = 2.0*dXY[(iter++)*npar + mm]*dxy[k][j][i];
+
+			// get mesh steps for the backward and forward derivatives
+			bdx = SIZE_CELL(i-1, sx, fs->dsx);   fdx = SIZE_CELL(i, sx, fs->dsx);
+			bdy = SIZE_CELL(j-1, sy, fs->dsy);   fdy = SIZE_CELL(j, sy, fs->dsy);
+
+			// momentum
+			fx[k][j-1][i] -= sxy/bdy;   fx[k][j][i] += sxy/fdy;
+			fy[k][j][i-1] -= sxy/bdx;   fy[k][j][i] += sxy/fdx;
+		}
+		END_STD_LOOP
+
+		//-------------------------------
+		// xz edge points
+		//-------------------------------
+		iter = 0;
+		GET_NODE_RANGE(nx, sx, fs->dsx)
+		GET_CELL_RANGE(ny, sy, fs->dsy)
+		GET_NODE_RANGE(nz, sz, fs->dsz)
+
+		START_STD_LOOP
+		{
+			sxz = 2.0*dXZ[(iter++)*npar + mm]*dxz[k][j][i];
+
+			// get mesh steps for the backward and forward derivatives
+			bdx = SIZE_CELL(i-1, sx, fs->dsx);   fdx = SIZE_CELL(i, sx, fs->dsx);
+			bdz = SIZE_CELL(k-1, sz, fs->dsz);   fdz = SIZE_CELL(k, sz, fs->dsz);
+
+			// momentum
+			fx[k-1][j][i] -= sxz/bdz;   fx[k][j][i] += sxz/fdz;
+			fz[k][j][i-1] -= sxz/bdx;   fz[k][j][i] += sxz/fdx;
+		}
+		END_STD_LOOP
+
+		//-------------------------------
+		// yz edge points
+		//-------------------------------
+		iter = 0;
+		GET_CELL_RANGE(nx, sx, fs->dsx)
+		GET_NODE_RANGE(ny, sy, fs->dsy)
+		GET_NODE_RANGE(nz, sz, fs->dsz)
+
+		START_STD_LOOP
+		{
+			syz = 2.0*dYZ[(iter++)*npar + mm]*dyz[k][j][i];
+
+			// get mesh steps for the backward and forward derivatives
+			bdy = SIZE_CELL(j-1, sy, fs->dsy);   fdy = SIZE_CELL(j, sy, fs->dsy);
+			bdz = SIZE_CELL(k-1, sz, fs->dsz);   fdz = SIZE_CELL(k, sz, fs->dsz);
+
+			// momentum
+			fy[k-1][j][i] -= syz/bdz;   fy[k][j][i] += syz/fdz;
+			fz[k][j-1][i] -= syz/bdy;   fz[k][j][i] += syz/fdy;
+		}
+		END_STD_LOOP
+
+		ierr = DMDAVecRestoreArray(fs->DA_X, jr->lfx, &fx); CHKERRQ(ierr);
+		ierr = DMDAVecRestoreArray(fs->DA_Y, jr->lfy, &fy); CHKERRQ(ierr);
+		ierr = DMDAVecRestoreArray(fs->DA_Z, jr->lfz, &fz); CHKERRQ(ierr);
+
+		// assemble global residual derivative, enforce boundary constraints
+		LOCAL_TO_GLOBAL(fs->DA_X, jr->lfx, jr->gfx)
+		LOCAL_TO_GLOBAL(fs->DA_Y, jr->lfy, jr->gfy)
+		LOCAL_TO_GLOBAL(fs->DA_Z, jr->lfz, jr->gfz)
+
+		ierr = JacResCopyRes(jr, drdp[ord[mm]]); CHKERRQ(ierr);
+	}
+
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->ldxx, &dxx); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->ldyy, &dyy); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_CEN, jr->ldzz, &dzz); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_XY,  jr->ldxy, &dxy); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_XZ,  jr->ldxz, &dxz); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_YZ,  jr->ldyz, &dyz); CHKERRQ(ierr);
+
+	ierr = PetscFree(dEta); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
 //---------------------------------------------------------------------------
 PetscErrorCode AdjointFormResidualFieldFD(SNES snes, Vec x, Vec psi, NLSol *nl, AdjGrad *aop, ModParam *IOparam  )
 {
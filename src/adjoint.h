@@ -54,6 +54,7 @@ struct AdjGrad
 	Vec 			 pro;
 	Vec              vx, vy, vz, sty;
 	Vec              gradfield;                // Used if gradient at every point is computed (same size as jr->p)
+	KSP              ksp;                      // adjoint solver (shares Jacobian & Stokes preconditioner with the forward solver)
 };
 
 // Structure that holds vectors required by TAO
@@ -85,12 +86,14 @@ PetscErrorCode ComputeGradientsAndObjectiveFunction(Vec Parameters, PetscScalar
 // Adjoint Gradients
 PetscErrorCode AdjointComputeGradients(JacRes *jr, AdjGrad *aop, NLSol *nl, SNES snes, ModParam *IOparam);
 PetscErrorCode Adjoint_ApplyBCs(Vec dF, BCCtx* bc);
+PetscErrorCode AdjointSolverSetup(AdjGrad *aop, NLSol *nl, SNES snes);
 
 // Cost function
  PetscErrorCode AdjointObjectiveFunction(AdjGrad *aop, JacRes *jr, ModParam *IOparam, FreeSurf *surf);
 
 // 'Brute-force' finite difference gradients
 PetscErrorCode AdjointFiniteDifferenceGradients(ModParam *IOparam);				
+PetscErrorCode AdjointFiniteDifferenceGradientsGroups(ModParam *IOparam, PetscScalar FD_gradients_eps, PetscInt ngroups);
 PetscErrorCode PrintGradientsAndObservationPoints(ModParam *IOparam);
 PetscErrorCode PrintCostFunction(ModParam *IOparam);
 
@@ -106,6 +109,15 @@ PetscErrorCode AdjointGradientResetParameter(NLSol *nl, PetscInt CurPar, PetscIn
 // Gradient function for field sensitivity for rho (FD approximation)
 PetscErrorCode AdjointFormResidualFieldFD(SNES snes, Vec x, Vec psi, NLSol *nl, AdjGrad *aop, ModParam *IOparam );
 
+// Analytic dr/dp for all density parameters (single residual sweep)
+PetscErrorCode AdjointFormResidualDensityDerivatives(JacRes *jr, Vec x, ModParam *IOparam, PetscScalar *Par, PetscInt npar, PetscInt *ipar, Vec *drdp);
+
+// Reference viscosity & strain rate of a power-law phase (zero if Bn is given)
+PetscErrorCode AdjointGetPowerLawReference(FB *fb, PetscInt ID, PetscScalar *eta0, PetscScalar *e0);
+
+// Analytic dr/dp for all creep parameters (single constitutive sweep)
+PetscErrorCode AdjointFormResidualViscosityDerivatives(JacRes *jr, Vec x, ModParam *IOparam, PetscScalar *Par, PetscInt npar, PetscInt *ipar, Vec *drdp);
+
 // Add or remove parameters from command-line database & update material DB
 PetscErrorCode AddMaterialParameterToCommandLineOptions(char *name, PetscInt ID, PetscScalar val);
 PetscErrorCode DeleteMaterialParameterFromCommandLineOptions(char *name, PetscInt ID);
@@ -27,6 +27,7 @@
 #include "tools.h"
 #include "phase_transition.h"
 #include "passive_tracer.h"
+#include "profile.h"
 /*
 #START_DOC#
 \lamemfunction{\verb- ADVCreate -}
@@ -116,6 +117,7 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	ierr = getIntParam   (fb, _OPTIONAL_, "nmark_lim",       nmark_lim,      2, 0);            CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "nmark_avd",       nmark_avd,      3, 0);            CHKERRQ(ierr);
 	ierr = getIntParam   (fb, _OPTIONAL_, "nmark_sub",      &actx->npmax,    1, 27);           CHKERRQ(ierr);
+	ierr = getIntParam   (fb, _OPTIONAL_, "mark_compact",   &actx->compact,  1, 1);            CHKERRQ(ierr);
 
 	// CHECK
 
@@ -221,6 +223,7 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	if(actx->saveMark)      PetscPrintf(PETSC_COMM_WORLD,"   Marker storage file           : %s \n", actx->saveFile);
 	if(actx->bgPhase != -1) PetscPrintf(PETSC_COMM_WORLD,"   Background phase ID           : %lld \n", (LLD)actx->bgPhase);
 	if(actx->A)             PetscPrintf(PETSC_COMM_WORLD,"   Interpolation constant        : %g \n", actx->A);
+	if(actx->compact)       PetscPrintf(PETSC_COMM_WORLD,"   Compact marker record         : active \n");
 
 	PetscPrintf(PETSC_COMM_WORLD,"--------------------------------------------------------------------------\n");
 
@@ -271,6 +274,7 @@ PetscErrorCode ADVSetType(AdvCtx *actx, FB *fb)
 	else if(!strcmp(advect, "basic"))    actx->advect = BASIC_EULER;
 	else if(!strcmp(advect, "euler"))    actx->advect = EULER;
 	else if(!strcmp(advect, "rk2"))      actx->advect = RUNGE_KUTTA_2;
+	else if(!strcmp(advect, "rk4"))      actx->advect = RUNGE_KUTTA_4;
 	else SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Incorrect advection type (advect): %s", advect);
 
 	PetscPrintf(PETSC_COMM_WORLD, "Advection parameters:\n");
@@ -281,8 +285,9 @@ PetscErrorCode ADVSetType(AdvCtx *actx, FB *fb)
  	if     (actx->advect == BASIC_EULER)   PetscPrintf(PETSC_COMM_WORLD, "Euler 1-st order (basic implementation)\n");
 	else if(actx->advect == EULER)         PetscPrintf(PETSC_COMM_WORLD, "Euler 1-st order\n");
 	else if(actx->advect == RUNGE_KUTTA_2) PetscPrintf(PETSC_COMM_WORLD, "Runge-Kutta 2-nd order\n");
+	else if(actx->advect == RUNGE_KUTTA_4) PetscPrintf(PETSC_COMM_WORLD, "Runge-Kutta 4-th order\n");
 
- 	if((fs->dsx.periodic || fs->dsy.periodic || fs->dsz.periodic) && (actx->advect == EULER || actx->advect == RUNGE_KUTTA_2))
+ 	if((fs->dsx.periodic || fs->dsy.periodic || fs->dsz.periodic) && actx->advect != BASIC_EULER && actx->advect != ADV_NONE)
  	{
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Periodic marker advection is only compatible with BASIC_EULER (advect, periodic_x,y,z)");
  	}
@@ -324,18 +329,42 @@ PetscErrorCode ADVReadRestart(AdvCtx *actx, FILE *fp)
 	// check activation
  	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
 
+	// reset persistent buffers (pointers read from restart file are invalid)
+	actx->sendbuf  = NULL; actx->sendcap  = 0;
+	actx->recvbuf  = NULL; actx->recvcap  = 0;
+	actx->idel     = NULL; actx->delcap   = 0;
+	actx->gsendbuf = NULL; actx->gsendcap = 0;
+	actx->grecvbuf = NULL; actx->grecvcap = 0;
+	actx->packsend = NULL; actx->packsendcap = 0;
+	actx->packrecv = NULL; actx->packrecvcap = 0;
+	actx->nsend    = 0;
+	actx->nrecv    = 0;
+	actx->ndel     = 0;
+	actx->tinj     = 0;
+	actx->tdel     = 0;
+	actx->nghost   = 0;
+	actx->halo     = NULL;
+
 	// allocate memory for markers
 	ierr = PetscMalloc((size_t)actx->markcap*sizeof(Marker), &actx->markers); CHKERRQ(ierr);
 	ierr = PetscMemzero(actx->markers, (size_t)actx->markcap*sizeof(Marker)); CHKERRQ(ierr);
 
 	// allocate memory for host cell numbers
-	ierr = makeIntArray(&actx->cellnum, NULL, actx->markcap); CHKERRQ(ierr);
+	ierr = makeIntArray(&actx->cellnum,  NULL, actx->markcap); CHKERRQ(ierr);
+	ierr = makeIntArray(&actx->markedge, NULL, actx->markcap); CHKERRQ(ierr);
 
 	// allocate memory for indices of all markers in each cell
 	ierr = makeIntArray(&actx->markind, NULL, actx->markcap); CHKERRQ(ierr);
 
 	// read markers from disk
-	fread(actx->markers, (size_t)actx->nummark*sizeof(Marker), 1, fp);
+	if(actx->compact)
+	{
+		ierr = ADVReadPackMark(actx, fp); CHKERRQ(ierr);
+	}
+	else
+	{
+		fread(actx->markers, (size_t)actx->nummark*sizeof(Marker), 1, fp);
+	}
 
 	// create communicator and separator
 	ierr = ADVCreateData(actx); CHKERRQ(ierr);
@@ -351,13 +380,81 @@ PetscErrorCode ADVReadRestart(AdvCtx *actx, FILE *fp)
 //---------------------------------------------------------------------------
 PetscErrorCode ADVWriteRestart(AdvCtx *actx, FILE *fp)
 {
+	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// check activation
  	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
 
 	// store local markers to disk
-	fwrite(actx->markers, (size_t)actx->nummark*sizeof(Marker), 1, fp);
+	if(actx->compact)
+	{
+		ierr = ADVWritePackMark(actx, fp); CHKERRQ(ierr);
+	}
+	else
+	{
+		fwrite(actx->markers, (size_t)actx->nummark*sizeof(Marker), 1, fp);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVReadPackMark(AdvCtx *actx, FILE *fp)
+{
+	// read compact marker records from restart file (in chunks of send buffer size)
+
+	PetscInt  i, n, nread;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	actx->packsz = ADVGetPackSize(actx);
+
+	n = PetscMin(actx->nummark, _max_pack_chunk_);
+
+	ierr = ADVGrowBuff((void**)&actx->packrecv, &actx->packrecvcap, n, 0, actx->packsz); CHKERRQ(ierr);
+
+	for(nread = 0; nread < actx->nummark; nread += n)
+	{
+		n = PetscMin(actx->nummark - nread, _max_pack_chunk_);
+
+		fread(actx->packrecv, (size_t)n*actx->packsz, 1, fp);
+
+		for(i = 0; i < n; i++)
+		{
+			ADVUnpackMark(actx, actx->packrecv + (size_t)i*actx->packsz, &actx->markers[nread + i]);
+		}
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVWritePackMark(AdvCtx *actx, FILE *fp)
+{
+	// write compact marker records to restart file (in chunks of send buffer size)
+
+	PetscInt  i, n, nwrite;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	actx->packsz = ADVGetPackSize(actx);
+
+	n = PetscMin(actx->nummark, _max_pack_chunk_);
+
+	ierr = ADVGrowBuff((void**)&actx->packsend, &actx->packsendcap, n, 0, actx->packsz); CHKERRQ(ierr);
+
+	for(nwrite = 0; nwrite < actx->nummark; nwrite += n)
+	{
+		n = PetscMin(actx->nummark - nwrite, _max_pack_chunk_);
+
+		for(i = 0; i < n; i++)
+		{
+			ADVPackMark(actx, &actx->markers[nwrite + i], actx->packsend + (size_t)i*actx->packsz);
+		}
+
+		fwrite(actx->packsend, (size_t)n*actx->packsz, 1, fp);
+	}
 
 	PetscFunctionReturn(0);
 }
@@ -384,6 +481,9 @@ PetscErrorCode ADVCreateData(AdvCtx *actx)
 	actx->nproc = (PetscInt)nproc;
 	actx->iproc = (PetscInt)iproc;
 
+	// create neighbor exchange engine
+	ierr = MarkExchCreate(&actx->mex, fs, actx->icomm); CHKERRQ(ierr);
+
 	// allocate memory for marker index array separators
 	ierr = makeIntArray(&actx->markstart, NULL, fs->nCells + 1); CHKERRQ(ierr);
 
@@ -400,14 +500,22 @@ PetscErrorCode ADVDestroy(AdvCtx *actx)
 	// check activation
  	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
 
+	ierr = MarkExchDestroy(&actx->mex); CHKERRQ(ierr);
 	ierr = MPI_Comm_free(&actx->icomm); CHKERRQ(ierr);
 	ierr = PetscFree(actx->markers);    CHKERRQ(ierr);
 	ierr = PetscFree(actx->cellnum);    CHKERRQ(ierr);
+	ierr = PetscFree(actx->markedge);   CHKERRQ(ierr);
 	ierr = PetscFree(actx->markind);    CHKERRQ(ierr);
 	ierr = PetscFree(actx->markstart);  CHKERRQ(ierr);
 	ierr = PetscFree(actx->sendbuf);    CHKERRQ(ierr);
 	ierr = PetscFree(actx->recvbuf);    CHKERRQ(ierr);
 	ierr = PetscFree(actx->idel);       CHKERRQ(ierr);
+	ierr = PetscFree(actx->gsendbuf);   CHKERRQ(ierr);
+	ierr = PetscFree(actx->grecvbuf);   CHKERRQ(ierr);
+	ierr = PetscFree(actx->packsend);   CHKERRQ(ierr);
+	ierr = PetscFree(actx->packrecv);   CHKERRQ(ierr);
+
+	ierr = ADVelHaloDestroy(actx);      CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -452,7 +560,8 @@ PetscErrorCode ADVReAllocStorage(AdvCtx *actx, PetscInt nummark)
 	// or fixed maximum number markers per cell + deleting excessive markers.
 	// The latter has an advantage of maintaining memory locality).
 
-	Marker *markers;
+	Marker   *markers;
+	PetscInt *cellnum, *markedge;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -464,22 +573,36 @@ PetscErrorCode ADVReAllocStorage(AdvCtx *actx, PetscInt nummark)
 		actx->markcap = (PetscInt)(_cap_overhead_*(PetscScalar)nummark);
 
 		// reallocate memory for host cell and marker-in-cell indices
-		ierr = PetscFree(actx->cellnum); CHKERRQ(ierr);
 		ierr = PetscFree(actx->markind); CHKERRQ(ierr);
 
-		ierr = makeIntArray(&actx->cellnum, NULL, actx->markcap); CHKERRQ(ierr);
+		ierr = makeIntArray(&cellnum,       NULL, actx->markcap); CHKERRQ(ierr);
+		ierr = makeIntArray(&markedge,      NULL, actx->markcap); CHKERRQ(ierr);
 		ierr = makeIntArray(&actx->markind, NULL, actx->markcap); CHKERRQ(ierr);
 
+		// preserve host cells (maintained during marker control)
+		if(actx->nummark && actx->cellmap)
+		{
+			ierr = PetscMemcpy(cellnum,  actx->cellnum,  (size_t)actx->nummark*sizeof(PetscInt)); CHKERRQ(ierr);
+			ierr = PetscMemcpy(markedge, actx->markedge, (size_t)actx->nummark*sizeof(PetscInt)); CHKERRQ(ierr);
+		}
+
+		ierr = PetscFree(actx->cellnum);  CHKERRQ(ierr);
+		ierr = PetscFree(actx->markedge); CHKERRQ(ierr);
+
+		actx->cellnum  = cellnum;
+		actx->markedge = markedge;
+
 		// reallocate memory for markers
 		ierr = PetscMalloc((size_t)actx->markcap*sizeof(Marker), &markers); CHKERRQ(ierr);
-		ierr = PetscMemzero(markers, (size_t)actx->markcap*sizeof(Marker)); CHKERRQ(ierr);
 
-		// copy current data
+		// copy current data, clear the rest
 		if(actx->nummark)
 		{
 			ierr = PetscMemcpy(markers, actx->markers, (size_t)actx->nummark*sizeof(Marker)); CHKERRQ(ierr);
 		}
 
+		ierr = PetscMemzero(markers + actx->nummark, (size_t)(actx->markcap - actx->nummark)*sizeof(Marker)); CHKERRQ(ierr);
+
 		// update marker storage
 		ierr = PetscFree(actx->markers); CHKERRQ(ierr);
 		actx->markers = markers;
@@ -557,10 +680,11 @@ PetscErrorCode ADVRemap(AdvCtx *actx)
 	{
 
 		// check markers and inject/delete if necessary in all control volumes
+		// (host cells are computed and maintained by marker control)
 		ierr = AVDMarkerControl(actx); CHKERRQ(ierr);
 
-		// compute host cells for all the markers received
-		ierr = ADVMapMarkToCells(actx); CHKERRQ(ierr);
+		// list markers in every cell
+		ierr = ADVGetMarkCellList(actx); CHKERRQ(ierr);
 
 		PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
 	}
@@ -601,6 +725,8 @@ PetscErrorCode ADVExchange(AdvCtx *actx)
 
 	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
 
+	ierr = PetscLogEventBegin(LaMEM_Exchange, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	// count number of markers to be sent to each neighbor domain
 	ierr = ADVMapMarkToDomains(actx); CHKERRQ(ierr);
 
@@ -622,6 +748,8 @@ PetscErrorCode ADVExchange(AdvCtx *actx)
 	// free communication buffer
 	ierr = ADVDestroyMPIBuff(actx); CHKERRQ(ierr);
 
+	ierr = PetscLogEventEnd(LaMEM_Exchange, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -663,9 +791,9 @@ PetscErrorCode ADVInterpFieldToMark(AdvCtx *actx, InterpCase icase)
 	PetscScalar  UPXX, UPYY, UPZZ, UPXY, UPXZ, UPYZ;
 	PetscInt     nx, ny, sx, sy, sz;
 	PetscInt     jj, ID, I, J, K, II, JJ, KK;
-	PetscScalar *gxy, *gxz, *gyz, ***lxy, ***lxz, ***lyz;
+	PetscScalar ***lxy, ***lxz, ***lyz;
 
-	PetscScalar  xc, yc, zc, xp, yp, zp, wx, wy, wz, d, dt;
+	PetscScalar  wx, wy, wz, dt;
 
 	PetscInt     healID, phase_ID;
 	  
@@ -691,40 +819,10 @@ PetscErrorCode ADVInterpFieldToMark(AdvCtx *actx, InterpCase icase)
 	}
 	else
 	{
-		// access 1D layouts of global vectors
-		ierr = VecGetArray(jr->gdxy, &gxy);  CHKERRQ(ierr);
-		ierr = VecGetArray(jr->gdxz, &gxz);  CHKERRQ(ierr);
-		ierr = VecGetArray(jr->gdyz, &gyz);  CHKERRQ(ierr);
-
-		if(icase == _STRESS_)
-		{
-			for(jj = 0; jj < fs->nXYEdg; jj++) gxy[jj] = jr->svXYEdge[jj].s - jr->svXYEdge[jj].h;
-			for(jj = 0; jj < fs->nXZEdg; jj++) gxz[jj] = jr->svXZEdge[jj].s - jr->svXZEdge[jj].h;
-			for(jj = 0; jj < fs->nYZEdg; jj++) gyz[jj] = jr->svYZEdge[jj].s - jr->svYZEdge[jj].h;
-		}
-		else if(icase == _APS_)
-		{
-			for(jj = 0; jj < fs->nXYEdg; jj++) gxy[jj] = jr->svXYEdge[jj].svDev.PSR;
-			for(jj = 0; jj < fs->nXZEdg; jj++) gxz[jj] = jr->svXZEdge[jj].svDev.PSR;
-			for(jj = 0; jj < fs->nYZEdg; jj++) gyz[jj] = jr->svYZEdge[jj].svDev.PSR;
-		}
-		else if(icase == _ATS_)
-		{
-			for(jj = 0; jj < fs->nXYEdg; jj++) { d = jr->svXYEdge[jj].d;  gxy[jj] = d*d; }
-			for(jj = 0; jj < fs->nXZEdg; jj++) { d = jr->svXZEdge[jj].d;  gxz[jj] = d*d; }
-			for(jj = 0; jj < fs->nYZEdg; jj++) { d = jr->svYZEdge[jj].d;  gyz[jj] = d*d; }
-		}
-
-		// restore access
-		ierr = VecRestoreArray(jr->gdxy, &gxy); CHKERRQ(ierr);
-		ierr = VecRestoreArray(jr->gdxz, &gxz); CHKERRQ(ierr);
-		ierr = VecRestoreArray(jr->gdyz, &gyz); CHKERRQ(ierr);
-
-		// communicate boundary values
-		GLOBAL_TO_LOCAL(fs->DA_XY, jr->gdxy, jr->ldxy);
-		GLOBAL_TO_LOCAL(fs->DA_XZ, jr->gdxz, jr->ldxz);
-		GLOBAL_TO_LOCAL(fs->DA_YZ, jr->gdyz, jr->ldyz);
-
+		// copy owned values to local vectors & communicate boundary values
+		ierr = ADVGetEdgeIncrement(fs->DA_XY, jr->ldxy, jr->svXYEdge, icase); CHKERRQ(ierr);
+		ierr = ADVGetEdgeIncrement(fs->DA_XZ, jr->ldxz, jr->svXZEdge, icase); CHKERRQ(ierr);
+		ierr = ADVGetEdgeIncrement(fs->DA_YZ, jr->ldyz, jr->svYZEdge, icase); CHKERRQ(ierr);
 	}
 
 	// access 3D layouts of local vectors
@@ -744,20 +842,10 @@ PetscErrorCode ADVInterpFieldToMark(AdvCtx *actx, InterpCase icase)
 		// expand I, J, K cell indices
 		GET_CELL_IJK(ID, I, J, K, nx, ny)
 
-		// get marker coordinates
-		xp = P->X[0];
-		yp = P->X[1];
-		zp = P->X[2];
-
-		// get coordinates of cell center
-		xc = fs->dsx.ccoor[I];
-		yc = fs->dsy.ccoor[J];
-		zc = fs->dsz.ccoor[K];
-
-		// map marker on the control volumes of edge nodes
-		if(xp > xc) { II = I+1; } else { II = I; }
-		if(yp > yc) { JJ = J+1; } else { JJ = J; }
-		if(zp > zc) { KK = K+1; } else { KK = K; }
+		// map marker on the control volumes of edge nodes (stored shift flags)
+		II = I + ( actx->markedge[jj]       & 1);
+		JJ = J + ((actx->markedge[jj] >> 1) & 1);
+		KK = K + ((actx->markedge[jj] >> 2) & 1);
 
 		// access buffer
 		UPXY = lxy[sz+K ][sy+JJ][sx+II];
@@ -993,45 +1081,11 @@ PetscErrorCode ADVMapMarkToDomains(AdvCtx *actx)
 PetscErrorCode ADVExchangeNumMark(AdvCtx *actx)
 {
 	// communicate number of markers with neighbor processes
-	FDSTAG     *fs;
-	PetscInt    k;
-	PetscMPIInt scnt, rcnt;
-	MPI_Request srequest[_num_neighb_];
-	MPI_Request rrequest[_num_neighb_];
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	fs = actx->fs;
-
-	// zero out message counters
-	scnt = 0;
-	rcnt = 0;
-
-	// send number of markers to ALL neighbor processes (except self & non-existing)
-	for(k = 0; k < _num_neighb_; k++)
-	{
-		if(fs->neighb[k] != actx->iproc && fs->neighb[k] != -1)
-		{
-			ierr = MPI_Isend(&actx->nsendm[k], 1, MPIU_INT,
-				fs->neighb[k], 100, actx->icomm, &srequest[scnt++]); CHKERRQ(ierr);
-		}
-	}
-
-	// receive number of markers from ALL neighbor processes (except self & non-existing)
-	for(k = 0; k < _num_neighb_; k++)
-	{
-		if(fs->neighb[k] != actx->iproc && fs->neighb[k] != -1)
-		{
-			ierr = MPI_Irecv(&actx->nrecvm[k], 1, MPIU_INT,
-				fs->neighb[k], 100, actx->icomm, &rrequest[rcnt++]); CHKERRQ(ierr);
-		}
-		else actx->nrecvm[k] = 0;
-	}
-
-	// wait until all communication processes have been terminated
-	if(scnt) { ierr = MPI_Waitall(scnt, srequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
-	if(rcnt) { ierr = MPI_Waitall(rcnt, rrequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
+	ierr = MarkExchNum(&actx->mex, actx->nsendm, actx->nrecvm); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -1039,9 +1093,8 @@ PetscErrorCode ADVExchangeNumMark(AdvCtx *actx)
 PetscErrorCode ADVCreateMPIBuff(AdvCtx *actx)
 {
 	// create send and receive buffers for asynchronous MPI communication
+	// (buffers are persistent and only grow when current capacity is exceeded)
 
-	// NOTE! Currently the memory allocation model is fully dynamic.
-	// Maybe it makes sense to introduce static model with reallocation.
 	FDSTAG     *fs;
 	PetscInt    i, cnt, lrank;
 	PetscMPIInt grank;
@@ -1055,14 +1108,8 @@ PetscErrorCode ADVCreateMPIBuff(AdvCtx *actx)
 	actx->nsend = getPtrCnt(_num_neighb_, actx->nsendm, actx->ptsend);
 	actx->nrecv = getPtrCnt(_num_neighb_, actx->nrecvm, actx->ptrecv);
 
-	actx->sendbuf = NULL;
-	actx->recvbuf = NULL;
-	actx->idel    = NULL;
-
-	// allocate exchange buffers & array of deleted (sent) marker indices
-	if(actx->nsend) { ierr = PetscMalloc((size_t)actx->nsend*sizeof(Marker),   &actx->sendbuf); CHKERRQ(ierr); }
-	if(actx->nrecv) { ierr = PetscMalloc((size_t)actx->nrecv*sizeof(Marker),   &actx->recvbuf); CHKERRQ(ierr); }
-	if(actx->ndel)  { ierr = PetscMalloc((size_t)actx->ndel *sizeof(PetscInt), &actx->idel);    CHKERRQ(ierr); }
+	// reserve exchange buffers & array of deleted (sent) marker indices
+	ierr = ADVReserveBuff(actx, actx->nsend, actx->nrecv, actx->ndel); CHKERRQ(ierr);
 
 	// copy markers to send buffer, store their indices
 	for(i = 0, cnt = 0; i < actx->nummark; i++)
@@ -1159,62 +1206,229 @@ PetscErrorCode ADVApplyPeriodic(AdvCtx *actx)
 PetscErrorCode ADVExchangeMark(AdvCtx *actx)
 {
 	// communicate markers with neighbor processes
-	FDSTAG     *fs;
-	PetscInt    k;
-	PetscMPIInt scnt, rcnt, nbyte;
-	MPI_Request srequest[_num_neighb_];
-	MPI_Request rrequest[_num_neighb_];
+
+	PetscInt i;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	fs = actx->fs;
+	if(!actx->compact)
+	{
+		ierr = MarkExchData(&actx->mex, sizeof(Marker),
+			actx->sendbuf, actx->nsendm, actx->ptsend,
+			actx->recvbuf, actx->nrecvm, actx->ptrecv); CHKERRQ(ierr);
+
+		PetscFunctionReturn(0);
+	}
 
-	// zero out message counters
-	scnt = 0;
-	rcnt = 0;
+	// exchange compact marker records
+	actx->packsz = ADVGetPackSize(actx);
 
-	// send packages (if any) with markers to neighbor processes
-	for(k = 0; k < _num_neighb_; k++)
+	ierr = ADVGrowBuff((void**)&actx->packsend, &actx->packsendcap, actx->nsend, 0, actx->packsz); CHKERRQ(ierr);
+	ierr = ADVGrowBuff((void**)&actx->packrecv, &actx->packrecvcap, actx->nrecv, 0, actx->packsz); CHKERRQ(ierr);
+
+	for(i = 0; i < actx->nsend; i++)
 	{
-		if(actx->nsendm[k])
-		{
-			nbyte = (PetscMPIInt)(actx->nsendm[k]*(PetscInt)sizeof(Marker));
+		ADVPackMark(actx, &actx->sendbuf[i], actx->packsend + (size_t)i*actx->packsz);
+	}
 
-			ierr = MPI_Isend(&actx->sendbuf[actx->ptsend[k]], nbyte, MPI_BYTE,
-				fs->neighb[k], 200, actx->icomm, &srequest[scnt++]); CHKERRQ(ierr);
+	ierr = MarkExchData(&actx->mex, actx->packsz,
+		actx->packsend, actx->nsendm, actx->ptsend,
+		actx->packrecv, actx->nrecvm, actx->ptrecv); CHKERRQ(ierr);
 
-		}
+	for(i = 0; i < actx->nrecv; i++)
+	{
+		ADVUnpackMark(actx, actx->packrecv + (size_t)i*actx->packsz, &actx->recvbuf[i]);
 	}
 
-	// receive packages (if any) with markers from neighbor processes
-	for(k = 0; k < _num_neighb_; k++)
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVDestroyMPIBuff(AdvCtx *actx)
+{
+	PetscFunctionBeginUser;
+
+	// buffers are kept for the next step (released in ADVDestroy), reset counters
+	actx->nsend = 0;
+	actx->nrecv = 0;
+	actx->ndel  = 0;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVGrowBuff(void **buff, PetscInt *cap, PetscInt n, PetscInt nkeep, size_t size)
+{
+	// grow persistent buffer to hold at least n entries, preserve first nkeep entries
+	// capacity is increased with overhead to amortize reallocation
+
+	void *tmp;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(n <= (*cap)) PetscFunctionReturn(0);
+
+	// update capacity
+	(*cap) = (PetscInt)(_cap_overhead_*(PetscScalar)n);
+
+	// reallocate storage
+	ierr = PetscMalloc((size_t)(*cap)*size, &tmp); CHKERRQ(ierr);
+
+	if(nkeep)
 	{
-		if(actx->nrecvm[k])
-		{
-			nbyte = (PetscMPIInt)(actx->nrecvm[k]*(PetscInt)sizeof(Marker));
+		ierr = PetscMemcpy(tmp, (*buff), (size_t)nkeep*size); CHKERRQ(ierr);
+	}
 
-			ierr = MPI_Irecv(&actx->recvbuf[actx->ptrecv[k]], nbyte, MPI_BYTE,
-				fs->neighb[k], 200, actx->icomm, &rrequest[rcnt++]); CHKERRQ(ierr);
-		}
+	ierr = PetscFree((*buff)); CHKERRQ(ierr);
+
+	(*buff) = tmp;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+size_t ADVGetPackSize(AdvCtx *actx)
+{
+	// compact record: coordinates (double), phase (short), p, T, APS, stress (float)
+	// optional: ATS, displacement (float)
+
+	size_t sz;
+
+	sz = 3*sizeof(double) + sizeof(short) + 9*sizeof(float);
+
+	if(actx->packATS) sz +=   sizeof(float);
+	if(actx->packU)   sz += 3*sizeof(float);
+
+	return sz;
+}
+//---------------------------------------------------------------------------
+void ADVPackMark(AdvCtx *actx, Marker *P, char *rec)
+{
+	double X[3];
+	float  F[13];
+	short  phase;
+	size_t nf;
+
+	X[0]  = (double)P->X[0];
+	X[1]  = (double)P->X[1];
+	X[2]  = (double)P->X[2];
+	phase = (short) P->phase;
+
+	nf = 0;
+	F[nf++] = (float)P->p;
+	F[nf++] = (float)P->T;
+	F[nf++] = (float)P->APS;
+	F[nf++] = (float)P->S.xx;
+	F[nf++] = (float)P->S.yy;
+	F[nf++] = (float)P->S.zz;
+	F[nf++] = (float)P->S.xy;
+	F[nf++] = (float)P->S.xz;
+	F[nf++] = (float)P->S.yz;
+
+	if(actx->packATS)
+	{
+		F[nf++] = (float)P->ATS;
+	}
+	if(actx->packU)
+	{
+		F[nf++] = (float)P->U[0];
+		F[nf++] = (float)P->U[1];
+		F[nf++] = (float)P->U[2];
 	}
 
-	// wait until all communication processes have been terminated
-	if(scnt) { ierr = MPI_Waitall(scnt, srequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
-	if(rcnt) { ierr = MPI_Waitall(rcnt, rrequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
+	// records are byte-packed, copy fields without alignment assumptions
+	memcpy(rec, X,      3*sizeof(double)); rec += 3*sizeof(double);
+	memcpy(rec, &phase,   sizeof(short));  rec +=   sizeof(short);
+	memcpy(rec, F,     nf*sizeof(float));
+}
+//---------------------------------------------------------------------------
+void ADVUnpackMark(AdvCtx *actx, char *rec, Marker *P)
+{
+	double X[3];
+	float  F[13];
+	short  phase;
+	size_t nf;
+
+	nf = 9;
+
+	if(actx->packATS) nf += 1;
+	if(actx->packU)   nf += 3;
+
+	memcpy(X,      rec, 3*sizeof(double)); rec += 3*sizeof(double);
+	memcpy(&phase, rec,   sizeof(short));  rec +=   sizeof(short);
+	memcpy(F,      rec, nf*sizeof(float));
+
+	P->X[0]  = (PetscScalar)X[0];
+	P->X[1]  = (PetscScalar)X[1];
+	P->X[2]  = (PetscScalar)X[2];
+	P->phase = (PetscInt)phase;
+
+	nf = 0;
+	P->p    = (PetscScalar)F[nf++];
+	P->T    = (PetscScalar)F[nf++];
+	P->APS  = (PetscScalar)F[nf++];
+	P->S.xx = (PetscScalar)F[nf++];
+	P->S.yy = (PetscScalar)F[nf++];
+	P->S.zz = (PetscScalar)F[nf++];
+	P->S.xy = (PetscScalar)F[nf++];
+	P->S.xz = (PetscScalar)F[nf++];
+	P->S.yz = (PetscScalar)F[nf++];
+
+	P->ATS  = 0.0;
+	P->U[0] = 0.0;
+	P->U[1] = 0.0;
+	P->U[2] = 0.0;
+
+	if(actx->packATS)
+	{
+		P->ATS  = (PetscScalar)F[nf++];
+	}
+	if(actx->packU)
+	{
+		P->U[0] = (PetscScalar)F[nf++];
+		P->U[1] = (PetscScalar)F[nf++];
+		P->U[2] = (PetscScalar)F[nf++];
+	}
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVReserveBuff(AdvCtx *actx, PetscInt nsend, PetscInt nrecv, PetscInt ndel)
+{
+	// reserve persistent exchange, injection and deletion buffers
+	// NOTE: current buffer contents are discarded
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = ADVGrowBuff((void**)&actx->sendbuf, &actx->sendcap, nsend, 0, sizeof(Marker));   CHKERRQ(ierr);
+	ierr = ADVGrowBuff((void**)&actx->recvbuf, &actx->recvcap, nrecv, 0, sizeof(Marker));   CHKERRQ(ierr);
+	ierr = ADVGrowBuff((void**)&actx->idel,    &actx->delcap,  ndel,  0, sizeof(PetscInt)); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode ADVDestroyMPIBuff(AdvCtx *actx)
+PetscErrorCode ADVPushMark(AdvCtx *actx, Marker *P)
 {
+	// append marker to injection buffer
+
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	// destroy buffers
-	ierr = PetscFree(actx->sendbuf); CHKERRQ(ierr);
-	ierr = PetscFree(actx->recvbuf); CHKERRQ(ierr);
-	ierr = PetscFree(actx->idel);  	 CHKERRQ(ierr);
+	ierr = ADVGrowBuff((void**)&actx->recvbuf, &actx->recvcap, actx->nrecv+1, actx->nrecv, sizeof(Marker)); CHKERRQ(ierr);
+
+	actx->recvbuf[actx->nrecv++] = (*P);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVPushDel(AdvCtx *actx, PetscInt ind)
+{
+	// append marker index to deletion buffer
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = ADVGrowBuff((void**)&actx->idel, &actx->delcap, actx->ndel+1, actx->ndel, sizeof(PetscInt)); CHKERRQ(ierr);
+
+	actx->idel[actx->ndel++] = ind;
 
 	PetscFunctionReturn(0);
 }
@@ -1222,27 +1436,39 @@ PetscErrorCode ADVDestroyMPIBuff(AdvCtx *actx)
 PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 {
 	// store received markers, collect garbage
+	// host cells and edge flags are moved along with markers if requested
 
 	Marker   *markers, *recvbuf;
 	PetscInt *idel, nummark, nrecv, ndel;
+	PetscInt *cellnum, *markedge;
+	PetscBool cellmap;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
 	// access storage
-	nummark = actx->nummark;
-	markers = actx->markers;
+	nummark  = actx->nummark;
+	markers  = actx->markers;
+	cellnum  = actx->cellnum;
+	markedge = actx->markedge;
+	cellmap  = actx->cellmap;
 
-	nrecv   = actx->nrecv;
-	recvbuf = actx->recvbuf;
+	nrecv    = actx->nrecv;
+	recvbuf  = actx->recvbuf;
 
-	ndel    = actx->ndel;
-	idel    = actx->idel;
+	ndel     = actx->ndel;
+	idel     = actx->idel;
 
 	// close holes in marker storage
 	while(nrecv && ndel)
 	{
 		markers[idel[ndel-1]] = recvbuf[nrecv-1];
+
+		if(cellmap)
+		{
+			ierr = ADVGetMarkCell(actx, &recvbuf[nrecv-1], &cellnum[idel[ndel-1]], &markedge[idel[ndel-1]]); CHKERRQ(ierr);
+		}
+
 		nrecv--;
 		ndel--;
 	}
@@ -1253,11 +1479,18 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 		ierr = ADVReAllocStorage(actx, nummark + nrecv); CHKERRQ(ierr);
 
 		// make sure we have a correct storage pointer
-		markers = actx->markers;
+		markers  = actx->markers;
+		cellnum  = actx->cellnum;
+		markedge = actx->markedge;
 
 		// put the rest in the end of marker storage
 		while(nrecv)
 		{
+			if(cellmap)
+			{
+				ierr = ADVGetMarkCell(actx, &recvbuf[nrecv-1], &cellnum[nummark], &markedge[nummark]); CHKERRQ(ierr);
+			}
+
 			markers[nummark++] = recvbuf[nrecv-1];
 			nrecv--;
 		}
@@ -1271,6 +1504,12 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 			if(idel[ndel-1] != nummark-1)
 			{
 				markers[idel[ndel-1]] = markers[nummark-1];
+
+				if(cellmap)
+				{
+					cellnum [idel[ndel-1]] = cellnum [nummark-1];
+					markedge[idel[ndel-1]] = markedge[nummark-1];
+				}
 			}
 			nummark--;
 			ndel--;
@@ -1286,11 +1525,38 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 PetscErrorCode ADVMapMarkToCells(AdvCtx *actx)
 {
 	// store host cell ID for every marker & list of marker IDs in every cell
+	// edge control volume flags are computed in the same pass
 	// NOTE: this routine MUST be called for the local markers only
 
+	PetscInt i;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PetscLogEventBegin(LaMEM_MapMarkCells, 0, 0, 0, 0); CHKERRQ(ierr);
+
+	// loop over all local particles
+	for(i = 0; i < actx->nummark; i++)
+	{
+		ierr = ADVGetMarkCell(actx, &actx->markers[i], &actx->cellnum[i], &actx->markedge[i]); CHKERRQ(ierr);
+	}
+
+	// list marker IDs in every cell
+	ierr = ADVGetMarkCellList(actx); CHKERRQ(ierr);
+
+	ierr = PetscLogEventEnd(LaMEM_MapMarkCells, 0, 0, 0, 0); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//-----------------------------------------------------------------------------
+PetscErrorCode ADVGetMarkCell(AdvCtx *actx, Marker *P, PetscInt *ID, PetscInt *edge)
+{
+	// get host cell ID and edge control volume shift flags of a single marker
+	// (flag is set if the coordinate is above the cell center, see ADVInterpMarkToEdge)
+
 	FDSTAG      *fs;
 	PetscScalar *X;
-	PetscInt     i, ID, I, J, K, M, N, nummark;
+	PetscInt     I, J, K, M, N;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -1300,27 +1566,44 @@ PetscErrorCode ADVMapMarkToCells(AdvCtx *actx)
 	M  = fs->dsx.ncels;
 	N  = fs->dsy.ncels;
 
-	// loop over all local particles
-	for(i = 0; i < actx->nummark; i++)
+	// get marker coordinates
+	X = P->X;
+
+	// get host cell IDs in all directions
+	ierr = Discret1DFindPoint(&fs->dsx, X[0], I); CHKERRQ(ierr);
+	ierr = Discret1DFindPoint(&fs->dsy, X[1], J); CHKERRQ(ierr);
+	ierr = Discret1DFindPoint(&fs->dsz, X[2], K); CHKERRQ(ierr);
+
+	// compute and store consecutive index
+	GET_CELL_ID((*ID), I, J, K, M, N);
+
+	if((*ID) < 0 || (*ID) > fs->nCells-1)
 	{
-		// get marker coordinates
-		X = actx->markers[i].X;
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Wrong marker-to-cell-mapping (cell ID)");
+	}
 
-		// get host cell IDs in all directions
-		ierr = Discret1DFindPoint(&fs->dsx, X[0], I); CHKERRQ(ierr);
-		ierr = Discret1DFindPoint(&fs->dsy, X[1], J); CHKERRQ(ierr);
-		ierr = Discret1DFindPoint(&fs->dsz, X[2], K); CHKERRQ(ierr);
+	// edge control volume flags
+	(*edge) = 0;
 
-		// compute and store consecutive index
-		GET_CELL_ID(ID, I, J, K, M, N);
+	if(X[0] > fs->dsx.ccoor[I]) (*edge) |= 1;
+	if(X[1] > fs->dsy.ccoor[J]) (*edge) |= 2;
+	if(X[2] > fs->dsz.ccoor[K]) (*edge) |= 4;
 
-		if(ID < 0 || ID > fs->nCells-1)
-		{
-			SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Wrong marker-to-cell-mapping (cell ID)");
-		}
+	PetscFunctionReturn(0);
+}
+//-----------------------------------------------------------------------------
+PetscErrorCode ADVGetMarkCellList(AdvCtx *actx)
+{
+	// list marker IDs in every cell from stored host cell IDs
 
-		actx->cellnum[i] = ID;
-	}
+	FDSTAG      *fs;
+	PetscInt     i, nummark;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// get context
+	fs = actx->fs;
 
 	// count number of markers per cell
 	ierr = clearIntArray(actx->markstart, fs->nCells+1); CHKERRQ(ierr);
@@ -1399,9 +1682,8 @@ PetscErrorCode ADVMarkControl(AdvCtx *actx)
 	actx->nrecv = ninj;
 	actx->ndel  = ndel;
 
-	// allocate memory
-	if(ninj) { ierr = PetscMalloc((size_t)actx->nrecv*sizeof(Marker),   &actx->recvbuf); CHKERRQ(ierr); }
-	if(ndel) { ierr = PetscMalloc((size_t)actx->ndel *sizeof(PetscInt), &actx->idel);    CHKERRQ(ierr); }
+	// reserve memory
+	ierr = ADVReserveBuff(actx, 0, ninj, ndel); CHKERRQ(ierr);
 
 	actx->cinj = 0;
 	actx->cdel = 0;
@@ -1428,6 +1710,10 @@ PetscErrorCode ADVMarkControl(AdvCtx *actx)
 		}
 	}
 
+	// update total counters
+	actx->tinj += actx->nrecv;
+	actx->tdel += actx->ndel;
+
 	// store new markers
 	ierr = ADVCollectGarbage(actx); CHKERRQ(ierr);
 
@@ -1438,9 +1724,9 @@ PetscErrorCode ADVMarkControl(AdvCtx *actx)
 	ierr = PetscTime(&t1); CHKERRQ(ierr);
 	PetscPrintf(PETSC_COMM_WORLD,"Marker control [%lld]: (AVD Cell) injected %lld markers and deleted %lld markers in %1.4e s\n",(LLD)actx->iproc, (LLD)ninj, (LLD)ndel, t1-t0);
 
-	// clear
-	ierr = PetscFree(actx->recvbuf); CHKERRQ(ierr);
-	ierr = PetscFree(actx->idel);    CHKERRQ(ierr);
+	// reset buffer counters
+	actx->nrecv = 0;
+	actx->ndel  = 0;
 
 	PetscFunctionReturn(0);
 }
@@ -1544,7 +1830,7 @@ PetscErrorCode ADVCheckCorners(AdvCtx *actx)
 	
 	// allocate memory for new markers
 	actx->nrecv = ninj;
-	ierr = PetscMalloc((size_t)actx->nrecv*sizeof(Marker), &actx->recvbuf); CHKERRQ(ierr);
+	ierr = ADVReserveBuff(actx, 0, actx->nrecv, 0); CHKERRQ(ierr);
 	ierr = PetscMemzero(actx->recvbuf, (size_t)actx->nrecv*sizeof(Marker)); CHKERRQ(ierr);
 
 	// initialize the random number generator
@@ -1696,7 +1982,8 @@ PetscErrorCode ADVCheckCorners(AdvCtx *actx)
 	ierr = PetscRandomDestroy(&rctx); CHKERRQ(ierr);
 
 	// store new markers
-	actx->ndel = 0;
+	actx->ndel  = 0;
+	actx->tinj += actx->nrecv;
 	ierr = ADVCollectGarbage(actx); CHKERRQ(ierr);
 
 	// compute host cells for all the markers
@@ -1707,8 +1994,9 @@ PetscErrorCode ADVCheckCorners(AdvCtx *actx)
 	PetscPrintf(PETSC_COMM_WORLD,"Marker control [%lld]: (Corners ) injected %lld markers in %1.4e s \n",(LLD)actx->iproc, (LLD)ninj, t1-t0);
 
 	// clear
-	ierr = PetscFree(numcorner);     CHKERRQ(ierr);
-	ierr = PetscFree(actx->recvbuf); CHKERRQ(ierr);
+	ierr = PetscFree(numcorner); CHKERRQ(ierr);
+
+	actx->nrecv = 0;
 
 	PetscFunctionReturn(0);
 }
@@ -1724,16 +2012,10 @@ PetscErrorCode ADVProjHistMarkToGrid(AdvCtx *actx)
 	// - stress       (centers or edges)
 	// - displacement (centers)
 
-	FDSTAG   *fs;
-	JacRes   *jr;
-	PetscInt  ii, jj, numPhases;
-
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	fs        = actx->fs;
-	jr        = actx->jr;
-	numPhases = actx->dbm->numPhases;
+	ierr = PetscLogEventBegin(LaMEM_ProjHistGrid, 0, 0, 0, 0); CHKERRQ(ierr);
 
 	// check marker phases
 	ierr = ADVCheckMarkPhases(actx); CHKERRQ(ierr);
@@ -1748,35 +2030,20 @@ PetscErrorCode ADVProjHistMarkToGrid(AdvCtx *actx)
 	// EDGES
 	//======
 
-	// NOTE: edge phase ratio computation algorithm is the worst possible.
-	// The xy, xz, yz edge points phase ratios are first computed locally,
-	// and then assembled separately for each phase. This step involves
-	// excessive communication, which is proportional to the number of phases.
-
-	// *****************************************
-	// SO PLEASE KEEP NUMBER OF PHASES MINIMIZED
-	// *****************************************
-
-	// compute edge phase ratios (consecutively)
-	for(ii = 0; ii < numPhases; ii++)
-	{
-		ierr = ADVInterpMarkToEdge(actx, ii, _PHASE_); CHKERRQ(ierr);
-	}
-
-	// normalize phase ratios
-	for(jj = 0; jj < fs->nXYEdg; jj++)  { ierr = getPhaseRatio(numPhases, jr->svXYEdge[jj].phRat, &jr->svXYEdge[jj].ws); CHKERRQ(ierr); }
-	for(jj = 0; jj < fs->nXZEdg; jj++)  { ierr = getPhaseRatio(numPhases, jr->svXZEdge[jj].phRat, &jr->svXZEdge[jj].ws); CHKERRQ(ierr); }
-	for(jj = 0; jj < fs->nYZEdg; jj++)  { ierr = getPhaseRatio(numPhases, jr->svYZEdge[jj].phRat, &jr->svYZEdge[jj].ws); CHKERRQ(ierr); }
+	// markers in the upper halves of the last cell layers contribute to the
+	// edges owned by the next domains, copies of these markers (ghosts) are
+	// exchanged once, after that all edge fields are computed locally
 
-	// interpolate history stress to edges
-	ierr = ADVInterpMarkToEdge(actx, 0, _STRESS_); CHKERRQ(ierr);
+	ierr = ADVExchangeGhost(actx); CHKERRQ(ierr);
 
-	// interpolate plastic strain to edges
-	ierr = ADVInterpMarkToEdge(actx, 0, _APS_); CHKERRQ(ierr);
+	// interpolate phase ratios, history stress & plastic strain to edges
+	ierr = ADVInterpMarkToEdge(actx); CHKERRQ(ierr);
 
 	// update phase ratios taking into account actual free surface position
 	ierr = FreeSurfGetAirPhaseRatio(actx->surf); CHKERRQ(ierr);
 
+	ierr = PetscLogEventEnd(LaMEM_ProjHistGrid, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -1896,131 +2163,313 @@ PetscErrorCode ADVInterpMarkToCell(AdvCtx *actx)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode ADVInterpMarkToEdge(AdvCtx *actx, PetscInt iphase, InterpCase icase)
+PetscErrorCode ADVExchangeGhost(AdvCtx *actx)
+{
+	// exchange ghost markers contributing to edges owned by neighbors
+	// Edge nodes on the partition boundaries are owned by the next domain
+	// (DMDA layout), they receive contributions from the upper halves of
+	// the last cell layer of the previous domain (see ADVGetMarkCell).
+	// No ghosts are sent across periodic boundaries (edge layouts are not periodic).
+
+	FDSTAG    *fs;
+	Marker    *P;
+	GhostMark *G;
+	PetscInt   i, k, pass, nx, ny, nz, I, J, K, edge, mx, my, mz, ix, iy, iz;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	fs = actx->fs;
+	nx = fs->dsx.ncels;
+	ny = fs->dsy.ncels;
+	nz = fs->dsz.ncels;
+
+	// clear send counters
+	ierr = PetscMemzero(actx->gsendm, _num_neighb_*sizeof(PetscInt)); CHKERRQ(ierr);
+
+	// count (first pass) and pack (second pass) ghost markers
+	for(pass = 0; pass < 2; pass++)
+	{
+		for(i = 0; i < actx->nummark; i++)
+		{
+			// expand host cell indices
+			GET_CELL_IJK(actx->cellnum[i], I, J, K, nx, ny)
+
+			edge = actx->markedge[i];
+
+			// check upper halves of the last cell layers (except last domains)
+			mx = (I == nx-1 && (edge & 1) && fs->dsx.rank != fs->dsx.nproc-1);
+			my = (J == ny-1 && (edge & 2) && fs->dsy.rank != fs->dsy.nproc-1);
+			mz = (K == nz-1 && (edge & 4) && fs->dsz.rank != fs->dsz.nproc-1);
+
+			if(!mx && !my && !mz) continue;
+
+			P = &actx->markers[i];
+
+			// scan all neighbors in positive directions
+			for(iz = 0; iz <= mz; iz++)
+			for(iy = 0; iy <= my; iy++)
+			for(ix = 0; ix <= mx; ix++)
+			{
+				if(!ix && !iy && !iz) continue;
+
+				k = (ix+1) + 3*(iy+1) + 9*(iz+1);
+
+				if(!pass)
+				{
+					actx->gsendm[k]++;
+					continue;
+				}
+
+				G = &actx->gsendbuf[actx->gptsend[k]++];
+
+				G->X[0]  = P->X[0];
+				G->X[1]  = P->X[1];
+				G->X[2]  = P->X[2];
+				G->S[0]  = P->S.xy;
+				G->S[1]  = P->S.xz;
+				G->S[2]  = P->S.yz;
+				G->APS   = P->APS;
+				G->phase = P->phase;
+				G->mask  = ix | (iy << 1) | (iz << 2);
+			}
+		}
+
+		if(!pass)
+		{
+			// communicate number of ghost markers
+			ierr = MarkExchNum(&actx->mex, actx->gsendm, actx->grecvm); CHKERRQ(ierr);
+
+			// compute buffer pointers
+			k            = getPtrCnt(_num_neighb_, actx->gsendm, actx->gptsend);
+			actx->nghost = getPtrCnt(_num_neighb_, actx->grecvm, actx->gptrecv);
+
+			// reserve buffers
+			ierr = ADVGrowBuff((void**)&actx->gsendbuf, &actx->gsendcap, k,            0, sizeof(GhostMark)); CHKERRQ(ierr);
+			ierr = ADVGrowBuff((void**)&actx->grecvbuf, &actx->grecvcap, actx->nghost, 0, sizeof(GhostMark)); CHKERRQ(ierr);
+		}
+	}
+
+	// rewind send buffer pointers
+	rewindPtr(_num_neighb_, actx->gptsend);
+
+	// communicate ghost markers
+	ierr = MarkExchData(&actx->mex, sizeof(GhostMark),
+		actx->gsendbuf, actx->gsendm, actx->gptsend,
+		actx->grecvbuf, actx->grecvm, actx->gptrecv); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVInterpMarkToEdge(AdvCtx *actx)
 {
 	// marker-to-grid projection (edge nodes)
+	// phase ratios, history stress and plastic strain are computed in a single
+	// pass over local and ghost markers, only owned edges are updated
 
 	FDSTAG      *fs;
 	JacRes      *jr;
 	Marker      *P;
-	PetscScalar  UPXY, UPXZ, UPYZ;
-	PetscInt     nx, ny, sx, sy, sz;
-	PetscInt     jj, ID, I, J, K, II, JJ, KK;
-	PetscScalar *gxy, *gxz, *gyz, ***lxy, ***lxz, ***lyz;
-	PetscScalar  xc, yc, zc, xp, yp, zp, wxc, wyc, wzc, wxn, wyn, wzn;
+	GhostMark   *G;
+	SolVarEdge  *svEdge[3];
+	PetscInt     nEdg[3], cor[18];
+	PetscInt     ii, jj, kk, nx, ny, I, J, K, edge, numPhases;
+	PetscScalar  S[3], ws;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	fs = actx->fs;
-	jr = actx->jr;
+	fs        = actx->fs;
+	jr        = actx->jr;
+	numPhases = actx->dbm->numPhases;
 
-	// starting indices & number of cells
-	sx = fs->dsx.pstart; nx = fs->dsx.ncels;
-	sy = fs->dsy.pstart; ny = fs->dsy.ncels;
-	sz = fs->dsz.pstart;
+	nx = fs->dsx.ncels;
+	ny = fs->dsy.ncels;
 
-	// clear local vectors
-	ierr = VecZeroEntries(jr->ldxy); CHKERRQ(ierr);
-	ierr = VecZeroEntries(jr->ldxz); CHKERRQ(ierr);
-	ierr = VecZeroEntries(jr->ldyz); CHKERRQ(ierr);
+	svEdge[0] = jr->svXYEdge; nEdg[0] = fs->nXYEdg;
+	svEdge[1] = jr->svXZEdge; nEdg[1] = fs->nXZEdg;
+	svEdge[2] = jr->svYZEdge; nEdg[2] = fs->nYZEdg;
 
-	// access 3D layouts of local vectors
-	ierr = DMDAVecGetArray(fs->DA_XY, jr->ldxy, &lxy); CHKERRQ(ierr);
-	ierr = DMDAVecGetArray(fs->DA_XZ, jr->ldxz, &lxz); CHKERRQ(ierr);
-	ierr = DMDAVecGetArray(fs->DA_YZ, jr->ldyz, &lyz); CHKERRQ(ierr);
+	// get corners of edge layouts
+	ierr = DMDAGetCorners(fs->DA_XY, &cor[0],  &cor[1],  &cor[2],  &cor[3],  &cor[4],  &cor[5]);  CHKERRQ(ierr);
+	ierr = DMDAGetCorners(fs->DA_XZ, &cor[6],  &cor[7],  &cor[8],  &cor[9],  &cor[10], &cor[11]); CHKERRQ(ierr);
+	ierr = DMDAGetCorners(fs->DA_YZ, &cor[12], &cor[13], &cor[14], &cor[15], &cor[16], &cor[17]); CHKERRQ(ierr);
 
-	// set interpolated fields to defaults
-	UPXY = 1.0; UPXZ = 1.0; UPYZ = 1.0;
+	// clear edge fields
+	for(kk = 0; kk < 3; kk++)
+	{
+		for(jj = 0; jj < nEdg[kk]; jj++)
+		{
+			for(ii = 0; ii < numPhases; ii++) svEdge[kk][jj].phRat[ii] = 0.0;
 
-	// scan ALL markers
+			svEdge[kk][jj].h         = 0.0;
+			svEdge[kk][jj].svDev.APS = 0.0;
+		}
+	}
+
+	// scan local markers
 	for(jj = 0; jj < actx->nummark; jj++)
 	{
-		// access next marker
 		P = &actx->markers[jj];
 
-		// perform phase ID test
-		if(icase == _PHASE_ && P->phase != iphase) continue;
+		GET_CELL_IJK(actx->cellnum[jj], I, J, K, nx, ny)
 
-		// get consecutive index of the host cell
-		ID = actx->cellnum[jj];
+		S[0] = P->S.xy;
+		S[1] = P->S.xz;
+		S[2] = P->S.yz;
 
-		// expand I, J, K cell indices
-		GET_CELL_IJK(ID, I, J, K, nx, ny)
+		ierr = ADVInterpPointToEdge(actx, cor, P->X, P->phase, S, P->APS, I, J, K, actx->markedge[jj]); CHKERRQ(ierr);
+	}
 
-		// get marker coordinates
-		xp = P->X[0];
-		yp = P->X[1];
-		zp = P->X[2];
+	// scan ghost markers
+	for(jj = 0; jj < actx->nghost; jj++)
+	{
+		G = &actx->grecvbuf[jj];
 
-		// get coordinates of cell center
-		xc = fs->dsx.ccoor[I];
-		yc = fs->dsy.ccoor[J];
-		zc = fs->dsz.ccoor[K];
+		// ghosts are located in the last cell layer of previous domains
+		// (upper half) in the directions of crossed partition boundaries
+		edge = 0;
 
-		// map marker on the control volumes of edge nodes
-		if(xp > xc) { II = I+1; } else { II = I; }
-		if(yp > yc) { JJ = J+1; } else { JJ = J; }
-		if(zp > zc) { KK = K+1; } else { KK = K; }
+		if(G->mask & 1) { I = -1; edge |= 1; } else { ierr = Discret1DFindPoint(&fs->dsx, G->X[0], I); CHKERRQ(ierr); if(G->X[0] > fs->dsx.ccoor[I]) edge |= 1; }
+		if(G->mask & 2) { J = -1; edge |= 2; } else { ierr = Discret1DFindPoint(&fs->dsy, G->X[1], J); CHKERRQ(ierr); if(G->X[1] > fs->dsy.ccoor[J]) edge |= 2; }
+		if(G->mask & 4) { K = -1; edge |= 4; } else { ierr = Discret1DFindPoint(&fs->dsz, G->X[2], K); CHKERRQ(ierr); if(G->X[2] > fs->dsz.ccoor[K]) edge |= 4; }
 
-		// get interpolation weights in cell control volumes
-		wxc = WEIGHT_POINT_CELL(I, xp, fs->dsx);
-		wyc = WEIGHT_POINT_CELL(J, yp, fs->dsy);
-		wzc = WEIGHT_POINT_CELL(K, zp, fs->dsz);
-
-		// get interpolation weights in node control volumes
-		wxn = WEIGHT_POINT_NODE(II, xp, fs->dsx);
-		wyn = WEIGHT_POINT_NODE(JJ, yp, fs->dsy);
-		wzn = WEIGHT_POINT_NODE(KK, zp, fs->dsz);
+		ierr = ADVInterpPointToEdge(actx, cor, G->X, G->phase, G->S, G->APS, I, J, K, edge); CHKERRQ(ierr);
+	}
 
-		if      (icase == _STRESS_) { UPXY = P->S.xy; UPXZ = P->S.xz; UPYZ = P->S.yz; }
-		else if (icase == _APS_)    { UPXY = P->APS;  UPXZ = P->APS;  UPYZ = P->APS;  }
+	// normalize interpolated values
+	for(kk = 0; kk < 3; kk++)
+	{
+		for(jj = 0; jj < nEdg[kk]; jj++)
+		{
+			ierr = getPhaseRatio(numPhases, svEdge[kk][jj].phRat, &ws); CHKERRQ(ierr);
 
-		// update required fields from marker to edge nodes
-		lxy[sz+K ][sy+JJ][sx+II] += wxn*wyn*wzc*UPXY;
-		lxz[sz+KK][sy+J ][sx+II] += wxn*wyc*wzn*UPXZ;
-		lyz[sz+KK][sy+JJ][sx+I ] += wxc*wyn*wzn*UPYZ;
+			svEdge[kk][jj].ws         = ws;
+			svEdge[kk][jj].h         /= ws;
+			svEdge[kk][jj].svDev.APS /= ws;
+		}
 	}
 
-	// restore access
-	ierr = DMDAVecRestoreArray(fs->DA_XY, jr->ldxy, &lxy); CHKERRQ(ierr);
-	ierr = DMDAVecRestoreArray(fs->DA_XZ, jr->ldxz, &lxz); CHKERRQ(ierr);
-	ierr = DMDAVecRestoreArray(fs->DA_YZ, jr->ldyz, &lyz); CHKERRQ(ierr);
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVInterpPointToEdge(
+	AdvCtx      *actx,
+	PetscInt    *cor,
+	PetscScalar *X,
+	PetscInt     phase,
+	PetscScalar *S,
+	PetscScalar  APS,
+	PetscInt     I,
+	PetscInt     J,
+	PetscInt     K,
+	PetscInt     edge)
+{
+	// add contribution of a single point to the owned edges
 
-	// assemble global vectors
-	LOCAL_TO_GLOBAL(fs->DA_XY, jr->ldxy, jr->gdxy)
-	LOCAL_TO_GLOBAL(fs->DA_XZ, jr->ldxz, jr->gdxz)
-	LOCAL_TO_GLOBAL(fs->DA_YZ, jr->ldyz, jr->gdyz)
+	FDSTAG      *fs;
+	JacRes      *jr;
+	SolVarEdge  *sv;
+	PetscInt     II, JJ, KK, gi, gj, gk, gii, gjj, gkk, *c;
+	PetscScalar  wxc, wyc, wzc, wxn, wyn, wzn, w;
+
+	PetscFunctionBeginUser;
 
-	// access 1D layouts of global vectors
-	ierr = VecGetArray(jr->gdxy, &gxy);  CHKERRQ(ierr);
-	ierr = VecGetArray(jr->gdxz, &gxz);  CHKERRQ(ierr);
-	ierr = VecGetArray(jr->gdyz, &gyz);  CHKERRQ(ierr);
+	fs = actx->fs;
+	jr = actx->jr;
 
-	// copy (normalized) data to the residual context
-	if(icase == _PHASE_)
+	// map point on the control volumes of edge nodes
+	II = I + ( edge       & 1);
+	JJ = J + ((edge >> 1) & 1);
+	KK = K + ((edge >> 2) & 1);
+
+	// get interpolation weights in cell control volumes
+	wxc = WEIGHT_POINT_CELL(I, X[0], fs->dsx);
+	wyc = WEIGHT_POINT_CELL(J, X[1], fs->dsy);
+	wzc = WEIGHT_POINT_CELL(K, X[2], fs->dsz);
+
+	// get interpolation weights in node control volumes
+	wxn = WEIGHT_POINT_NODE(II, X[0], fs->dsx);
+	wyn = WEIGHT_POINT_NODE(JJ, X[1], fs->dsy);
+	wzn = WEIGHT_POINT_NODE(KK, X[2], fs->dsz);
+
+	// get global indices
+	gi = fs->dsx.pstart + I; gii = fs->dsx.pstart + II;
+	gj = fs->dsy.pstart + J; gjj = fs->dsy.pstart + JJ;
+	gk = fs->dsz.pstart + K; gkk = fs->dsz.pstart + KK;
+
+	// xy edges
+	c = cor;
+
+	if(gii >= c[0] && gii < c[0]+c[3] && gjj >= c[1] && gjj < c[1]+c[4] && gk >= c[2] && gk < c[2]+c[5])
 	{
-		for(jj = 0; jj < fs->nXYEdg; jj++) jr->svXYEdge[jj].phRat[iphase] = gxy[jj];
-		for(jj = 0; jj < fs->nXZEdg; jj++) jr->svXZEdge[jj].phRat[iphase] = gxz[jj];
-		for(jj = 0; jj < fs->nYZEdg; jj++) jr->svYZEdge[jj].phRat[iphase] = gyz[jj];
+		sv = &jr->svXYEdge[((gk-c[2])*c[4] + (gjj-c[1]))*c[3] + (gii-c[0])];
+		w  = wxn*wyn*wzc;
+
+		sv->phRat[phase] += w;
+		sv->h            += w*S[0];
+		sv->svDev.APS    += w*APS;
 	}
-	else if(icase == _STRESS_)
+
+	// xz edges
+	c = cor + 6;
+
+	if(gii >= c[0] && gii < c[0]+c[3] && gj >= c[1] && gj < c[1]+c[4] && gkk >= c[2] && gkk < c[2]+c[5])
 	{
-		for(jj = 0; jj < fs->nXYEdg; jj++) jr->svXYEdge[jj].h = gxy[jj]/jr->svXYEdge[jj].ws;
-		for(jj = 0; jj < fs->nXZEdg; jj++) jr->svXZEdge[jj].h = gxz[jj]/jr->svXZEdge[jj].ws;
-		for(jj = 0; jj < fs->nYZEdg; jj++) jr->svYZEdge[jj].h = gyz[jj]/jr->svYZEdge[jj].ws;
+		sv = &jr->svXZEdge[((gkk-c[2])*c[4] + (gj-c[1]))*c[3] + (gii-c[0])];
+		w  = wxn*wyc*wzn;
+
+		sv->phRat[phase] += w;
+		sv->h            += w*S[1];
+		sv->svDev.APS    += w*APS;
 	}
-	else if(icase == _APS_)
+
+	// yz edges
+	c = cor + 12;
+
+	if(gi >= c[0] && gi < c[0]+c[3] && gjj >= c[1] && gjj < c[1]+c[4] && gkk >= c[2] && gkk < c[2]+c[5])
 	{
-		for(jj = 0; jj < fs->nXYEdg; jj++) jr->svXYEdge[jj].svDev.APS = gxy[jj]/jr->svXYEdge[jj].ws;
-		for(jj = 0; jj < fs->nXZEdg; jj++) jr->svXZEdge[jj].svDev.APS = gxz[jj]/jr->svXZEdge[jj].ws;
-		for(jj = 0; jj < fs->nYZEdg; jj++) jr->svYZEdge[jj].svDev.APS = gyz[jj]/jr->svYZEdge[jj].ws;
+		sv = &jr->svYZEdge[((gkk-c[2])*c[4] + (gjj-c[1]))*c[3] + (gi-c[0])];
+		w  = wxc*wyn*wzn;
+
+		sv->phRat[phase] += w;
+		sv->h            += w*S[2];
+		sv->svDev.APS    += w*APS;
 	}
 
-	// restore access
-	ierr = VecRestoreArray(jr->gdxy, &gxy); CHKERRQ(ierr);
-	ierr = VecRestoreArray(jr->gdxz, &gxz); CHKERRQ(ierr);
-	ierr = VecRestoreArray(jr->gdyz, &gyz); CHKERRQ(ierr);
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVGetEdgeIncrement(DM da, Vec lv, SolVarEdge *svEdge, InterpCase icase)
+{
+	// copy edge history increments to local edge vectors
+	// (owned values are set directly, boundary values are communicated)
+
+	PetscInt      i, j, k, nx, ny, nz, sx, sy, sz, iter;
+	PetscScalar ***l, d;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = DMDAVecGetArray(da, lv, &l); CHKERRQ(ierr);
+
+	ierr = DMDAGetCorners(da, &sx, &sy, &sz, &nx, &ny, &nz); CHKERRQ(ierr);
+
+	iter = 0;
+
+	START_STD_LOOP
+	{
+		if     (icase == _STRESS_) l[k][j][i] = svEdge[iter].s - svEdge[iter].h;
+		else if(icase == _APS_)    l[k][j][i] = svEdge[iter].svDev.PSR;
+		else if(icase == _ATS_)  { d = svEdge[iter].d; l[k][j][i] = d*d; }
+
+		iter++;
+	}
+	END_STD_LOOP
+
+	ierr = DMDAVecRestoreArray(da, lv, &l); CHKERRQ(ierr);
+
+	LOCAL_TO_LOCAL(da, lv)
 
 	PetscFunctionReturn(0);
 }
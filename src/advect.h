@@ -16,6 +16,7 @@
 
 #include "Tensor.h" // required for Marker declaration
 #include "passive_tracer.h"
+#include "exchange.h" // required for MarkExch declaration
 //---------------------------------------------------------------------------
 
 struct FB;
@@ -23,6 +24,8 @@ struct FDSTAG;
 struct JacRes;
 struct FreeSurf;
 struct DBMat;
+struct SolVarEdge;
+struct VelHalo;
 
 //---------------------------------------------------------------------------
 //............   Material marker (history variables advection)   ............
@@ -47,12 +50,26 @@ PetscErrorCode MarkerMerge(Marker &A, Marker &B, Marker &C);
 
 //---------------------------------------------------------------------------
 
+// Ghost marker (copy of a marker that contributes to edges owned by a neighbor).
+// Only the fields projected on the edges are communicated.
+
+struct GhostMark
+{
+	PetscScalar X[3];  // global coordinates
+	PetscScalar S[3];  // deviatoric shear stress (xy, xz, yz)
+	PetscScalar APS;   // accumulated plastic strain
+	PetscInt    phase; // phase identifier
+	PetscInt    mask;  // partition boundaries crossed (bit 0/1/2: x/y/z)
+};
+
+//---------------------------------------------------------------------------
+
 // marker initialization type enumeration
 enum SetupType
 {
 	_GEOM_,    // read geometric primitives from input file
 	_FILES_,   // read coordinates, phase and temperature from files in parallel
-	_POLYGONS_ // read polygons from file redundantly
+	_POLYGONS_ // read polygons from file, every rank reads only its local marker planes
 
 };
 
@@ -78,6 +95,7 @@ enum AdvectionType
 	BASIC_EULER,    // basic Euler implementation (STAG interpolation only)
 	EULER,          // Euler explicit in time
 	RUNGE_KUTTA_2,  // Runge-Kutta 2nd order in space
+	RUNGE_KUTTA_4,  // Runge-Kutta 4th order in space
 };
 
 //-----------------------------------------------------------------------------
@@ -151,6 +169,7 @@ struct AdvCtx
 	// RUN TIME PARAMETERS
 	//====================
 	PetscInt    cinj, cdel;       // injected & deleted marker counters
+	PetscInt    tinj, tdel;       // total injected & deleted markers (performance log)
 	PetscInt    nmin, nmax;       // minimum and maximum number of markers per cell
 	PetscInt    avdx, avdy, avdz; // AVD cells refinement factors
 	PetscInt    npmax;            // maximum number of same phase markers per subcell
@@ -161,6 +180,7 @@ struct AdvCtx
 	MPI_Comm  icomm;   // distinct communicator for communicating markers
 	PetscInt  nproc;   // total number of processors
 	PetscInt  iproc;   // processor rank
+	MarkExch  mex;     // neighbor exchange engine (graph communicator)
 
 	//========
 	// STORAGE
@@ -174,6 +194,8 @@ struct AdvCtx
 	// MARKER-CELL INTERACTION
 	//========================
 	PetscInt *cellnum;    // host cells local number for each marker
+	PetscInt *markedge;   // edge control volume shift flags for each marker (bit 0/1/2: x/y/z above cell center)
+	PetscBool cellmap;    // flag to keep host cells and shift flags up to date in garbage collection
 	PetscInt *markind;    // id (position) of markers clustered for every cell
 	PetscInt *markstart;  // start id in markind for every cell
 
@@ -194,6 +216,41 @@ struct AdvCtx
 	PetscInt  ndel; // number of markers to be deleted from storage
 	PetscInt *idel; // indices of markers to be deleted
 
+	// buffers are persistent, they grow on demand and are reused between steps
+	PetscInt  sendcap; // capacity of send buffer
+	PetscInt  recvcap; // capacity of receive (injection) buffer
+	PetscInt  delcap;  // capacity of deleted marker indices buffer
+
+	//============
+	// GHOST LAYER
+	//============
+	GhostMark *gsendbuf;              // ghost marker send buffer
+	GhostMark *grecvbuf;              // ghost marker receive buffer
+	PetscInt   gsendcap;              // capacity of ghost send buffer
+	PetscInt   grecvcap;              // capacity of ghost receive buffer
+	PetscInt   nghost;                // number of received ghost markers
+	PetscInt   gsendm[_num_neighb_];  // number of ghost markers sent to each process
+	PetscInt   gptsend[_num_neighb_]; // ghost send buffer pointers
+	PetscInt   grecvm[_num_neighb_];  // number of ghost markers received from each process
+	PetscInt   gptrecv[_num_neighb_]; // ghost receive buffer pointers
+
+	//==============
+	// VELOCITY HALO
+	//==============
+	VelHalo   *halo;                  // wide velocity halo for Runge-Kutta stages (allocated on demand)
+
+	//=============
+	// PACKED LAYOUT
+	//=============
+	PetscInt   compact;               // flag for compact marker record in exchange & restart
+	PetscInt   packATS;               // flag for packing accumulated total strain (set from output flags)
+	PetscInt   packU;                 // flag for packing displacement (set from output flags)
+	size_t     packsz;                // size of compact marker record (bytes)
+	char      *packsend;              // packed send buffer
+	char      *packrecv;              // packed receive buffer
+	PetscInt   packsendcap;           // capacity of packed send buffer (records)
+	PetscInt   packrecvcap;           // capacity of packed receive buffer (records)
+
 };
 
 //---------------------------------------------------------------------------
@@ -208,6 +265,11 @@ PetscErrorCode ADVReadRestart(AdvCtx *actx, FILE *fp);
 // read advection object from restart database
 PetscErrorCode ADVWriteRestart(AdvCtx *actx, FILE *fp);
 
+// read/write compact marker records from/to restart file
+PetscErrorCode ADVReadPackMark (AdvCtx *actx, FILE *fp);
+
+PetscErrorCode ADVWritePackMark(AdvCtx *actx, FILE *fp);
+
 // create communicator and separator
 PetscErrorCode ADVCreateData(AdvCtx *actx);
 
@@ -259,17 +321,63 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx);
 // free communication buffer
 PetscErrorCode ADVDestroyMPIBuff(AdvCtx *actx);
 
+// grow persistent buffer to hold at least n entries, preserve first nkeep entries
+PetscErrorCode ADVGrowBuff(void **buff, PetscInt *cap, PetscInt n, PetscInt nkeep, size_t size);
+
+// compute size of compact marker record
+size_t ADVGetPackSize(AdvCtx *actx);
+
+// pack marker to compact record (double coordinates, short phase, float history)
+void ADVPackMark(AdvCtx *actx, Marker *P, char *rec);
+
+// unpack marker from compact record (omitted fields are set to zero)
+void ADVUnpackMark(AdvCtx *actx, char *rec, Marker *P);
+
+// reserve persistent exchange, injection and deletion buffers
+PetscErrorCode ADVReserveBuff(AdvCtx *actx, PetscInt nsend, PetscInt nrecv, PetscInt ndel);
+
+// append marker to injection buffer
+PetscErrorCode ADVPushMark(AdvCtx *actx, Marker *P);
+
+// append marker index to deletion buffer
+PetscErrorCode ADVPushDel(AdvCtx *actx, PetscInt ind);
+
 // store host cell ID for every marker & list of marker IDs in every cell
 PetscErrorCode ADVMapMarkToCells(AdvCtx *actx);
 
+// list marker IDs in every cell from stored host cell IDs
+PetscErrorCode ADVGetMarkCellList(AdvCtx *actx);
+
+// get host cell ID and edge control volume shift flags of a single marker
+PetscErrorCode ADVGetMarkCell(AdvCtx *actx, Marker *P, PetscInt *ID, PetscInt *edge);
+
 // project history fields from markers to grid
 PetscErrorCode ADVProjHistMarkToGrid(AdvCtx *actx);
 
 // marker-to-cell projection
 PetscErrorCode ADVInterpMarkToCell(AdvCtx *actx);
 
-// marker-to-edge projection
-PetscErrorCode ADVInterpMarkToEdge(AdvCtx *actx, PetscInt iphase, InterpCase icase);
+// exchange ghost markers contributing to edges owned by neighbors
+PetscErrorCode ADVExchangeGhost(AdvCtx *actx);
+
+// marker-to-edge projection (all phases & history fields)
+PetscErrorCode ADVInterpMarkToEdge(AdvCtx *actx);
+
+// add contribution of a single point to the owned edges
+PetscErrorCode ADVInterpPointToEdge(
+	AdvCtx      *actx,
+	PetscInt    *cor,   // corners of edge layouts (xy, xz, yz)
+	PetscScalar *X,     // coordinates
+	PetscInt     phase, // phase identifier
+	PetscScalar *S,     // deviatoric shear stress (xy, xz, yz)
+	PetscScalar  APS,   // accumulated plastic strain
+	PetscInt     I,     // host cell indices
+	PetscInt     J,
+	PetscInt     K,
+	PetscInt     edge); // edge control volume shift flags
+
+// copy edge history increments to local edge vectors
+PetscErrorCode ADVGetEdgeIncrement(DM da, Vec lv, SolVarEdge *svEdge, InterpCase icase);
 
 // inject or delete markers
 PetscErrorCode ADVMarkControl(AdvCtx *actx);
@@ -562,6 +562,125 @@ PetscScalar getConsEqRes(PetscScalar eta, void *pctx)
 	return ctx->DII - (DIIels + DIIdif + DIImax + DIIdis + DIIprl + DIIfk);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode devConstEqCreepDerivative(
+		ConstEqCtx  *ctx,    // evaluation context
+		PetscInt     npar,   // number of parameters
+		PetscInt    *phs,    // phase of each parameter (grouped by phase)
+		PetscScalar *dlnBd,  // derivatives of log(Bd) with respect to parameters
+		PetscScalar *dlnBn,  // derivatives of log(Bn) with respect to parameters
+		PetscScalar *dn,     // derivatives of power-law exponent with respect to parameters
+		PetscScalar *deta)   // derivatives of effective viscosity (output)
+{
+	// compute derivatives of effective viscosity in control volume with respect
+	// to diffusion & dislocation creep parameters at fixed strain rate
+	// Phase stress is the root of F(tau) = sum(A_m*tau^N_m) - DII, therefore
+	// (implicit function theorem):
+	// dlog(eta)/dp = dlog(tau)/dp = -(dF/dp)/(sum(N_m*D_m) + tau/eta_vp/2),
+	// where D_m = A_m*tau^N_m are the strain rates of individual mechanisms.
+	// Last term only applies if regularized plasticity is active.
+	// Viscosity does not depend on creep parameters at non-regularized yield.
+	// NOTE: phase viscosity is only re-evaluated if the phase changes
+
+	Controls    *ctrl;
+	Material_t  *mat;
+	PetscInt     ii, ID, act;
+	PetscScalar  phRat, eta, tauII, lntau, mf, DIIdif, DIIdis, DIIsum, dFdp;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// access context
+	ctrl  = ctx->ctrl;
+
+	// initialize
+	ID     = -1;
+	act    =  0;
+	mat    = NULL;
+	eta    = 0.0;
+	lntau  = 0.0;
+	mf     = 0.0;
+	DIIdif = 0.0;
+	DIIdis = 0.0;
+	DIIsum = 0.0;
+
+	for(ii = 0; ii < npar; ii++)
+	{
+		deta[ii] = 0.0;
+
+		phRat = ctx->phRat[phs[ii]];
+
+		// skip absent phases & viscous initial guess
+		if(!phRat || !ctx->DII || ctrl->initGuess) continue;
+
+		if(phs[ii] != ID)
+		{
+			ID  = phs[ii];
+			mat = ctx->phases + ID;
+
+			// setup phase parameters
+			ierr = setUpPhase(ctx, ID); CHKERRQ(ierr);
+
+			// compute phase viscosity (results are accumulated in context)
+			ctx->eta    = 0.0;
+			ctx->eta_cr = 0.0;
+			ctx->DIIdif = 0.0;
+			ctx->DIIdis = 0.0;
+			ctx->DIIprl = 0.0;
+			ctx->DIIfk  = 0.0;
+			ctx->DIIpl  = 0.0;
+			ctx->yield  = 0.0;
+
+			ierr = getPhaseVisc(ctx, ID); CHKERRQ(ierr);
+
+			// get phase viscosity & stress
+			eta   = ctx->eta/phRat;
+			tauII = 2.0*eta*ctx->DII;
+			lntau = log(tauII);
+
+			// creep strain rates & linearization of the constitutive equation
+			DIIdif = ctx->A_dif*tauII;
+			DIIdis = ctx->A_dis*pow(tauII, ctx->N_dis);
+			DIIsum = (ctx->A_els + ctx->A_dif + ctx->A_max + ctx->A_fk)*tauII
+			+        ctx->N_dis*DIIdis
+			+        ctx->N_prl*ctx->A_prl*pow(tauII, ctx->N_prl);
+
+			act = 1;
+
+			if(ctx->DIIpl)
+			{
+				if(ctx->eta_vp) DIIsum += tauII/ctx->eta_vp/2.0;
+				else            act     = 0;
+			}
+
+			if(!DIIsum) act = 0;
+
+			// melt fraction correction of dislocation creep depends on exponent (see setUpPhase)
+			mf = 0.0;
+
+			if(mat->pdAct == 1)
+			{
+				mf = ctx->Pd->mf;
+
+				if(mf > ctrl->mfmax) mf = ctrl->mfmax;
+			}
+		}
+
+		if(!act) continue;
+
+		dFdp = 0.0;
+
+		// diffusion creep (A_dif = Bd*exp(-Q)*mfd)
+		if(mat->Bd) dFdp += dlnBd[ii]*DIIdif;
+
+		// dislocation creep (A_dis = Bn*exp(-Q)*mfn, N_dis = n)
+		if(mat->Bn) dFdp += (dlnBn[ii] + dn[ii]*(mat->mfc*mf + lntau))*DIIdis;
+
+		deta[ii] = -phRat*eta*dFdp/DIIsum;
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscScalar applyStrainSoft(
 		Soft_t      *soft, // material softening laws
 		PetscInt     ID,   // softening law ID
@@ -760,6 +879,94 @@ PetscErrorCode volConstEq(ConstEqCtx *ctx)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode volConstEqDensityDerivative(ConstEqCtx *ctx, PetscScalar *drho)
+{
+	// compute derivatives of effective density in control volume with respect
+	// to reference densities of all phases (drho[i] = d(rho_eff)/d(rho_i))
+	// NOTE: effective density is linear in reference phase densities,
+	// therefore derivatives only depend on pressure, temperature and depth
+	Controls    *ctrl;
+	PData       *Pd;
+	Material_t  *mat, *phases;
+	PetscInt     i, numPhases;
+	PetscScalar *phRat, p, depth, T, cf_comp, cf_therm;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// access context
+	ctrl      = ctx->ctrl;
+	Pd        = ctx->Pd;
+	numPhases = ctx->numPhases;
+	phases    = ctx->phases;
+	phRat     = ctx->phRat;
+	depth     = ctx->depth;
+	p         = ctx->p;
+	T         = ctx->T;
+
+	p         = p+ctrl->pShift;
+
+	// scan all phases
+	for(i = 0; i < numPhases; i++)
+	{
+		drho[i] = 0.0;
+
+		// update present phases only
+		if(phRat[i])
+		{
+			// get reference to material parameters table
+			mat = &phases[i];
+
+			// initialize
+			cf_comp  = 1.0;
+			cf_therm = 1.0;
+
+			// elastic compressibility correction (see volConstEq)
+			if(mat->Kb)
+			{
+				if(mat->Kp) cf_comp = pow(1.0 + mat->Kp*(p/mat->Kb), 1.0/mat->Kp);
+				else        cf_comp = 1.0 + p/mat->Kb;
+			}
+
+			if(mat->beta)
+			{
+				cf_comp = 1.0 + p*mat->beta;
+			}
+
+			// thermal expansion correction
+			if(mat->alpha)
+			{
+				cf_therm  = 1.0 - mat->alpha*(T - ctrl->TRef);
+			}
+
+			if(mat->rho_n)
+			{
+				// depth-dependent density (ad-hoc)
+				drho[i] = phRat[i]*(1.0 - mat->rho_n*exp(-mat->rho_c*depth));
+			}
+			else if(mat->pdAct == 1 && !mat->Phase_Diagram_melt)
+			{
+				// density is fully defined by phase diagram
+				drho[i] = 0.0;
+			}
+			else if(mat->pdAct == 1 && mat->Phase_Diagram_melt)
+			{
+				// compute melt fraction from phase diagram
+				ierr = setDataPhaseDiagram(Pd, p, T, mat->pdn); CHKERRQ(ierr);
+
+				drho[i] = phRat[i]*(1.0 - Pd->mf)*cf_comp*cf_therm;
+			}
+			else
+			{
+				// temperature & pressure-dependent density
+				drho[i] = phRat[i]*cf_comp*cf_therm;
+			}
+		}
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode cellConstEq(
 		ConstEqCtx  *ctx,    // evaluation context
 		SolVarCell  *svCell, // solution variables
@@ -829,6 +1036,9 @@ PetscErrorCode cellConstEq(
 	// compute total viscosity
 	svDev->eta = ctx->eta + eta_st;
 
+	// store effective strain rate
+	svDev->DII = ctx->DII;
+
 	// get total pressure (effective pressure + pore pressure)
 	ptotal = ctx->p + ctrl->biot*ctx->p_pore;
 
@@ -915,6 +1125,9 @@ PetscErrorCode edgeConstEq(
 	// compute total viscosity
 	svDev->eta = ctx->eta + eta_st;
 
+	// store effective strain rate
+	svDev->DII = ctx->DII;
+
 	// compute total stress
 	s += svEdge->s;
 
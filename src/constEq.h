@@ -119,6 +119,16 @@ PetscErrorCode getPhaseVisc(ConstEqCtx *ctx, PetscInt ID);
 // compute residual of the visco-elastic constitutive equation
 PetscScalar getConsEqRes(PetscScalar eta, void *pctx);
 
+// compute derivatives of effective viscosity with respect to creep parameters
+PetscErrorCode devConstEqCreepDerivative(
+	ConstEqCtx  *ctx,    // evaluation context
+	PetscInt     npar,   // number of parameters
+	PetscInt    *phs,    // phase of each parameter (grouped by phase)
+	PetscScalar *dlnBd,  // derivatives of log(Bd) with respect to parameters
+	PetscScalar *dlnBn,  // derivatives of log(Bn) with respect to parameters
+	PetscScalar *dn,     // derivatives of power-law exponent with respect to parameters
+	PetscScalar *deta);  // derivatives of effective viscosity (output)
+
 // apply strain softening to a parameter (friction, cohesion)
 PetscScalar applyStrainSoft(
 		Soft_t      *soft, // material softening laws
@@ -137,6 +147,9 @@ PetscScalar getI2Gdt(
 // evaluate volumetric constitutive equations in control volume
 PetscErrorCode volConstEq(ConstEqCtx *ctx);
 
+// compute derivatives of effective density with respect to reference phase densities
+PetscErrorCode volConstEqDensityDerivative(ConstEqCtx *ctx, PetscScalar *drho);
+
 // evaluate constitutive equations on the cell
 PetscErrorCode cellConstEq(
 		ConstEqCtx  *ctx,    // evaluation context
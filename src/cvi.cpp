@@ -127,6 +127,14 @@ PetscErrorCode ADVelAdvectScheme(AdvCtx *actx, AdvVelCtx *vi)
 	// create context
 	ierr = ADVelCreate(actx, vi); CHKERRQ(ierr);
 
+	// update velocity halo (Runge-Kutta stages with STAG interpolation)
+	if((actx->advect == RUNGE_KUTTA_2 || actx->advect == RUNGE_KUTTA_4) && actx->interp == STAG)
+	{
+		ierr = ADVelHaloUpdate(actx); CHKERRQ(ierr);
+
+		vi->halo = actx->halo;
+	}
+
 	// initialize marker positions
 	ierr = ADVelInitCoord(actx, vi->interp, vi->nmark); CHKERRQ(ierr);
 
@@ -164,7 +172,38 @@ PetscErrorCode ADVelAdvectScheme(AdvCtx *actx, AdvVelCtx *vi)
 
 		// needed for mapping between vi and actx in parallel
 		ierr = ADVelResetCoord(vi->interp, vi->nmark); CHKERRQ(ierr);
-		ierr = ADVelExchange(vi); CHKERRQ(ierr);
+
+		if(!vi->halo)
+		{
+			ierr = ADVelExchange(vi); CHKERRQ(ierr);
+		}
+
+		// final position
+		ierr = ADVelAdvectCoord(vi->interp, vi->nmark, dt, 1); CHKERRQ(ierr);
+	}
+
+	// ---------------------------------
+	// Runge-Kutta 4th order in space
+	// ---------------------------------
+	else if(actx->advect == RUNGE_KUTTA_4)
+	{
+		// velocity interpolation A
+		ierr = ADVelInterpMain(vi); CHKERRQ(ierr);
+
+		ierr = ADVelCalcEffVel(vi->interp, vi->nmark, 1.0/6.0); CHKERRQ(ierr);
+
+		// Runge-Kutta steps to B, C, D
+		ierr = ADVelRungeKuttaStep(vi, dt/2, 1.0/3.0, 0); CHKERRQ(ierr);
+		ierr = ADVelRungeKuttaStep(vi, dt/2, 1.0/3.0, 0); CHKERRQ(ierr);
+		ierr = ADVelRungeKuttaStep(vi, dt,   1.0/6.0, 0); CHKERRQ(ierr);
+
+		// needed for mapping between vi and actx in parallel
+		ierr = ADVelResetCoord(vi->interp, vi->nmark); CHKERRQ(ierr);
+
+		if(!vi->halo)
+		{
+			ierr = ADVelExchange(vi); CHKERRQ(ierr);
+		}
 
 		// final position
 		ierr = ADVelAdvectCoord(vi->interp, vi->nmark, dt, 1); CHKERRQ(ierr);
@@ -184,8 +223,9 @@ PetscErrorCode ADVelAdvectScheme(AdvCtx *actx, AdvVelCtx *vi)
 	ierr = ADVCollectGarbage(actx); CHKERRQ(ierr);
 
 	// clear memory
-	ierr = ADVelDestroy(vi);      CHKERRQ(ierr);
-	ierr = PetscFree(actx->idel); CHKERRQ(ierr);
+	ierr = ADVelDestroy(vi); CHKERRQ(ierr);
+
+	actx->ndel = 0;
 
 	PetscFunctionReturn(0);
 }
@@ -203,8 +243,11 @@ PetscErrorCode ADVelRungeKuttaStep(AdvVelCtx *vi, PetscScalar dt, PetscScalar a,
 	// 2. Delete marker outflow if it happens
 	ierr = ADVelDeleteOutflow(vi); CHKERRQ(ierr);
 
-	// 3. Exchange markers for interpolation
-	ierr = ADVelExchange(vi); CHKERRQ(ierr);
+	// 3. Exchange markers for interpolation (not required within velocity halo)
+	if(!vi->halo)
+	{
+		ierr = ADVelExchange(vi); CHKERRQ(ierr);
+	}
 
 	// 4. Velocity Interpolation
 	ierr = ADVelInterpMain(vi); CHKERRQ(ierr);
@@ -232,6 +275,8 @@ PetscErrorCode ADVelCreate(AdvCtx *actx, AdvVelCtx *vi)
 	vi->icomm = actx->icomm;
 	vi->nproc = actx->nproc;
 	vi->iproc = actx->iproc;
+	vi->mex   = &actx->mex;
+	vi->halo  = NULL;
 
 	//========
 	// STORAGE
@@ -256,6 +301,9 @@ PetscErrorCode ADVelCreate(AdvCtx *actx, AdvVelCtx *vi)
 	//=========
 	vi->sendbuf = NULL;
 	vi->recvbuf = NULL;
+	vi->sendcap = 0;
+	vi->recvcap = 0;
+	vi->delcap  = 0;
 
 	vi->nsend = 0;
 	ierr = PetscMemzero(vi->nsendm, _num_neighb_*sizeof(PetscInt)); CHKERRQ(ierr);
@@ -450,8 +498,8 @@ PetscErrorCode ADVelCollectIndices(AdvCtx *actx, AdvVelCtx *vi)
 	// if no need for injection/deletion
 	if (!actx->ndel) PetscFunctionReturn(0);
 
-	// allocate storage
-	if(actx->ndel) { ierr = PetscMalloc((size_t)actx->ndel *sizeof(PetscInt), &actx->idel); CHKERRQ(ierr); }
+	// reserve storage
+	ierr = ADVReserveBuff(actx, 0, 0, actx->ndel); CHKERRQ(ierr);
 
 	// allocate storage for mapping
 	ierr = PetscMalloc((size_t)actx->nummark*sizeof(PetscInt), &p); CHKERRQ(ierr);
@@ -506,8 +554,8 @@ PetscErrorCode ADVelDeleteOutflow(AdvVelCtx *vi)
 	// save points to exclude
 	vi->ndel    = ndel;
 
-	// allocate storage
-	ierr = PetscMalloc((size_t)ndel *sizeof(PetscInt), &vi->idel); CHKERRQ(ierr);
+	// reserve storage
+	ierr = ADVGrowBuff((void**)&vi->idel, &vi->delcap, ndel, 0, sizeof(PetscInt)); CHKERRQ(ierr);
 
 	// save markers indices to be deleted
 	for(i = 0, ndel = 0; i < vi->nmark; i++)
@@ -525,8 +573,7 @@ PetscErrorCode ADVelDeleteOutflow(AdvVelCtx *vi)
 	// delete outside markers
 	ierr = ADVelCollectGarbage(vi); CHKERRQ(ierr);
 
-	// clear
-	ierr = PetscFree(vi->idel); CHKERRQ(ierr);
+	vi->ndel = 0;
 
 	PetscFunctionReturn(0);
 }
@@ -571,45 +618,10 @@ PetscErrorCode ADVelExchangeNMark(AdvVelCtx *vi)
 {
 	// communicate number of markers with neighbor processes
 
-	FDSTAG     *fs;
-	PetscInt    k;
-	PetscMPIInt scnt, rcnt;
-	MPI_Request srequest[_num_neighb_];
-	MPI_Request rrequest[_num_neighb_];
-
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	fs = vi->fs;
-
-	// zero out message counters
-	scnt = 0;
-	rcnt = 0;
-
-	// send number of markers to ALL neighbor processes (except self & non-existing)
-	for(k = 0; k < _num_neighb_; k++)
-	{
-		if(fs->neighb[k] != vi->iproc && fs->neighb[k] != -1)
-		{
-			ierr = MPI_Isend(&vi->nsendm[k], 1, MPIU_INT,
-					fs->neighb[k], 100, vi->icomm, &srequest[scnt++]); CHKERRQ(ierr);
-		}
-	}
-
-	// receive number of markers from ALL neighbor processes (except self & non-existing)
-	for(k = 0; k < _num_neighb_; k++)
-	{
-		if(fs->neighb[k] != vi->iproc && fs->neighb[k] != -1)
-		{
-			ierr = MPI_Irecv(&vi->nrecvm[k], 1, MPIU_INT,
-					fs->neighb[k], 100, vi->icomm, &rrequest[rcnt++]); CHKERRQ(ierr);
-		}
-		else vi->nrecvm[k] = 0;
-	}
-
-	// wait until all communication processes have been terminated
-	if(scnt) { ierr = MPI_Waitall(scnt, srequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
-	if(rcnt) { ierr = MPI_Waitall(rcnt, rrequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
+	ierr = MarkExchNum(vi->mex, vi->nsendm, vi->nrecvm); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -631,14 +643,10 @@ PetscErrorCode ADVelCreateMPIBuff(AdvVelCtx *vi)
 	vi->nsend = getPtrCnt(_num_neighb_, vi->nsendm, vi->ptsend);
 	vi->nrecv = getPtrCnt(_num_neighb_, vi->nrecvm, vi->ptrecv);
 
-	vi->sendbuf = NULL;
-	vi->recvbuf = NULL;
-	vi->idel    = NULL;
-
-	// allocate exchange buffers & array of deleted (sent) marker indices
-	if(vi->nsend) { ierr = PetscMalloc((size_t)vi->nsend*sizeof(VelInterp), &vi->sendbuf); CHKERRQ(ierr); }
-	if(vi->nrecv) { ierr = PetscMalloc((size_t)vi->nrecv*sizeof(VelInterp), &vi->recvbuf); CHKERRQ(ierr); }
-	if(vi->ndel)  { ierr = PetscMalloc((size_t)vi->ndel *sizeof(PetscInt ), &vi->idel);    CHKERRQ(ierr); }
+	// reserve exchange buffers & array of deleted (sent) marker indices
+	ierr = ADVGrowBuff((void**)&vi->sendbuf, &vi->sendcap, vi->nsend, 0, sizeof(VelInterp)); CHKERRQ(ierr);
+	ierr = ADVGrowBuff((void**)&vi->recvbuf, &vi->recvcap, vi->nrecv, 0, sizeof(VelInterp)); CHKERRQ(ierr);
+	ierr = ADVGrowBuff((void**)&vi->idel,    &vi->delcap,  vi->ndel,  0, sizeof(PetscInt));  CHKERRQ(ierr);
 
 	// copy markers to send buffer, store their indices
 	for(i = 0, cnt = 0; i < vi->nmark; i++)
@@ -666,64 +674,22 @@ PetscErrorCode ADVelExchangeMark(AdvVelCtx *vi)
 {
 	// communicate markers with neighbor processes
 
-	FDSTAG     *fs;
-	PetscInt    k;
-	PetscMPIInt scnt, rcnt, nbyte;
-	MPI_Request srequest[_num_neighb_];
-	MPI_Request rrequest[_num_neighb_];
-
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	fs = vi->fs;
-
-	// zero out message counters
-	scnt = 0;
-	rcnt = 0;
-
-	// send packages (if any) with markers to neighbor processes
-	for(k = 0; k < _num_neighb_; k++)
-	{
-		if(vi->nsendm[k])
-		{
-			nbyte = (PetscMPIInt)(vi->nsendm[k]*(PetscInt)sizeof(VelInterp));
-
-			ierr = MPI_Isend(&vi->sendbuf[vi->ptsend[k]], nbyte, MPI_BYTE,
-					fs->neighb[k], 200, vi->icomm, &srequest[scnt++]); CHKERRQ(ierr);
-
-		}
-	}
-
-	// receive packages (if any) with markers from neighbor processes
-	for(k = 0; k < _num_neighb_; k++)
-	{
-		if(vi->nrecvm[k])
-		{
-			nbyte = (PetscMPIInt)(vi->nrecvm[k]*(PetscInt)sizeof(VelInterp));
-
-			ierr = MPI_Irecv(&vi->recvbuf[vi->ptrecv[k]], nbyte, MPI_BYTE,
-					fs->neighb[k], 200, vi->icomm, &rrequest[rcnt++]); CHKERRQ(ierr);
-		}
-	}
-
-	// wait until all communication processes have been terminated
-	if(scnt) { ierr = MPI_Waitall(scnt, srequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
-	if(rcnt) { ierr = MPI_Waitall(rcnt, rrequest, MPI_STATUSES_IGNORE); CHKERRQ(ierr); }
+	ierr = MarkExchData(vi->mex, sizeof(VelInterp),
+		vi->sendbuf, vi->nsendm, vi->ptsend,
+		vi->recvbuf, vi->nrecvm, vi->ptrecv); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
 PetscErrorCode ADVelDestroyMPIBuff(AdvVelCtx *vi)
 {
-	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	// destroy buffers
-	ierr = PetscFree(vi->sendbuf); CHKERRQ(ierr);
-	ierr = PetscFree(vi->recvbuf); CHKERRQ(ierr);
-	ierr = PetscFree(vi->idel);  	 CHKERRQ(ierr);
-
-	// reset values
+	// buffers are kept for the next exchange (released in ADVelDestroy), reset values
+	vi->nsend = 0;
 	vi->nrecv = 0;
 	vi->ndel  = 0;
 
@@ -913,7 +879,8 @@ PetscErrorCode ADVelInterpMain(AdvVelCtx *vi)
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
-	if     (vi->actx->interp == STAG   )  { ierr = ADVelInterpSTAG   (vi); CHKERRQ(ierr); }
+	if     (vi->halo)                     { ierr = ADVelInterpHalo   (vi); CHKERRQ(ierr); }
+	else if(vi->actx->interp == STAG   )  { ierr = ADVelInterpSTAG   (vi); CHKERRQ(ierr); }
 	else if(vi->actx->interp == MINMOD )  { ierr = ADVelInterpMINMOD (vi); CHKERRQ(ierr); }
 	else if(vi->actx->interp == STAG_P )  { ierr = ADVelInterpSTAGP  (vi); CHKERRQ(ierr); }
 	else SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER," *** Unknown option for velocity interpolation scheme");
@@ -1461,3 +1428,333 @@ PetscErrorCode ADVelInterpSTAGP(AdvVelCtx *vi)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode ADVelInterpHalo(AdvVelCtx *vi)
+{
+	// interpolate velocities from STAG points to stage points using velocity halo
+	// (stage points may be located outside the local domain within halo width)
+
+	VelHalo     *halo;
+	PetscInt    jj, I, J, K, II, JJ, KK, nmark;
+	PetscScalar *ncx, *ncy, *ncz;
+	PetscScalar *ccx, *ccy, *ccz;
+	PetscScalar ***lvx, ***lvy, ***lvz;
+	PetscScalar xp, yp, zp;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// access context
+	halo  = vi->halo;
+	nmark = vi->nmark;
+
+	// global node & cell coordinates
+	ncx = halo->ncoor[0]; ccx = halo->ccoor[0];
+	ncy = halo->ncoor[1]; ccy = halo->ccoor[1];
+	ncz = halo->ncoor[2]; ccz = halo->ccoor[2];
+
+	// access wide velocity vectors
+	ierr = DMDAVecGetArray(halo->DA_X, halo->lvx, &lvx); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(halo->DA_Y, halo->lvy, &lvy); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(halo->DA_Z, halo->lvz, &lvz); CHKERRQ(ierr);
+
+	// scan all stage points
+	for(jj = 0; jj < nmark; jj++)
+	{
+		// get point coordinates
+		xp = vi->interp[jj].x[0];
+		yp = vi->interp[jj].x[1];
+		zp = vi->interp[jj].x[2];
+
+		// check whether point is within velocity halo
+		if((halo->L[0] && xp < ncx[halo->L[0]]) || (halo->R[0] != vi->fs->dsx.tcels && xp > ncx[halo->R[0]])
+		|| (halo->L[1] && yp < ncy[halo->L[1]]) || (halo->R[1] != vi->fs->dsy.tcels && yp > ncy[halo->R[1]])
+		|| (halo->L[2] && zp < ncz[halo->L[2]]) || (halo->R[2] != vi->fs->dsz.tcels && zp > ncz[halo->R[2]]))
+		{
+			SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Runge-Kutta stage point is outside velocity halo, reduce time step (CFL, CFLMAX, dt_max)");
+		}
+
+		// get global indices of the host cell
+		I = HaloFindCell(ncx, halo->L[0], halo->R[0], xp);
+		J = HaloFindCell(ncy, halo->L[1], halo->R[1], yp);
+		K = HaloFindCell(ncz, halo->L[2], halo->R[2], zp);
+
+		// map point on the cells of X, Y, Z & center grids
+		if(xp > ccx[I]) { II = I; } else { II = I-1; }
+		if(yp > ccy[J]) { JJ = J; } else { JJ = J-1; }
+		if(zp > ccz[K]) { KK = K; } else { KK = K-1; }
+
+		// interpolate velocity (extended grid indices are shifted by one)
+		vi->interp[jj].v[0] = InterpLin3D(lvx, I,  JJ, KK, 1, 1, 1, xp, yp, zp, ncx, ccy, ccz);
+		vi->interp[jj].v[1] = InterpLin3D(lvy, II, J,  KK, 1, 1, 1, xp, yp, zp, ccx, ncy, ccz);
+		vi->interp[jj].v[2] = InterpLin3D(lvz, II, JJ, K,  1, 1, 1, xp, yp, zp, ccx, ccy, ncz);
+	}
+
+	// restore access
+	ierr = DMDAVecRestoreArray(halo->DA_X, halo->lvx, &lvx); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(halo->DA_Y, halo->lvy, &lvy); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(halo->DA_Z, halo->lvz, &lvz); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVelHaloCreate(AdvCtx *actx)
+{
+	// create velocity halo
+
+	FDSTAG      *fs;
+	VelHalo     *halo;
+	Discret1D   *ds[3];
+	PetscScalar  cfl;
+	PetscInt     d;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	fs = actx->fs;
+
+	ierr = PetscMalloc(sizeof(VelHalo), &halo); CHKERRQ(ierr);
+	ierr = PetscMemzero(halo, sizeof(VelHalo)); CHKERRQ(ierr);
+
+	// halo width: maximum stage displacement (CFL) plus interpolation stencil
+	cfl     = PetscMax(actx->jr->ts->CFL, actx->jr->ts->CFLMAX);
+	halo->w = (PetscInt)PetscCeilReal(cfl) + 1;
+
+	// create extended grids
+	ierr = ADVelHaloCreateDMDA(fs->DA_X, halo->w, &halo->DA_X); CHKERRQ(ierr);
+	ierr = ADVelHaloCreateDMDA(fs->DA_Y, halo->w, &halo->DA_Y); CHKERRQ(ierr);
+	ierr = ADVelHaloCreateDMDA(fs->DA_Z, halo->w, &halo->DA_Z); CHKERRQ(ierr);
+
+	ierr = DMCreateGlobalVector(halo->DA_X, &halo->gvx); CHKERRQ(ierr);
+	ierr = DMCreateGlobalVector(halo->DA_Y, &halo->gvy); CHKERRQ(ierr);
+	ierr = DMCreateGlobalVector(halo->DA_Z, &halo->gvz); CHKERRQ(ierr);
+
+	ierr = DMCreateLocalVector (halo->DA_X, &halo->lvx); CHKERRQ(ierr);
+	ierr = DMCreateLocalVector (halo->DA_Y, &halo->lvy); CHKERRQ(ierr);
+	ierr = DMCreateLocalVector (halo->DA_Z, &halo->lvz); CHKERRQ(ierr);
+
+	// gather global coordinates, set node range available for stage points
+	ds[0] = &fs->dsx;
+	ds[1] = &fs->dsy;
+	ds[2] = &fs->dsz;
+
+	for(d = 0; d < 3; d++)
+	{
+		ierr = ADVelHaloGatherCoord(ds[d], &halo->ncoor[d], &halo->nbuff[d], &halo->ccoor[d], &halo->cbuff[d]); CHKERRQ(ierr);
+
+		halo->L[d] = PetscMax(ds[d]->pstart - (halo->w - 1), 0);
+		halo->R[d] = PetscMin(ds[d]->pstart + ds[d]->ncels + (halo->w - 1), ds[d]->tcels);
+	}
+
+	actx->halo = halo;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVelHaloDestroy(AdvCtx *actx)
+{
+	VelHalo  *halo;
+	PetscInt  d;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	halo = actx->halo;
+
+	if(!halo) PetscFunctionReturn(0);
+
+	ierr = DMDestroy (&halo->DA_X); CHKERRQ(ierr);
+	ierr = DMDestroy (&halo->DA_Y); CHKERRQ(ierr);
+	ierr = DMDestroy (&halo->DA_Z); CHKERRQ(ierr);
+	ierr = VecDestroy(&halo->gvx);  CHKERRQ(ierr);
+	ierr = VecDestroy(&halo->gvy);  CHKERRQ(ierr);
+	ierr = VecDestroy(&halo->gvz);  CHKERRQ(ierr);
+	ierr = VecDestroy(&halo->lvx);  CHKERRQ(ierr);
+	ierr = VecDestroy(&halo->lvy);  CHKERRQ(ierr);
+	ierr = VecDestroy(&halo->lvz);  CHKERRQ(ierr);
+
+	for(d = 0; d < 3; d++)
+	{
+		ierr = PetscFree(halo->nbuff[d]); CHKERRQ(ierr);
+		ierr = PetscFree(halo->cbuff[d]); CHKERRQ(ierr);
+	}
+
+	ierr = PetscFree(actx->halo); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVelHaloUpdate(AdvCtx *actx)
+{
+	// copy local velocity (including boundary ghost points) to extended grids,
+	// scatter wide velocity halo (single communication round per step)
+
+	FDSTAG      *fs;
+	JacRes      *jr;
+	VelHalo     *halo;
+	PetscInt    i, j, k, nx, ny, nz, sx, sy, sz;
+	PetscScalar ***lvx, ***lvy, ***lvz;
+	PetscScalar ***gvx, ***gvy, ***gvz;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!actx->halo)
+	{
+		ierr = ADVelHaloCreate(actx); CHKERRQ(ierr);
+	}
+
+	fs   = actx->fs;
+	jr   = actx->jr;
+	halo = actx->halo;
+
+	ierr = DMDAVecGetArray(fs->DA_X,   jr->lvx,   &lvx); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_Y,   jr->lvy,   &lvy); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fs->DA_Z,   jr->lvz,   &lvz); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(halo->DA_X, halo->gvx, &gvx); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(halo->DA_Y, halo->gvy, &gvy); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(halo->DA_Z, halo->gvz, &gvz); CHKERRQ(ierr);
+
+	//---------
+	// X points
+	//---------
+	ierr = DMDAGetCorners(halo->DA_X, &sx, &sy, &sz, &nx, &ny, &nz); CHKERRQ(ierr);
+
+	START_STD_LOOP
+	{
+		gvx[k][j][i] = lvx[k-1][j-1][i-1];
+	}
+	END_STD_LOOP
+
+	//---------
+	// Y points
+	//---------
+	ierr = DMDAGetCorners(halo->DA_Y, &sx, &sy, &sz, &nx, &ny, &nz); CHKERRQ(ierr);
+
+	START_STD_LOOP
+	{
+		gvy[k][j][i] = lvy[k-1][j-1][i-1];
+	}
+	END_STD_LOOP
+
+	//---------
+	// Z points
+	//---------
+	ierr = DMDAGetCorners(halo->DA_Z, &sx, &sy, &sz, &nx, &ny, &nz); CHKERRQ(ierr);
+
+	START_STD_LOOP
+	{
+		gvz[k][j][i] = lvz[k-1][j-1][i-1];
+	}
+	END_STD_LOOP
+
+	ierr = DMDAVecRestoreArray(fs->DA_X,   jr->lvx,   &lvx); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_Y,   jr->lvy,   &lvy); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fs->DA_Z,   jr->lvz,   &lvz); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(halo->DA_X, halo->gvx, &gvx); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(halo->DA_Y, halo->gvy, &gvy); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(halo->DA_Z, halo->gvz, &gvz); CHKERRQ(ierr);
+
+	// fill wide halo
+	GLOBAL_TO_LOCAL(halo->DA_X, halo->gvx, halo->lvx)
+	GLOBAL_TO_LOCAL(halo->DA_Y, halo->gvy, halo->lvy)
+	GLOBAL_TO_LOCAL(halo->DA_Z, halo->gvz, halo->lvz)
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVelHaloGatherCoord(Discret1D *ds, PetscScalar **ncoor, PetscScalar **nbuff, PetscScalar **ccoor, PetscScalar **cbuff)
+{
+	// gather global node coordinates on all processors of the column,
+	// add boundary ghost points & compute cell coordinates
+
+	PetscInt     i, n;
+	PetscScalar *nc, *cc;
+	PetscMPIInt *recvcnts, *recvdisp;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	n = ds->tnods;
+
+	ierr = makeScalArray(nbuff, NULL, n+2); CHKERRQ(ierr);
+	ierr = makeScalArray(cbuff, NULL, n+1); CHKERRQ(ierr);
+
+	nc = (*nbuff) + 1;
+	cc = (*cbuff) + 1;
+
+	if(ds->nproc == 1)
+	{
+		ierr = PetscMemcpy(nc, ds->ncoor, (size_t)n*sizeof(PetscScalar)); CHKERRQ(ierr);
+	}
+	else
+	{
+		// create column communicator
+		ierr = Discret1DGetColumnComm(ds); CHKERRQ(ierr);
+
+		ierr = makeMPIIntArray(&recvcnts, NULL, ds->nproc); CHKERRQ(ierr);
+		ierr = makeMPIIntArray(&recvdisp, NULL, ds->nproc); CHKERRQ(ierr);
+
+		for(i = 0; i < ds->nproc; i++)
+		{
+			recvcnts[i] = (PetscMPIInt)(ds->starts[i+1] - ds->starts[i]);
+			recvdisp[i] = (PetscMPIInt) ds->starts[i];
+		}
+
+		// ds->starts[ds->nproc] stores index of last node (not total number of nodes)
+		recvcnts[ds->nproc-1]++;
+
+		ierr = MPI_Allgatherv(ds->ncoor, (PetscMPIInt)ds->nnods, MPIU_SCALAR,
+			nc, recvcnts, recvdisp, MPIU_SCALAR, ds->comm); CHKERRQ(ierr);
+
+		ierr = PetscFree(recvcnts); CHKERRQ(ierr);
+		ierr = PetscFree(recvdisp); CHKERRQ(ierr);
+	}
+
+	// set boundary ghost coordinates
+	nc[-1] = nc[0]   - (nc[1]   - nc[0]);
+	nc[n]  = nc[n-1] + (nc[n-1] - nc[n-2]);
+
+	// compute coordinates of the cell centers including ghosts
+	for(i = -1; i < n; i++) cc[i] = (nc[i] + nc[i+1])/2.0;
+
+	(*ncoor) = nc;
+	(*ccoor) = cc;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVelHaloCreateDMDA(DM da, PetscInt w, DM *hda)
+{
+	// create grid extended by one boundary ghost layer (owned by boundary processors)
+	// with the same partitioning and stencil width w
+
+	PetscInt        M, N, P, Px, Py, Pz;
+	PetscInt       *lx, *ly, *lz;
+	const PetscInt *plx, *ply, *plz;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = DMDAGetInfo(da, 0, &M, &N, &P, &Px, &Py, &Pz, 0, 0, 0, 0, 0, 0); CHKERRQ(ierr);
+
+	ierr = DMDAGetOwnershipRanges(da, &plx, &ply, &plz); CHKERRQ(ierr);
+
+	ierr = makeIntArray(&lx, plx, Px); CHKERRQ(ierr);
+	ierr = makeIntArray(&ly, ply, Py); CHKERRQ(ierr);
+	ierr = makeIntArray(&lz, plz, Pz); CHKERRQ(ierr);
+
+	lx[0]++; lx[Px-1]++;
+	ly[0]++; ly[Py-1]++;
+	lz[0]++; lz[Pz-1]++;
+
+	ierr = DMDACreate3dSetUp(PETSC_COMM_WORLD,
+		DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DMDA_STENCIL_BOX,
+		M+2, N+2, P+2, Px, Py, Pz, 1, w, lx, ly, lz, hda); CHKERRQ(ierr);
+
+	ierr = PetscFree(lx); CHKERRQ(ierr);
+	ierr = PetscFree(ly); CHKERRQ(ierr);
+	ierr = PetscFree(lz); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
@@ -17,6 +17,28 @@
 struct FDSTAG;
 struct JacRes;
 struct AdvCtx;
+struct MarkExch;
+struct Discret1D;
+
+//-----------------------------------------------------------------------------
+
+// Velocity halo for Runge-Kutta stages.
+// Velocity components are scattered once per step on a ghost layer of width w,
+// so that all intermediate stages are interpolated locally (STAG interpolation)
+// and markers are only exchanged after the final position is computed.
+// Extended grids own boundary ghost points, indices are shifted by one.
+
+struct VelHalo
+{
+	PetscInt     w;                       // halo width (cells)
+	DM           DA_X, DA_Y, DA_Z;        // extended velocity grids
+	Vec          gvx, gvy, gvz;           // extended global velocity vectors
+	Vec          lvx, lvy, lvz;           // wide local velocity vectors
+	PetscScalar *ncoor[3], *nbuff[3];     // global node coordinates (+ 1 layer of boundary ghost points)
+	PetscScalar *ccoor[3], *cbuff[3];     // global cell coordinates (+ 1 layer of boundary ghost points)
+	PetscInt     L[3], R[3];              // node range available for stage points
+
+} ;
 
 //-----------------------------------------------------------------------------
 
@@ -52,6 +74,8 @@ struct AdvVelCtx
 	MPI_Comm         icomm;   // distinct communicator for communicating markers
 	PetscInt         nproc;   // total number of processors
 	PetscInt         iproc;   // processor rank
+	MarkExch        *mex;     // neighbor exchange engine (shared with advection context)
+	VelHalo         *halo;    // velocity halo (no intermediate exchange if set)
 
 	VelInterp        *sendbuf;
 	VelInterp        *recvbuf;
@@ -67,6 +91,11 @@ struct AdvVelCtx
 	PetscInt         ndel;
 	PetscInt         *idel;
 
+	// buffers are reused by all exchanges of a time step
+	PetscInt         sendcap; // capacity of send buffer
+	PetscInt         recvcap; // capacity of receive buffer
+	PetscInt         delcap;  // capacity of deleted marker indices buffer
+
 };
 
 //-----------------------------------------------------------------------------
@@ -112,6 +141,14 @@ PetscErrorCode ADVelInterpMain       (AdvVelCtx *vi);
 PetscErrorCode ADVelInterpSTAG       (AdvVelCtx *vi);
 PetscErrorCode ADVelInterpMINMOD     (AdvVelCtx *vi);
 PetscErrorCode ADVelInterpSTAGP      (AdvVelCtx *vi);
+PetscErrorCode ADVelInterpHalo       (AdvVelCtx *vi);
+
+// velocity halo
+PetscErrorCode ADVelHaloCreate       (AdvCtx *actx);
+PetscErrorCode ADVelHaloDestroy      (AdvCtx *actx);
+PetscErrorCode ADVelHaloUpdate       (AdvCtx *actx);
+PetscErrorCode ADVelHaloGatherCoord  (Discret1D *ds, PetscScalar **ncoor, PetscScalar **nbuff, PetscScalar **ccoor, PetscScalar **cbuff);
+PetscErrorCode ADVelHaloCreateDMDA   (DM da, PetscInt w, DM *hda);
 
 //-----------------------------------------------------------------------------
 // service functions
@@ -180,4 +217,23 @@ static inline PetscScalar InterpLinMinmod(
 	return X;
 }
 //-----------------------------------------------------------------------------
+static inline PetscInt HaloFindCell(
+	PetscScalar *crd,
+	PetscInt     L,
+	PetscInt     R,
+	PetscScalar  x)
+{
+	// find cell containing point in node range [L, R] (bisection)
+	PetscInt M;
+
+	while((R - L) > 1)
+	{
+		M = (L + R)/2;
+		if(crd[M] <= x) L = M;
+		else            R = M;
+	}
+
+	return L;
+}
+//-----------------------------------------------------------------------------
 #endif
@@ -0,0 +1,126 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+//...............   NEIGHBOR DOMAIN PARTICLE EXCHANGE   .....................
+//---------------------------------------------------------------------------
+#include "LaMEM.h"
+#include "exchange.h"
+#include "fdstag.h"
+//---------------------------------------------------------------------------
+PetscErrorCode MarkExchCreate(MarkExch *ex, FDSTAG *fs, MPI_Comm comm)
+{
+	// create graph communicator of neighbor domains
+	// NOTE: repeated neighbors (periodic or thin decompositions) are stored
+	// as multiple edges, messages between the same pair of processes are
+	// matched in the order of edges (same as point-to-point ordering)
+
+	PetscMPIInt iproc;
+	PetscInt    k;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = MPI_Comm_rank(comm, &iproc); CHKERRQ(ierr);
+
+	// collect existing neighbors except self
+	ex->nedge = 0;
+
+	for(k = 0; k < _num_neighb_; k++)
+	{
+		if(fs->neighb[k] != iproc && fs->neighb[k] != -1)
+		{
+			ex->edge[ex->nedge] = k;
+			ex->rank[ex->nedge] = fs->neighb[k];
+			ex->nedge++;
+		}
+	}
+
+	// create symmetric graph communicator (no reordering)
+	ierr = MPI_Dist_graph_create_adjacent(comm,
+		ex->nedge, ex->rank, MPI_UNWEIGHTED,
+		ex->nedge, ex->rank, MPI_UNWEIGHTED,
+		MPI_INFO_NULL, 0, &ex->gcomm); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MarkExchDestroy(MarkExch *ex)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = MPI_Comm_free(&ex->gcomm); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MarkExchNum(MarkExch *ex, PetscInt *nsendm, PetscInt *nrecvm)
+{
+	// communicate number of records with neighbor processes
+
+	PetscMPIInt j;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// clear receive counters (self & non-existing neighbors)
+	ierr = PetscMemzero(nrecvm, _num_neighb_*sizeof(PetscInt)); CHKERRQ(ierr);
+
+	if(!ex->nedge) PetscFunctionReturn(0);
+
+	// pack send counters
+	for(j = 0; j < ex->nedge; j++) ex->sbuf[j] = nsendm[ex->edge[j]];
+
+	ierr = MPI_Neighbor_alltoall(ex->sbuf, 1, MPIU_INT, ex->rbuf, 1, MPIU_INT, ex->gcomm); CHKERRQ(ierr);
+
+	// unpack receive counters
+	for(j = 0; j < ex->nedge; j++) nrecvm[ex->edge[j]] = ex->rbuf[j];
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MarkExchData(
+	MarkExch *ex,
+	size_t    size,
+	void     *sendbuf,
+	PetscInt *nsendm,
+	PetscInt *ptsend,
+	void     *recvbuf,
+	PetscInt *nrecvm,
+	PetscInt *ptrecv)
+{
+	// communicate records with neighbor processes
+
+	PetscInt    k;
+	PetscMPIInt j;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!ex->nedge) PetscFunctionReturn(0);
+
+	// set byte counts & displacements of every graph edge
+	for(j = 0; j < ex->nedge; j++)
+	{
+		k = ex->edge[j];
+
+		ex->scnt[j] = (PetscMPIInt)(nsendm[k]*(PetscInt)size);
+		ex->sdsp[j] = (PetscMPIInt)(ptsend[k]*(PetscInt)size);
+		ex->rcnt[j] = (PetscMPIInt)(nrecvm[k]*(PetscInt)size);
+		ex->rdsp[j] = (PetscMPIInt)(ptrecv[k]*(PetscInt)size);
+	}
+
+	ierr = MPI_Neighbor_alltoallv(
+		sendbuf, ex->scnt, ex->sdsp, MPI_BYTE,
+		recvbuf, ex->rcnt, ex->rdsp, MPI_BYTE, ex->gcomm); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
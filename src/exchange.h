@@ -0,0 +1,65 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+//...............   NEIGHBOR DOMAIN PARTICLE EXCHANGE   .....................
+//---------------------------------------------------------------------------
+#ifndef __exchange_h__
+#define __exchange_h__
+//---------------------------------------------------------------------------
+
+struct FDSTAG;
+
+//---------------------------------------------------------------------------
+
+// Exchange engine for particle-like payloads (markers, velocity interpolation
+// points, tracers). The 26-neighbor stencil of the domain decomposition is
+// stored as a distributed graph communicator, counts and payloads are
+// communicated with neighborhood collectives. Payloads are arbitrary
+// fixed-size records packed per neighbor (send/receive pointers indexed by
+// the neighbor number as in FDSTAG::neighb).
+
+struct MarkExch
+{
+	MPI_Comm    gcomm;               // distributed graph communicator of neighbor domains
+	PetscMPIInt nedge;               // number of graph edges (existing neighbors except self)
+	PetscInt    edge[_num_neighb_];  // neighbor index of every graph edge
+	PetscMPIInt rank[_num_neighb_];  // neighbor rank of every graph edge
+	PetscInt    sbuf[_num_neighb_];  // send counts of every graph edge
+	PetscInt    rbuf[_num_neighb_];  // receive counts of every graph edge
+	PetscMPIInt scnt[_num_neighb_];  // send byte counts
+	PetscMPIInt sdsp[_num_neighb_];  // send byte displacements
+	PetscMPIInt rcnt[_num_neighb_];  // receive byte counts
+	PetscMPIInt rdsp[_num_neighb_];  // receive byte displacements
+};
+
+//---------------------------------------------------------------------------
+
+// create graph communicator of neighbor domains
+PetscErrorCode MarkExchCreate(MarkExch *ex, FDSTAG *fs, MPI_Comm comm);
+
+// destroy graph communicator
+PetscErrorCode MarkExchDestroy(MarkExch *ex);
+
+// communicate number of records with neighbor processes
+PetscErrorCode MarkExchNum(MarkExch *ex, PetscInt *nsendm, PetscInt *nrecvm);
+
+// communicate records with neighbor processes
+PetscErrorCode MarkExchData(
+	MarkExch *ex,
+	size_t    size,    // record size in bytes
+	void     *sendbuf, // send buffer
+	PetscInt *nsendm,  // number of records sent to each neighbor
+	PetscInt *ptsend,  // send buffer pointers
+	void     *recvbuf, // receive buffer
+	PetscInt *nrecvm,  // number of records received from each neighbor
+	PetscInt *ptrecv); // receive buffer pointers
+
+//---------------------------------------------------------------------------
+#endif
@@ -143,6 +143,26 @@ PetscErrorCode PCStokesDestroy(PCStokes pc)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode PCStokesGetMixedPrecision(PCStokes pc, PetscBool *mixed)
+{
+	// check whether multigrid uses single precision level operators
+
+	PetscFunctionBeginUser;
+
+	(*mixed) = PETSC_FALSE;
+
+	if(pc->type == _STOKES_MG_)
+	{
+		(*mixed) = ((PCStokesMG*)pc->data)->mg.mixed;
+	}
+	else if(pc->type == _STOKES_BF_ && ((PCStokesBF*)pc->data)->vtype == _VEL_MG_)
+	{
+		(*mixed) = ((PCStokesBF*)pc->data)->vmg.mixed;
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 //........................... BLOCK FACTORIZATION ...........................
 //---------------------------------------------------------------------------
 PetscErrorCode PCStokesBFCreate(PCStokes pc)
@@ -72,6 +72,8 @@ PetscErrorCode PCStokesSetup(PCStokes pc);
 
 PetscErrorCode PCStokesDestroy(PCStokes pc);
 
+PetscErrorCode PCStokesGetMixedPrecision(PCStokes pc, PetscBool *mixed);
+
 //---------------------------------------------------------------------------
 
 // Block Factorization preconditioner context
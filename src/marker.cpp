@@ -545,15 +545,16 @@ PetscErrorCode ADVMarkSetTempPhase(AdvCtx *actx)
 //---------------------------------------------------------------------------
 PetscErrorCode ADVMarkSetTempFile(AdvCtx *actx, FB *fb)
 {
+	// reads only the block of the temperature grid that covers the local subdomain
+
 	FDSTAG         *fs;
-	int            fd;
 	Marker         *P;
-	PetscViewer    view_in;
 	PetscLogDouble t;
 	char           filename[_str_len_];
-	PetscScalar    header, dim[3];
-	PetscInt       GridSize, nx, ny, nz, imark, nummark, nmarkx, nmarky, nmarkz;
-	PetscScalar    DX, DY, DZ, bx, by, bz, ex, ey, ez;
+	PetscScalar    header[4], dim[3];
+	PetscInt       nx, ny, nz, imark, nummark, nmarkx, nmarky, nmarkz;
+	PetscInt       d, sizes[3], starts[3], subsizes[3], I0[3], I1[3], mx, my;
+	PetscScalar    DX, DY, DZ, bx, by, bz, ex, ey, ez, lbox[6], gbox[6], D[3];
 	PetscScalar    xp, yp, zp, Xc, Yc, Zc, xpL, ypL, zpL;
 	PetscScalar    *Temp;
 	PetscInt       Ix, Iy, Iz;
@@ -568,34 +569,24 @@ PetscErrorCode ADVMarkSetTempFile(AdvCtx *actx, FB *fb)
 	// check whether file is provided
 	if(!strlen(filename)) PetscFunctionReturn(0);
 
-	PrintStart(&t, "Loading temperature redundantly from", filename);
+	PrintStart(&t, "Loading temperature from", filename);
 
 	// access context
 	fs     = actx->fs;
 	chTemp = actx->jr->scal->temperature;
 	Tshift = actx->jr->scal->Tshift;
 
-	// open and read the file
-	ierr = PetscViewerBinaryOpen(PETSC_COMM_SELF, filename, FILE_MODE_READ, &view_in); CHKERRQ(ierr);
-	ierr = PetscViewerBinaryGetDescriptor(view_in, &fd); CHKERRQ(ierr);
+	// read (and ignore) the silent undocumented file header, read grid dimensions
+	ierr = BinaryReadHeader(PETSC_COMM_WORLD, filename, 4, header); CHKERRQ(ierr);
 
-	// read (and ignore) the silent undocumented file header
-	ierr = PetscBinaryRead(fd, &header, 1, NULL, PETSC_SCALAR); CHKERRQ(ierr);
-
-	// read grid dimensions
-	ierr = PetscBinaryRead(fd, &dim, 3, NULL, PETSC_SCALAR); CHKERRQ(ierr);
+	dim[0] = header[1];
+	dim[1] = header[2];
+	dim[2] = header[3];
 
 	// compute grid size
 	nx = (PetscInt)dim[0];
 	ny = (PetscInt)dim[1];
 	nz = (PetscInt)dim[2];
-	GridSize = nx * ny * nz;
-
-	// allocate space for entire file & initialize counter
-	ierr = PetscMalloc((size_t)GridSize*sizeof(PetscScalar), &Temp); CHKERRQ(ierr);
-
-	// read entire file
-	ierr = PetscBinaryRead(fd, Temp, GridSize, NULL, PETSC_SCALAR); CHKERRQ(ierr);
 
 	// get mesh extents
 	ierr = FDSTAGGetGlobalBox(fs, &bx, &by, &bz, &ex, &ey, &ez); CHKERRQ(ierr);
@@ -605,6 +596,39 @@ PetscErrorCode ADVMarkSetTempFile(AdvCtx *actx, FB *fb)
 	DY = (ey - by)/(dim[1] - 1.0);
 	DZ = (ez - bz)/(dim[2] - 1.0);
 
+	// get range of temperature grid nodes covering local subdomain
+	ierr = FDSTAGGetLocalBox(fs, &lbox[0], &lbox[2], &lbox[4], &lbox[1], &lbox[3], &lbox[5]); CHKERRQ(ierr);
+
+	gbox[0] = bx; gbox[2] = by; gbox[4] = bz;
+	D[0]    = DX; D[1]    = DY; D[2]    = DZ;
+
+	// file array is stored in C-order (z slowest)
+	sizes[0] = nz;
+	sizes[1] = ny;
+	sizes[2] = nx;
+
+	for(d = 0; d < 3; d++)
+	{
+		I0[d] = (PetscInt)PetscFloorReal((lbox[2*d]   - gbox[2*d])/D[d]);
+		I1[d] = (PetscInt)PetscFloorReal((lbox[2*d+1] - gbox[2*d])/D[d]) + 1;
+
+		if(I0[d] < 0)               I0[d] = 0;
+		if(I1[d] > sizes[2-d] - 1)  I1[d] = sizes[2-d] - 1;
+		if(I0[d] > I1[d] - 1)       I0[d] = I1[d] - 1;
+
+		starts  [2-d] = I0[d];
+		subsizes[2-d] = I1[d] - I0[d] + 1;
+	}
+
+	mx = subsizes[2];
+	my = subsizes[1];
+
+	// allocate space for local block
+	ierr = PetscMalloc((size_t)(subsizes[0]*subsizes[1]*subsizes[2])*sizeof(PetscScalar), &Temp); CHKERRQ(ierr);
+
+	// read local block
+	ierr = BinaryReadSubArray(PETSC_COMM_WORLD, filename, 4, 3, sizes, starts, subsizes, Temp); CHKERRQ(ierr);
+
 	// get local number of markers
 	nmarkx  = fs->dsx.ncels * actx->NumPartX;
 	nmarky  = fs->dsy.ncels * actx->NumPartY;
@@ -626,6 +650,14 @@ PetscErrorCode ADVMarkSetTempFile(AdvCtx *actx, FB *fb)
 		Iy = (PetscInt)floor((yp - by)/DY);
 		Iz = (PetscInt)floor((zp - bz)/DZ);
 
+		// keep element within local block
+		if(Ix < I0[0])     Ix = I0[0];
+		if(Ix > I1[0] - 1) Ix = I1[0] - 1;
+		if(Iy < I0[1])     Iy = I0[1];
+		if(Iy > I1[1] - 1) Iy = I1[1] - 1;
+		if(Iz < I0[2])     Iz = I0[2];
+		if(Iz > I1[2] - 1) Iz = I1[2] - 1;
+
 		// coordinate of the first corner (lower left deepest)
 		Xc = bx + (PetscScalar)Ix*DX;
 		Yc = by + (PetscScalar)Iy*DY;
@@ -636,25 +668,29 @@ PetscErrorCode ADVMarkSetTempFile(AdvCtx *actx, FB *fb)
 		ypL = (yp - Yc)/DY;
 		zpL = (zp - Zc)/DZ;
 
+		// switch to local block indices
+		Ix -= I0[0];
+		Iy -= I0[1];
+		Iz -= I0[2];
+
 		// Interpolate value on the particle using trilinear shape functions
 		P->T = ((
-		(1.0-xpL) * (1.0-ypL) * (1.0-zpL) * Temp[Iz    *nx*ny + Iy     * nx + Ix   ] +
-		 xpL      * (1.0-ypL) * (1.0-zpL) * Temp[Iz    *nx*ny + Iy     * nx + Ix+1 ] +
-		 xpL      *  ypL      * (1.0-zpL) * Temp[Iz    *nx*ny + (Iy+1) * nx + Ix+1 ] +
-		(1.0-xpL) *  ypL      * (1.0-zpL) * Temp[Iz    *nx*ny + (Iy+1) * nx + Ix   ] +
-		(1.0-xpL) * (1.0-ypL) *  zpL      * Temp[(Iz+1)*nx*ny + Iy     * nx + Ix   ] +
-		 xpL      * (1.0-ypL) *  zpL      * Temp[(Iz+1)*nx*ny + Iy     * nx + Ix+1 ] +
-		 xpL      *  ypL      *  zpL      * Temp[(Iz+1)*nx*ny + (Iy+1) * nx + Ix+1 ] +
-		(1.0-xpL) *  ypL      *  zpL      * Temp[(Iz+1)*nx*ny + (Iy+1) * nx + Ix   ] ) + Tshift)/chTemp;
+		(1.0-xpL) * (1.0-ypL) * (1.0-zpL) * Temp[Iz    *mx*my + Iy     * mx + Ix   ] +
+		 xpL      * (1.0-ypL) * (1.0-zpL) * Temp[Iz    *mx*my + Iy     * mx + Ix+1 ] +
+		 xpL      *  ypL      * (1.0-zpL) * Temp[Iz    *mx*my + (Iy+1) * mx + Ix+1 ] +
+		(1.0-xpL) *  ypL      * (1.0-zpL) * Temp[Iz    *mx*my + (Iy+1) * mx + Ix   ] +
+		(1.0-xpL) * (1.0-ypL) *  zpL      * Temp[(Iz+1)*mx*my + Iy     * mx + Ix   ] +
+		 xpL      * (1.0-ypL) *  zpL      * Temp[(Iz+1)*mx*my + Iy     * mx + Ix+1 ] +
+		 xpL      *  ypL      *  zpL      * Temp[(Iz+1)*mx*my + (Iy+1) * mx + Ix+1 ] +
+		(1.0-xpL) *  ypL      *  zpL      * Temp[(Iz+1)*mx*my + (Iy+1) * mx + Ix   ] ) + Tshift)/chTemp;
 	}
 
 	// clear memory
 	PetscFree(Temp);
-	ierr = PetscViewerDestroy(&view_in); CHKERRQ(ierr);
 
 	PrintDone(t);
 
-	PetscFunctionReturn(ierr);
+	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
 PetscErrorCode ADVMarkSetTempVector(AdvCtx *actx)
@@ -829,6 +865,12 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 	char            TemperatureStructure[_str_len_];
 	PetscInt        jj, ngeom, imark, maxPhaseID;
 	GeomPrim        geom[_max_geom_], *pgeom[_max_geom_], *sphere, *ellipsoid, *box, *ridge, *hex, *layer, *cylinder;
+	FDSTAG         *fs;
+	Discret1D      *ds[3];
+	GeomPrim       *lgeom[_max_geom_];
+	PetscScalar     lbox[6], gbox[6*_max_geom_], tol[3], cbeg, cend;
+	PetscInt        i, d, g, w, nloc, nw, ncel[3], ID[3];
+	uint64_t       *mask[3], *mx, *my, *mz, bits;
 
 	// map container to sort primitives in the order of appearance
 	map<PetscInt, GeomPrim*> cgeom;
@@ -1160,6 +1202,69 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 		pgeom[ngeom++] = it->second;
 	}
 
+	//===================
+	// SPATIAL INDEXING
+	//===================
+
+	// primitives are culled against the local subdomain, and every cell stores
+	// a bit mask of the primitives whose bounding boxes overlap it. Since boxes
+	// are axis-aligned, the mask is a product of per-direction masks, and bits
+	// are visited in file order to preserve last-one-wins semantics
+
+	fs    =  actx->fs;
+	ds[0] = &fs->dsx;
+	ds[1] = &fs->dsy;
+	ds[2] = &fs->dsz;
+
+	ierr = FDSTAGGetLocalBox(fs, &lbox[0], &lbox[2], &lbox[4], &lbox[1], &lbox[3], &lbox[5]); CHKERRQ(ierr);
+
+	for(d = 0; d < 3; d++)
+	{
+		ncel[d] = ds[d]->ncels;
+		tol [d] = (1e-6 + 2.0*ds[d]->gtol)*(ds[d]->ncoor[ncel[d]] - ds[d]->ncoor[0])/(PetscScalar)ncel[d];
+	}
+
+	// keep primitives that overlap local subdomain (in the order of appearance)
+	for(jj = 0, nloc = 0; jj < ngeom; jj++)
+	{
+		GeomGetBoundingBox(pgeom[jj], gbox + 6*nloc);
+
+		for(d = 0; d < 3; d++)
+		{
+			if(gbox[6*nloc + 2*d] > lbox[2*d+1] + tol[d] || gbox[6*nloc + 2*d+1] < lbox[2*d] - tol[d]) break;
+		}
+
+		if(d == 3) lgeom[nloc++] = pgeom[jj];
+	}
+
+	// number of mask words per cell
+	nw = (nloc + 63)/64;
+
+	// set per-direction cell masks
+	for(d = 0; d < 3; d++)
+	{
+		mask[d] = NULL;
+
+		if(!nloc) continue;
+
+		ierr = PetscMalloc((size_t)(ncel[d]*nw)*sizeof(uint64_t), &mask[d]); CHKERRQ(ierr);
+		ierr = PetscMemzero(mask[d], (size_t)(ncel[d]*nw)*sizeof(uint64_t)); CHKERRQ(ierr);
+
+		for(i = 0; i < ncel[d]; i++)
+		{
+			cbeg = ds[d]->ncoor[i]   - tol[d];
+			cend = ds[d]->ncoor[i+1] + tol[d];
+
+			for(g = 0; g < nloc; g++)
+			{
+				if(gbox[6*g + 2*d] <= cend && gbox[6*g + 2*d+1] >= cbeg)
+				{
+					mask[d][i*nw + g/64] |= ((uint64_t)1 << (g % 64));
+				}
+			}
+		}
+	}
+
 	//==============
 	// ASSIGN PHASES
 	//==============
@@ -1172,13 +1277,35 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 		//set default
 		P->phase = actx->bgPhase;
 
-		// override from geometric primitives
-		for(jj = 0; jj < ngeom; jj++)
+		if(!nloc) continue;
+
+		// get host cell
+		for(d = 0; d < 3; d++)
 		{
-			pgeom[jj]->setPhase(pgeom[jj], P);
+			ierr = Discret1DFindPoint(ds[d], P->X[d], ID[d]); CHKERRQ(ierr);
+		}
+
+		mx = mask[0] + ID[0]*nw;
+		my = mask[1] + ID[1]*nw;
+		mz = mask[2] + ID[2]*nw;
+
+		// override from candidate primitives
+		for(w = 0; w < nw; w++)
+		{
+			bits = mx[w] & my[w] & mz[w];
+
+			for(g = 64*w; bits; g++, bits >>= 1)
+			{
+				if(bits & 1) lgeom[g]->setPhase(lgeom[g], P);
+			}
 		}
 	}
 
+	for(d = 0; d < 3; d++)
+	{
+		ierr = PetscFree(mask[d]); CHKERRQ(ierr);
+	}
+
 	PrintDone(t);
 
 	PetscFunctionReturn(0);
@@ -1186,21 +1313,22 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 //---------------------------------------------------------------------------
 PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 {
-	// REDUNDANTLY loads a file with 2D-polygons that coincide with the marker planes
-	// each processor uses the full polygonal shapes to find assign phase ids to local markers
+	// loads a file with 2D-polygons that coincide with the marker planes
+	// each processor scans the polygon headers, but only reads the coordinates
+	// of the polygons that lie on its local marker planes
 
 	FDSTAG        *fs;
 	int            fd;
 	PetscViewer    view_in;
 	char           filename[_str_len_];
-	PetscScalar    header[2];
+	PetscScalar    header[2], VolHeader[4], Fheader[3];
 	PetscInt       tstart[3], tend[3], nmark[3], nidx[3], nidxmax;
-	PetscInt       k, n, kvol, Fcount, Fsize, VolN, Nmax, Lmax, kpoly, lpoly, numLev;
+	PetscInt       k, kvol, VolN, Nmax, Lmax, kpoly, lpoly, numLev;
 	Volume3D       Vol;
 	Polygon2D      Polys[_max_polygons_];
 	PetscInt      *polyin, *polyin_sum;
 	PetscInt      *idx;
-	PetscScalar   *X, *PolyLen, *PolyIdx, *PolyX, *PolyFile;
+	PetscScalar   *X, *PolyLen, *PolyIdx, *PolyX;
 	PetscInt       imark, imarkx, imarky, imarkz, icellx, icelly, icellz;
 	PetscScalar    dx, dy, dz, x, y, z;
 	PetscScalar    chLen;
@@ -1212,6 +1340,7 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 	PetscScalar    box[4];
 	CtrlP          CtrlPoly;
 	PetscInt       VolID, nCP;
+	off_t          off;
 
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
@@ -1219,7 +1348,7 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 	// get file name
 	ierr = getStringParam(fb, _OPTIONAL_, "poly_file", filename, "./input/poly.dat"); CHKERRQ(ierr);
 
-	PrintStart(&t, "Loading polygons redundantly from", filename);
+	PrintStart(&t, "Loading polygons from", filename);
 
 	// initialize
 	fs = actx->fs;
@@ -1339,19 +1468,13 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 
 	// read (and ignore) the silent undocumented file header & size of file
 	ierr = PetscBinaryRead(fd, &header, 2, NULL, PETSC_SCALAR); CHKERRQ(ierr);
-	Fsize = (PetscInt)(header[1]);
-
-	// allocate space for entire file & initialize counter
-	ierr = PetscMalloc((size_t)Fsize  *sizeof(PetscScalar),&PolyFile); CHKERRQ(ierr);
-	Fcount = 0;
-
-	// read entire file 
-	ierr = PetscBinaryRead(fd, PolyFile, Fsize, NULL, PETSC_SCALAR); CHKERRQ(ierr);
 
 	// read number of volumes
-	VolN = (PetscInt)(PolyFile[Fcount]); Fcount++;
-	Nmax = (PetscInt)(PolyFile[Fcount]); Fcount++;
-	Lmax = (PetscInt)(PolyFile[Fcount]); Fcount++;
+	ierr = PetscBinaryRead(fd, Fheader, 3, NULL, PETSC_SCALAR); CHKERRQ(ierr);
+
+	VolN = (PetscInt)(Fheader[0]);
+	Nmax = (PetscInt)(Fheader[1]);
+	Lmax = (PetscInt)(Fheader[2]);
 
     // allocate space for index array & the coordinates of the largest polygon
 	ierr = PetscMalloc((size_t)Nmax  *sizeof(PetscScalar),&PolyLen); CHKERRQ(ierr);
@@ -1372,10 +1495,12 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 	for(kvol = 0; kvol < VolN; kvol++)
 	{
 		// read volume header
-		Vol.dir   = (PetscInt)(PolyFile[Fcount]); Fcount++; // normal vector of polygon plane
-		Vol.phase = (PetscInt)(PolyFile[Fcount]); Fcount++; // phase that polygon defines
-		Vol.type  = (PetscInt)(PolyFile[Fcount]); Fcount++; // type of assigning the phases
-		Vol.num   = (PetscInt)(PolyFile[Fcount]); Fcount++; // number of polygon slices defining the volume
+		ierr = PetscBinaryRead(fd, VolHeader, 4, NULL, PETSC_SCALAR); CHKERRQ(ierr);
+
+		Vol.dir   = (PetscInt)(VolHeader[0]); // normal vector of polygon plane
+		Vol.phase = (PetscInt)(VolHeader[1]); // phase that polygon defines
+		Vol.type  = (PetscInt)(VolHeader[2]); // type of assigning the phases
+		Vol.num   = (PetscInt)(VolHeader[3]); // number of polygon slices defining the volume
 		
 		// define axes the span the polygon plane
 		if (Vol.dir==0)
@@ -1396,16 +1521,10 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 		}
 
 		// get position of polygons (PetscScalar !)
-		for(kpoly = 0; kpoly < Vol.num; kpoly++)
-		{
-			PolyIdx[kpoly] = PolyFile[Fcount]; Fcount++;
-		}
+		ierr = PetscBinaryRead(fd, PolyIdx, Vol.num, NULL, PETSC_SCALAR); CHKERRQ(ierr);
 
 		// get lengths of polygons (PetscScalar !)
-		for (kpoly=0; kpoly<Vol.num;kpoly++)
-		{
-			PolyLen[kpoly] = PolyFile[Fcount]; Fcount++;
-		}
+		ierr = PetscBinaryRead(fd, PolyLen, Vol.num, NULL, PETSC_SCALAR); CHKERRQ(ierr);
 
 		// interpolate stretch parameters
 		PetscScalar SyAll[Vol.num];
@@ -1474,10 +1593,7 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 				if(Polys[lpoly].gidx >= tstart[Vol.dir] && Polys[lpoly].gidx <= tend[Vol.dir])
 				{
 					// read polygon
-					for (n=0; n<Polys[lpoly].len*2;n++)
-					{
-						PolyX[n] = PolyFile[Fcount]; Fcount++;
-					}
+					ierr = PetscBinaryRead(fd, PolyX, Polys[lpoly].len*2, NULL, PETSC_SCALAR); CHKERRQ(ierr);
 
 					// vary Polygon geometry
 					if (kvol == VolID)
@@ -1511,8 +1627,8 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 				}
 				else
 				{
-					// increase counter of the buffer
-					Fcount += Polys[lpoly].len*2;
+					// skip polygon
+					ierr = PetscBinarySeek(fd, (off_t)(Polys[lpoly].len*2)*(off_t)sizeof(PetscScalar), PETSC_BINARY_SEEK_CUR, &off); CHKERRQ(ierr);
 				}
 			}
 
@@ -1550,7 +1666,6 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 	PetscFree(PolyIdx);
 	PetscFree(PolyLen);
 	PetscFree(PolyX);
-	PetscFree(PolyFile);
 	
 	if(actx->randNoise)
 	{
@@ -2108,6 +2223,58 @@ void computeTemperature(GeomPrim *geom, Marker *P, PetscScalar *T)
     
 }
 
+//---------------------------------------------------------------------------
+void GeomGetBoundingBox(
+		GeomPrim    *geom,   // geometric primitive
+		PetscScalar *bbox)   // bounding box
+{
+	PetscInt    i;
+	PetscScalar lo, hi;
+
+	if(geom->setPhase == setPhaseSphere)
+	{
+		for(i = 0; i < 3; i++)
+		{
+			bbox[2*i]   = geom->center[i] - geom->radius;
+			bbox[2*i+1] = geom->center[i] + geom->radius;
+		}
+	}
+	else if(geom->setPhase == setPhaseEllipsoid)
+	{
+		for(i = 0; i < 3; i++)
+		{
+			bbox[2*i]   = geom->center[i] - PetscAbsScalar(geom->axes[i]);
+			bbox[2*i+1] = geom->center[i] + PetscAbsScalar(geom->axes[i]);
+		}
+	}
+	else if(geom->setPhase == setPhaseBox
+	||      geom->setPhase == setPhaseRidge
+	||      geom->setPhase == setPhaseHex)
+	{
+		for(i = 0; i < 6; i++) bbox[i] = geom->bounds[i];
+	}
+	else if(geom->setPhase == setPhaseCylinder)
+	{
+		for(i = 0; i < 3; i++)
+		{
+			lo = min(geom->base[i], geom->cap[i]);
+			hi = max(geom->base[i], geom->cap[i]);
+
+			bbox[2*i]   = lo - geom->radius;
+			bbox[2*i+1] = hi + geom->radius;
+		}
+	}
+	else
+	{
+		// layers draw a random perturbation for every marker,
+		// they must be tested everywhere to keep the random sequence intact
+		for(i = 0; i < 3; i++)
+		{
+			bbox[2*i]   = -DBL_MAX;
+			bbox[2*i+1] =  DBL_MAX;
+		}
+	}
+}
 //---------------------------------------------------------------------------
 void HexGetBoundingBox(
 		PetscScalar *coord,  // hex coordinates
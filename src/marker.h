@@ -104,6 +104,10 @@ void setPhaseHex(GeomPrim *hex, Marker *P);
 
 void setPhaseCylinder(GeomPrim *cylinder, Marker *P);
 
+void GeomGetBoundingBox(
+		GeomPrim    *geom,   // geometric primitive
+		PetscScalar *bbox);  // bounding box
+
 void HexGetBoundingBox(
 		PetscScalar *coord,   // hex coordinates
 		PetscScalar *bounds); // bounding box
@@ -139,7 +143,7 @@ PetscErrorCode ADVMarkSetTempGrad(AdvCtx *actx);
 // initialize temperature on markers based on phase temperature
 PetscErrorCode ADVMarkSetTempPhase(AdvCtx *actx);
 
-// initialize temperature on markers redundantly form file
+// initialize temperature on markers from file (collective MPI-IO read of local block)
 PetscErrorCode ADVMarkSetTempFile(AdvCtx *actx, FB *fb);
 
 // initialize temperature on markers from vector
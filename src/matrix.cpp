@@ -17,6 +17,7 @@
 #include "bc.h"
 #include "JacRes.h"
 #include "tools.h"
+#include "profile.h"
 
 //---------------------------------------------------------------------------
 // * pressure Schur complement preconditioners
@@ -168,6 +169,261 @@ PetscErrorCode MatAIJSetNullSpace(Mat P, DOFIndex *dof)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+//.....................   SINGLE PRECISION MATRIX   .........................
+//---------------------------------------------------------------------------
+PetscErrorCode MatFloatGetBlocks(Mat A, Mat *Ad, Mat *Ao, const PetscInt **colmap)
+{
+	// get diagonal & off-diagonal blocks of AIJ matrix
+	// (off-diagonal block is not defined for sequential matrix)
+
+	PetscBool mpi, seq;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PetscObjectBaseTypeCompare((PetscObject)A, MATMPIAIJ, &mpi); CHKERRQ(ierr);
+	ierr = PetscObjectBaseTypeCompare((PetscObject)A, MATSEQAIJ, &seq); CHKERRQ(ierr);
+
+	if(mpi == PETSC_TRUE)
+	{
+		ierr = MatMPIAIJGetSeqAIJ(A, Ad, Ao, colmap); CHKERRQ(ierr);
+	}
+	else if(seq == PETSC_TRUE)
+	{
+		(*Ad)     = A;
+		(*Ao)     = NULL;
+		(*colmap) = NULL;
+	}
+	else
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "Single precision matrix copy requires AIJ matrix format");
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatFloatCreate(Mat A, Mat *F)
+{
+	MatFloat       *mf;
+	Vec             x;
+	IS              is;
+	const PetscInt *colmap;
+	PetscInt        m, n, ng;
+	PetscBool       done;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// allocate context
+	ierr = PetscMalloc(sizeof(MatFloat), &mf); CHKERRQ(ierr);
+	ierr = PetscMemzero(mf, sizeof(MatFloat)); CHKERRQ(ierr);
+
+	// store source matrix (index arrays are shared with its blocks)
+	ierr = PetscObjectReference((PetscObject)A); CHKERRQ(ierr);
+
+	mf->A = A;
+
+	// access matrix blocks
+	ierr = MatFloatGetBlocks(A, &mf->Ad, &mf->Ao, &colmap); CHKERRQ(ierr);
+
+	// get diagonal block structure
+	ierr = MatGetRowIJ(mf->Ad, 0, PETSC_FALSE, PETSC_FALSE, &m, &mf->id, &mf->jd, &done); CHKERRQ(ierr);
+
+	if(done != PETSC_TRUE) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "Cannot access matrix structure");
+
+	mf->m  = m;
+	mf->nd = mf->id[m];
+
+	ierr = PetscMalloc(sizeof(float)*(size_t)mf->nd, &mf->ad); CHKERRQ(ierr);
+
+	if(mf->Ao)
+	{
+		// get off-diagonal block structure (columns are compressed to ghost entries)
+		ierr = MatGetRowIJ(mf->Ao, 0, PETSC_FALSE, PETSC_FALSE, &m, &mf->io, &mf->jo, &done); CHKERRQ(ierr);
+
+		if(done != PETSC_TRUE) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "Cannot access matrix structure");
+
+		mf->no = mf->io[m];
+
+		ierr = PetscMalloc(sizeof(float)*(size_t)mf->no, &mf->ao); CHKERRQ(ierr);
+
+		// create ghost entries scatter context
+		ierr = MatGetSize(mf->Ao, NULL, &ng); CHKERRQ(ierr);
+
+		ierr = MatCreateVecs(A, &x, NULL);                                          CHKERRQ(ierr);
+		ierr = ISCreateGeneral(PETSC_COMM_SELF, ng, colmap, PETSC_COPY_VALUES, &is); CHKERRQ(ierr);
+		ierr = VecCreateSeq(PETSC_COMM_SELF, ng, &mf->lvec);                         CHKERRQ(ierr);
+		ierr = VecScatterCreate(x, is, mf->lvec, NULL, &mf->ctx);                    CHKERRQ(ierr);
+		ierr = ISDestroy(&is);                                                       CHKERRQ(ierr);
+		ierr = VecDestroy(&x);                                                       CHKERRQ(ierr);
+	}
+
+	// create shell matrix
+	ierr = MatGetLocalSize(A, &m, &n); CHKERRQ(ierr);
+
+	ierr = MatCreateShell(PETSC_COMM_WORLD, m, n,
+		PETSC_DETERMINE, PETSC_DETERMINE, (void*)mf, F);                                   CHKERRQ(ierr);
+	ierr = MatShellSetOperation((*F), MATOP_MULT,     (void(*)(void))MatFloatMult);    CHKERRQ(ierr);
+	ierr = MatShellSetOperation((*F), MATOP_MULT_ADD, (void(*)(void))MatFloatMultAdd); CHKERRQ(ierr);
+	ierr = MatSetUp((*F));                                                             CHKERRQ(ierr);
+
+	// copy values
+	ierr = MatFloatUpdate((*F)); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatFloatUpdate(Mat F)
+{
+	// copy values from source matrix (nonzero pattern must be preserved)
+
+	MatFloat          *mf;
+	Mat                Ad, Ao;
+	MatInfo            info;
+	const PetscScalar *a;
+	PetscInt           i;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = MatShellGetContext(F, (void**)&mf); CHKERRQ(ierr);
+
+	Ad = mf->Ad;
+	Ao = mf->Ao;
+
+	// diagonal block
+	ierr = MatGetInfo(Ad, MAT_LOCAL, &info); CHKERRQ(ierr);
+
+	if((PetscInt)info.nz_used != mf->nd) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_WRONGSTATE, "Nonzero pattern of the source matrix has changed");
+
+	ierr = MatSeqAIJGetArrayRead(Ad, &a); CHKERRQ(ierr);
+
+	for(i = 0; i < mf->nd; i++) mf->ad[i] = (float)a[i];
+
+	ierr = MatSeqAIJRestoreArrayRead(Ad, &a); CHKERRQ(ierr);
+
+	// off-diagonal block
+	if(Ao)
+	{
+		ierr = MatGetInfo(Ao, MAT_LOCAL, &info); CHKERRQ(ierr);
+
+		if((PetscInt)info.nz_used != mf->no) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_ARG_WRONGSTATE, "Nonzero pattern of the source matrix has changed");
+
+		ierr = MatSeqAIJGetArrayRead(Ao, &a); CHKERRQ(ierr);
+
+		for(i = 0; i < mf->no; i++) mf->ao[i] = (float)a[i];
+
+		ierr = MatSeqAIJRestoreArrayRead(Ao, &a); CHKERRQ(ierr);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatFloatDestroy(Mat *F)
+{
+	MatFloat  *mf;
+	PetscInt   m;
+	PetscBool  done;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!(*F)) PetscFunctionReturn(0);
+
+	ierr = MatShellGetContext((*F), (void**)&mf); CHKERRQ(ierr);
+
+	// release shared index arrays
+	ierr = MatRestoreRowIJ(mf->Ad, 0, PETSC_FALSE, PETSC_FALSE, &m, &mf->id, &mf->jd, &done); CHKERRQ(ierr);
+
+	if(mf->Ao)
+	{
+		ierr = MatRestoreRowIJ(mf->Ao, 0, PETSC_FALSE, PETSC_FALSE, &m, &mf->io, &mf->jo, &done); CHKERRQ(ierr);
+	}
+
+	ierr = PetscFree(mf->ad);           CHKERRQ(ierr);
+	ierr = PetscFree(mf->ao);           CHKERRQ(ierr);
+	ierr = VecDestroy(&mf->lvec);       CHKERRQ(ierr);
+	ierr = VecScatterDestroy(&mf->ctx); CHKERRQ(ierr);
+	ierr = MatDestroy(&mf->A);          CHKERRQ(ierr);
+	ierr = PetscFree(mf);               CHKERRQ(ierr);
+	ierr = MatDestroy(F);               CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatFloatMult(Mat F, Vec x, Vec y)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// y = F*x
+	ierr = MatFloatMultAdd(F, x, NULL, y); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatFloatMultAdd(Mat F, Vec x, Vec y, Vec z)
+{
+	// z = F*x + y (y can be omitted or coincide with z)
+
+	MatFloat          *mf;
+	const PetscScalar *xa, *la;
+	PetscScalar       *ya, *za, s;
+	PetscInt           i, j;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = MatShellGetContext(F, (void**)&mf); CHKERRQ(ierr);
+
+	// start ghost entries update
+	if(mf->ctx)
+	{
+		ierr = VecScatterBegin(mf->ctx, x, mf->lvec, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+	}
+
+	ierr = VecGetArrayRead(x, &xa); CHKERRQ(ierr);
+
+	if(y) { ierr = VecGetArrayPair(y, z, &ya, &za); CHKERRQ(ierr); }
+	else  { ierr = VecGetArray(z, &za);             CHKERRQ(ierr); ya = NULL; }
+
+	// diagonal block (overlaps communication)
+	for(i = 0; i < mf->m; i++)
+	{
+		s = 0.0; if(ya) s = ya[i];
+
+		for(j = mf->id[i]; j < mf->id[i+1]; j++) s += (PetscScalar)mf->ad[j]*xa[mf->jd[j]];
+
+		za[i] = s;
+	}
+
+	ierr = VecRestoreArrayRead(x, &xa); CHKERRQ(ierr);
+
+	// off-diagonal block
+	if(mf->ctx)
+	{
+		ierr = VecScatterEnd(mf->ctx, x, mf->lvec, INSERT_VALUES, SCATTER_FORWARD); CHKERRQ(ierr);
+
+		ierr = VecGetArrayRead(mf->lvec, &la); CHKERRQ(ierr);
+
+		for(i = 0; i < mf->m; i++)
+		{
+			s = 0.0;
+
+			for(j = mf->io[i]; j < mf->io[i+1]; j++) s += (PetscScalar)mf->ao[j]*la[mf->jo[j]];
+
+			za[i] += s;
+		}
+
+		ierr = VecRestoreArrayRead(mf->lvec, &la); CHKERRQ(ierr);
+	}
+
+	if(y) { ierr = VecRestoreArrayPair(y, z, &ya, &za); CHKERRQ(ierr); }
+	else  { ierr = VecRestoreArray(z, &za);             CHKERRQ(ierr); }
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode PMatCreate(PMat *p_pm, JacRes *jr)
 {
 	PetscErrorCode ierr;
@@ -294,6 +550,8 @@ PetscErrorCode PMatAssemble(PMat pm)
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	ierr = PetscLogEventBegin(LaMEM_PMatAssemble, 0, 0, 0, 0); CHKERRQ(ierr);
+
 //	PetscPrintf(PETSC_COMM_WORLD, " Starting preconditioner assembly\n");
 
 	bc = pm->jr->bc;
@@ -308,6 +566,8 @@ PetscErrorCode PMatAssemble(PMat pm)
 
 //	PetscPrintf(PETSC_COMM_WORLD, " Finished preconditioner assembly\n");
 
+	ierr = PetscLogEventEnd(LaMEM_PMatAssemble, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
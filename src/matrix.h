@@ -30,6 +30,44 @@ PetscErrorCode MatAIJAssemble(Mat P, PetscInt numRows, const PetscInt rows[], Pe
 
 PetscErrorCode MatAIJSetNullSpace(Mat P, DOFIndex *dof);
 
+//---------------------------------------------------------------------------
+//.....................   SINGLE PRECISION MATRIX   .........................
+//---------------------------------------------------------------------------
+
+// Matrix-free (shell) copy of an assembled AIJ matrix that stores values in
+// single precision. Products are accumulated in double precision. Column
+// indices are shared with the source matrix, which is kept alive by
+// reference, so the copy adds 4 bytes per nonzero to the memory footprint.
+// Matrix-vector products read 8 instead of 12 bytes per nonzero (32-bit
+// indices). Intended for use inside preconditioners of a flexible (double
+// precision) Krylov solver.
+
+struct MatFloat
+{
+	Mat             A;        // source matrix (double precision, referenced)
+	Mat             Ad, Ao;   // diagonal & off-diagonal blocks of source matrix
+	PetscInt        m;        // number of local rows
+	PetscInt        nd, no;   // number of diagonal & off-diagonal block nonzeros
+	const PetscInt *id, *jd;  // diagonal block structure (local column indices, shared)
+	const PetscInt *io, *jo;  // off-diagonal block structure (ghost column indices, shared)
+	float          *ad, *ao;  // diagonal & off-diagonal block values
+	Vec             lvec;     // ghost entries of input vector
+	VecScatter      ctx;      // ghost entries scatter context
+
+};
+
+PetscErrorCode MatFloatGetBlocks(Mat A, Mat *Ad, Mat *Ao, const PetscInt **colmap);
+
+PetscErrorCode MatFloatCreate(Mat A, Mat *F);
+
+PetscErrorCode MatFloatUpdate(Mat F);
+
+PetscErrorCode MatFloatDestroy(Mat *F);
+
+PetscErrorCode MatFloatMult(Mat F, Vec x, Vec y);
+
+PetscErrorCode MatFloatMultAdd(Mat F, Vec x, Vec y, Vec z);
+
 //---------------------------------------------------------------------------
 // preconditioning matrix storage format
 enum PMatType
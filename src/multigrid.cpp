@@ -17,6 +17,7 @@
 #include "JacRes.h"
 #include "bc.h"
 #include "tools.h"
+#include "profile.h"
 //---------------------------------------------------------------------------
 // * remove hierarchy of grids & bc-objects (use info from fine level)
 // * preallocate all restriction & interpolation operators
@@ -36,6 +37,11 @@ PetscErrorCode MGLevelCreate(MGLevel *lvl, MGLevel *fine, FDSTAG *fs, BCCtx *bc)
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	// single precision copies are created on demand
+	lvl->Af = NULL;
+	lvl->Rf = NULL;
+	lvl->Pf = NULL;
+
 	if(!fine)
 	{
 		// copy data from the staggered grid on the finest level
@@ -164,6 +170,9 @@ PetscErrorCode MGLevelDestroy(MGLevel *lvl)
 	ierr = VecDestroy(&lvl->etax);         CHKERRQ(ierr);
 	ierr = VecDestroy(&lvl->etay);         CHKERRQ(ierr);
 	ierr = VecDestroy(&lvl->etaz);         CHKERRQ(ierr);
+	ierr = MatFloatDestroy(&lvl->Af);      CHKERRQ(ierr);
+	ierr = MatFloatDestroy(&lvl->Rf);      CHKERRQ(ierr);
+	ierr = MatFloatDestroy(&lvl->Pf);      CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -1715,6 +1724,14 @@ PetscErrorCode MGCreate(MG *mg, JacRes *jr)
 	// set boundary constraint restriction flag
 	ierr = PetscOptionsHasName(NULL, NULL, "-gmg_no_restric_bc", &mg->no_restric_bc); CHKERRQ(ierr);
 
+	// set single precision level operators flag
+	ierr = PetscOptionsHasName(NULL, NULL, "-gmg_mixed_precision", &mg->mixed); CHKERRQ(ierr);
+
+	if(mg->mixed == PETSC_TRUE)
+	{
+		ierr = PetscPrintf(PETSC_COMM_WORLD, "   Single precision level operators (requires flexible outer solver)\n"); CHKERRQ(ierr);
+	}
+
 	// check multigrid mesh restrictions & get actual number of levels
 	ierr = MGGetNumLevels(mg); CHKERRQ(ierr);
 
@@ -1769,6 +1786,8 @@ PetscErrorCode MGDestroy(MG *mg)
 		ierr = PCView(mg->pc, PETSC_VIEWER_STDOUT_WORLD); CHKERRQ(ierr);
 	}
 
+	ierr = PCDestroy(&mg->pc); CHKERRQ(ierr);
+
 	for(i = 0; i < mg->nlvl; i++)
 	{
 		ierr = MGLevelDestroy(&mg->lvls[i]); CHKERRQ(ierr);
@@ -1776,8 +1795,6 @@ PetscErrorCode MGDestroy(MG *mg)
 
 	ierr = PetscFree(mg->lvls); CHKERRQ(ierr);
 
-	ierr = PCDestroy(&mg->pc); CHKERRQ(ierr);
-
 	PetscFunctionReturn(0);
 }
 
@@ -1839,6 +1856,8 @@ PetscErrorCode MGSetup(MG *mg, Mat A)
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	ierr = PetscLogEventBegin(LaMEM_MGSetup, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	ierr = MGLevelInitEta(mg->lvls, mg->jr); CHKERRQ(ierr);
 	ierr = MGLevelAverageEta(mg->lvls);      CHKERRQ(ierr);
 
@@ -1851,6 +1870,9 @@ PetscErrorCode MGSetup(MG *mg, Mat A)
 		ierr = MGLevelSetupProlong (&mg->lvls[i], &mg->lvls[i-1]);                    CHKERRQ(ierr);
 	}
 
+	// restore double precision operators for Galerkin coarsening
+	ierr = MGRestoreMixed(mg); CHKERRQ(ierr);
+
 	// setup coarse grid solver if necessary
 	ierr = MGSetupCoarse(mg, A); CHKERRQ(ierr);
 
@@ -1863,10 +1885,115 @@ PetscErrorCode MGSetup(MG *mg, Mat A)
 	// store matrices in the file if requested
 	ierr = MGDumpMat(mg); CHKERRQ(ierr);
 
+	// install single precision operators if requested
+	ierr = MGSetupMixed(mg); CHKERRQ(ierr);
+
+	ierr = PetscLogEventEnd(LaMEM_MGSetup, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 
 }
 //---------------------------------------------------------------------------
+PetscErrorCode MGSetupMixed(MG *mg)
+{
+	// Replace level operators (except coarse grid), restriction and
+	// prolongation operators with single precision copies. Double precision
+	// matrices are kept as preconditioning matrices of the smoothers, and
+	// are used for Galerkin coarsening during the next setup.
+	// Preconditioner becomes variable, i.e. requires flexible outer solver.
+
+	KSP       ksp;
+	Mat       B;
+	MatFloat *mf;
+	MGLevel  *lvl;
+	PetscInt  i, l;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(mg->mixed != PETSC_TRUE) PetscFunctionReturn(0);
+
+	for(i = 0, l = mg->nlvl-1; i < mg->nlvl; i++, l--)
+	{
+		lvl = &mg->lvls[i];
+
+		// level operator
+		if(l != 0)
+		{
+			ierr = PCMGGetSmoother(mg->pc, l, &ksp); CHKERRQ(ierr);
+			ierr = KSPGetOperators(ksp, NULL, &B);   CHKERRQ(ierr);
+
+			// recreate copy if source matrix has changed
+			if(lvl->Af)
+			{
+				ierr = MatShellGetContext(lvl->Af, (void**)&mf); CHKERRQ(ierr);
+
+				if(mf->A != B)
+				{
+					ierr = MatFloatDestroy(&lvl->Af); CHKERRQ(ierr);
+				}
+			}
+
+			if(lvl->Af) { ierr = MatFloatUpdate(lvl->Af);     CHKERRQ(ierr); }
+			else        { ierr = MatFloatCreate(B, &lvl->Af); CHKERRQ(ierr); }
+
+			ierr = KSPSetOperators(ksp, lvl->Af, B);                           CHKERRQ(ierr);
+			ierr = PCMGSetResidual(mg->pc, l, PCMGResidualDefault, lvl->Af); CHKERRQ(ierr);
+		}
+
+		// restriction & prolongation (connect with finer level)
+		if(lvl->R)
+		{
+			if(lvl->Rf) { ierr = MatFloatUpdate(lvl->Rf);          CHKERRQ(ierr); }
+			else        { ierr = MatFloatCreate(lvl->R, &lvl->Rf); CHKERRQ(ierr); }
+
+			if(lvl->Pf) { ierr = MatFloatUpdate(lvl->Pf);          CHKERRQ(ierr); }
+			else        { ierr = MatFloatCreate(lvl->P, &lvl->Pf); CHKERRQ(ierr); }
+
+			ierr = PCMGSetRestriction  (mg->pc, l+1, lvl->Rf); CHKERRQ(ierr);
+			ierr = PCMGSetInterpolation(mg->pc, l+1, lvl->Pf); CHKERRQ(ierr);
+		}
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MGRestoreMixed(MG *mg)
+{
+	// restore double precision operators before preconditioner setup
+
+	KSP       ksp;
+	Mat       B;
+	MGLevel  *lvl;
+	PetscInt  i, l;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(mg->mixed != PETSC_TRUE) PetscFunctionReturn(0);
+
+	for(i = 0, l = mg->nlvl-1; i < mg->nlvl; i++, l--)
+	{
+		lvl = &mg->lvls[i];
+
+		if(lvl->Af)
+		{
+			ierr = PCMGGetSmoother(mg->pc, l, &ksp);                   CHKERRQ(ierr);
+			ierr = KSPGetOperators(ksp, NULL, &B);                     CHKERRQ(ierr);
+			ierr = KSPSetOperators(ksp, B, B);                         CHKERRQ(ierr);
+			ierr = PCMGSetResidual(mg->pc, l, PCMGResidualDefault, B); CHKERRQ(ierr);
+		}
+
+		if(lvl->Rf)
+		{
+			ierr = PCMGSetRestriction  (mg->pc, l+1, lvl->R); CHKERRQ(ierr);
+			ierr = PCMGSetInterpolation(mg->pc, l+1, lvl->P); CHKERRQ(ierr);
+		}
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode MGApply(PC pc, Vec x, Vec y)
 {
 	MG *mg;
@@ -1996,3 +2123,475 @@ PetscErrorCode MGGetNumLevels(MG *mg)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+//...................   TEMPERATURE GEOMETRIC MULTIGRID   ...................
+//---------------------------------------------------------------------------
+PetscErrorCode TMGLevelCreate(TMGLevel *lvl, TMGLevel *fine, FDSTAG *fs)
+{
+	PetscInt         i, j, k, nx, ny, nz, sx, sy, sz, iter;
+	PetscInt         Nx, Ny, Nz, Px, Py, Pz, refine_y, ln, lnfine, rstart;
+	const PetscInt  *plx, *ply, *plz;
+	PetscInt        *lx,  *ly,  *lz;
+	PetscScalar   ***ind;
+	Vec              gind;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	lvl->P = NULL;
+
+	if(!fine)
+	{
+		// use staggered grid central points on the finest level
+		lvl->DA_CEN = fs->DA_CEN;
+	}
+	else
+	{
+		// get grid size, partitioning & refinement factor of the fine level
+		ierr = DMDAGetInfo(fine->DA_CEN, 0, &Nx, &Ny, &Nz, &Px, &Py, &Pz, 0, 0, 0, 0, 0, 0); CHKERRQ(ierr);
+		ierr = DMDAGetRefinementFactor(fine->DA_CEN, NULL, &refine_y, NULL);                CHKERRQ(ierr);
+		ierr = DMDAGetOwnershipRanges(fine->DA_CEN, &plx, &ply, &plz);                      CHKERRQ(ierr);
+
+		ierr = makeIntArray(&lx, plx, Px); CHKERRQ(ierr);
+		ierr = makeIntArray(&ly, ply, Py); CHKERRQ(ierr);
+		ierr = makeIntArray(&lz, plz, Pz); CHKERRQ(ierr);
+
+		// coarsen uniformly in every direction (don't coarsen y-direction in 2D)
+		Nx /= 2;        for(i = 0; i < Px; i++) lx[i] /= 2;
+		Ny /= refine_y; for(i = 0; i < Py; i++) ly[i] /= refine_y;
+		Nz /= 2;        for(i = 0; i < Pz; i++) lz[i] /= 2;
+
+		// central points with boundary ghost points (1-layer stencil box)
+		ierr = DMDACreate3dSetUp(PETSC_COMM_WORLD,
+			DM_BOUNDARY_GHOSTED, DM_BOUNDARY_GHOSTED, DM_BOUNDARY_GHOSTED, DMDA_STENCIL_BOX,
+			Nx, Ny, Nz, Px, Py, Pz, 1, 1, lx, ly, lz, &lvl->DA_CEN); CHKERRQ(ierr);
+
+		// clear temporary storage
+		ierr = PetscFree(lx); CHKERRQ(ierr);
+		ierr = PetscFree(ly); CHKERRQ(ierr);
+		ierr = PetscFree(lz); CHKERRQ(ierr);
+	}
+
+	// create conductivity & index vectors
+	ierr = DMCreateLocalVector(lvl->DA_CEN, &lvl->k);   CHKERRQ(ierr);
+	ierr = DMCreateLocalVector(lvl->DA_CEN, &lvl->ind); CHKERRQ(ierr);
+
+	// get global index of the first local cell
+	ierr = DMGetGlobalVector(lvl->DA_CEN, &gind);            CHKERRQ(ierr);
+	ierr = VecGetOwnershipRange(gind, &rstart, NULL);        CHKERRQ(ierr);
+	ierr = VecGetLocalSize(gind, &ln);                       CHKERRQ(ierr);
+	ierr = DMRestoreGlobalVector(lvl->DA_CEN, &gind);        CHKERRQ(ierr);
+
+	// compute global indices (cells outside domain are marked with -1)
+	ierr = VecSet(lvl->k,    0.0); CHKERRQ(ierr);
+	ierr = VecSet(lvl->ind, -1.0); CHKERRQ(ierr);
+
+	ierr = DMDAVecGetArray(lvl->DA_CEN, lvl->ind, &ind); CHKERRQ(ierr);
+
+	iter = rstart;
+
+	ierr = DMDAGetCorners(lvl->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz); CHKERRQ(ierr);
+
+	START_STD_LOOP
+	{
+		ind[k][j][i] = (PetscScalar)iter++;
+	}
+	END_STD_LOOP
+
+	ierr = DMDAVecRestoreArray(lvl->DA_CEN, lvl->ind, &ind); CHKERRQ(ierr);
+
+	LOCAL_TO_LOCAL(lvl->DA_CEN, lvl->ind)
+
+	if(fine)
+	{
+		// preallocate prolongation matrix (trilinear stencil)
+		ierr = DMDAGetCorners(fine->DA_CEN, NULL, NULL, NULL, &nx, &ny, &nz); CHKERRQ(ierr);
+
+		lnfine = nx*ny*nz;
+
+		ierr = MatAIJCreate(lnfine, ln, 8, NULL, 7, NULL, &lvl->P); CHKERRQ(ierr);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode TMGLevelDestroy(TMGLevel *lvl)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(lvl->P)
+	{
+		ierr = DMDestroy(&lvl->DA_CEN); CHKERRQ(ierr);
+		ierr = MatDestroy(&lvl->P);     CHKERRQ(ierr);
+	}
+
+	ierr = VecDestroy(&lvl->k);         CHKERRQ(ierr);
+	ierr = VecDestroy(&lvl->ind);       CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode TMGLevelRestrictCond(TMGLevel *lvl, TMGLevel *fine)
+{
+	// restrict conductivity from fine to coarse level (see MGLevelRestrictEta)
+
+	PetscInt    I, J, K, JJ;
+	PetscInt    i, j, k, nx, ny, nz, sx, sy, sz, refine_y;
+	PetscScalar sum, ***ck, ***fk;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = DMDAGetRefinementFactor(fine->DA_CEN, NULL, &refine_y, NULL); CHKERRQ(ierr);
+
+	ierr = DMDAVecGetArray(lvl->DA_CEN,  lvl->k,  &ck); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fine->DA_CEN, fine->k, &fk); CHKERRQ(ierr);
+
+	ierr = DMDAGetCorners(lvl->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz); CHKERRQ(ierr);
+
+	START_STD_LOOP
+	{
+		// get fine grid indices
+		I  = 2*i;
+		J  = refine_y*j;
+		K  = 2*k;
+		JJ = J + refine_y - 1;
+
+		// compute average conductivity (y-direction is not coarsened in 2D)
+		sum = fk[K  ][J ][I  ]
+		+     fk[K  ][J ][I+1]
+		+     fk[K  ][JJ][I  ]
+		+     fk[K  ][JJ][I+1]
+		+     fk[K+1][J ][I  ]
+		+     fk[K+1][J ][I+1]
+		+     fk[K+1][JJ][I  ]
+		+     fk[K+1][JJ][I+1];
+
+		ck[k][j][i] = sum/8.0;
+	}
+	END_STD_LOOP
+
+	ierr = DMDAVecRestoreArray(lvl->DA_CEN,  lvl->k,  &ck); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fine->DA_CEN, fine->k, &fk); CHKERRQ(ierr);
+
+	// exchange ghost points
+	LOCAL_TO_LOCAL(lvl->DA_CEN, lvl->k)
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode TMGLevelSetupProlong(TMGLevel *lvl, TMGLevel *fine)
+{
+	// assemble cell-centered trilinear prolongation operator
+	// Every fine cell interpolates from the parent coarse cell (weight 3/4)
+	// and the nearest coarse neighbor (weight 1/4) in every direction.
+	// Neighbors outside domain are discarded. Weights are scaled with the
+	// coarse cell conductivities and normalized.
+
+	PetscInt    I, J, K, II, JJ, KK, dI, dJ, dK, ii, jj, kk, n, row, idx[8];
+	PetscInt    i, j, k, nx, ny, nz, sx, sy, sz, refine_y;
+	PetscScalar wx[2], wy[2], wz[2], w, sum, v[8];
+	PetscScalar ***ck, ***cind, ***find;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = DMDAGetRefinementFactor(fine->DA_CEN, NULL, &refine_y, NULL); CHKERRQ(ierr);
+
+	ierr = DMDAVecGetArray(lvl->DA_CEN,  lvl->k,    &ck);   CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(lvl->DA_CEN,  lvl->ind,  &cind); CHKERRQ(ierr);
+	ierr = DMDAVecGetArray(fine->DA_CEN, fine->ind, &find); CHKERRQ(ierr);
+
+	ierr = DMDAGetCorners(fine->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz); CHKERRQ(ierr);
+
+	START_STD_LOOP
+	{
+		// get parent cell indices
+		I = i/2;
+		J = j/refine_y;
+		K = k/2;
+
+		// get nearest neighbor directions
+		dI = (i % 2) ? 1 : -1;
+		dJ = (j % 2) ? 1 : -1;
+		dK = (k % 2) ? 1 : -1;
+
+		if(refine_y == 1) dJ = 0;
+
+		// set 1D weights
+		wx[0] = 0.75; wx[1] = 0.25; if(cind[K][J][I+dI] < 0.0)      { wx[0] = 1.0; wx[1] = 0.0; }
+		wy[0] = 0.75; wy[1] = 0.25; if(!dJ || cind[K][J+dJ][I] < 0.0) { wy[0] = 1.0; wy[1] = 0.0; }
+		wz[0] = 0.75; wz[1] = 0.25; if(cind[K+dK][J][I] < 0.0)      { wz[0] = 1.0; wz[1] = 0.0; }
+
+		// assemble row
+		n   = 0;
+		sum = 0.0;
+
+		for(kk = 0; kk < 2; kk++)
+		for(jj = 0; jj < 2; jj++)
+		for(ii = 0; ii < 2; ii++)
+		{
+			w = wx[ii]*wy[jj]*wz[kk];
+
+			if(w == 0.0) continue;
+
+			II = I + ii*dI;
+			JJ = J + jj*dJ;
+			KK = K + kk*dK;
+
+			idx[n] = (PetscInt)cind[KK][JJ][II];
+			v  [n] = w*ck[KK][JJ][II];
+			sum   += v[n];
+			n++;
+		}
+
+		for(ii = 0; ii < n; ii++) v[ii] /= sum;
+
+		row = (PetscInt)find[k][j][i];
+
+		ierr = MatSetValues(lvl->P, 1, &row, n, idx, v, INSERT_VALUES); CHKERRQ(ierr);
+	}
+	END_STD_LOOP
+
+	ierr = DMDAVecRestoreArray(lvl->DA_CEN,  lvl->k,    &ck);   CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(lvl->DA_CEN,  lvl->ind,  &cind); CHKERRQ(ierr);
+	ierr = DMDAVecRestoreArray(fine->DA_CEN, fine->ind, &find); CHKERRQ(ierr);
+
+	// assemble prolongation matrix
+	ierr = MatAIJAssemble(lvl->P, 0, NULL, 0.0); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode TMGCreate(TMG *mg, JacRes *jr)
+{
+	PetscInt  i, l;
+	TMGLevel *fine;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// clear object
+	ierr = PetscMemzero(mg, sizeof(TMG)); CHKERRQ(ierr);
+
+	// store finest grid context
+	mg->jr = jr;
+
+	// check multigrid mesh restrictions & get actual number of levels
+	ierr = TMGGetNumLevels(mg); CHKERRQ(ierr);
+
+	// allocate & create levels
+	ierr = PetscMalloc(sizeof(TMGLevel)*(size_t)mg->nlvl, &mg->lvls); CHKERRQ(ierr);
+
+	fine = NULL;
+
+	for(i = 0; i < mg->nlvl; i++)
+	{
+		ierr = TMGLevelCreate(&mg->lvls[i], fine, jr->fs); CHKERRQ(ierr);
+
+		fine = &mg->lvls[i];
+	}
+
+	// create Galerkin multigrid preconditioner
+	ierr = PCCreate(PETSC_COMM_WORLD, &mg->pc);          CHKERRQ(ierr);
+	ierr = PCSetOptionsPrefix(mg->pc, "tmg_");           CHKERRQ(ierr);
+	ierr = PCSetType(mg->pc, PCMG);                      CHKERRQ(ierr);
+	ierr = PCMGSetLevels(mg->pc, mg->nlvl, NULL);        CHKERRQ(ierr);
+	ierr = PCMGSetType(mg->pc, PC_MG_MULTIPLICATIVE);    CHKERRQ(ierr);
+	ierr = PCMGSetGalerkin(mg->pc, PC_MG_GALERKIN_BOTH); CHKERRQ(ierr);
+	ierr = PCSetFromOptions(mg->pc);                     CHKERRQ(ierr);
+
+	// attach prolongation matrices (restriction is transpose)
+	for(i = 1, l = mg->nlvl-1; i < mg->nlvl; i++, l--)
+	{
+		ierr = PCMGSetInterpolation(mg->pc, l, mg->lvls[i].P); CHKERRQ(ierr);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode TMGDestroy(TMG *mg)
+{
+	PetscInt i;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PCDestroy(&mg->pc); CHKERRQ(ierr);
+
+	for(i = 0; i < mg->nlvl; i++)
+	{
+		ierr = TMGLevelDestroy(&mg->lvls[i]); CHKERRQ(ierr);
+	}
+
+	ierr = PetscFree(mg->lvls); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode TMGInitCond(TMG *mg, PetscBool *changed)
+{
+	// copy conductivity computed during matrix assembly to the finest level,
+	// check whether it has changed since the last setup
+
+	TMGLevel    *lvl;
+	JacRes      *jr;
+	PetscMPIInt  lflag, gflag;
+	PetscScalar  ***kc, cond;
+	PetscInt     i, j, k, nx, ny, nz, sx, sy, sz, iter;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	lvl   = mg->lvls;
+	jr    = mg->jr;
+	lflag = 0;
+
+	ierr = DMDAVecGetArray(lvl->DA_CEN, lvl->k, &kc); CHKERRQ(ierr);
+
+	iter = 0;
+
+	ierr = DMDAGetCorners(lvl->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz); CHKERRQ(ierr);
+
+	START_STD_LOOP
+	{
+		cond = jr->svCell[iter++].svBulk.cond;
+
+		if(kc[k][j][i] != cond) lflag = 1;
+
+		kc[k][j][i] = cond;
+	}
+	END_STD_LOOP
+
+	ierr = DMDAVecRestoreArray(lvl->DA_CEN, lvl->k, &kc); CHKERRQ(ierr);
+
+	// exchange ghost points
+	LOCAL_TO_LOCAL(lvl->DA_CEN, lvl->k)
+
+	// synchronize flag
+	ierr = MPI_Allreduce(&lflag, &gflag, 1, MPI_INT, MPI_MAX, PETSC_COMM_WORLD); CHKERRQ(ierr);
+
+	if(gflag) (*changed) = PETSC_TRUE;
+	else      (*changed) = PETSC_FALSE;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode TMGSetPC(TMG *mg, KSP ksp)
+{
+	// set multigrid as shell preconditioner of temperature solver
+	// (setup is called with every operator update)
+
+	PC pc;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = KSPGetPC(ksp, &pc);            CHKERRQ(ierr);
+	ierr = PCSetType(pc, PCSHELL);        CHKERRQ(ierr);
+	ierr = PCShellSetContext(pc, mg);     CHKERRQ(ierr);
+	ierr = PCShellSetSetUp(pc, TMGSetup); CHKERRQ(ierr);
+	ierr = PCShellSetApply(pc, TMGApply); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode TMGSetup(PC pc)
+{
+	// setup function of the shell preconditioner
+	// Prolongation operators are only recomputed if conductivity changes,
+	// Galerkin coarse operators are always updated.
+
+	TMG       *mg;
+	Mat        A;
+	PetscInt   i;
+	PetscBool  changed;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PCShellGetContext(pc, (void**)&mg); CHKERRQ(ierr);
+	ierr = PCGetOperators(pc, NULL, &A);       CHKERRQ(ierr);
+
+	// update fine level conductivity
+	ierr = TMGInitCond(mg, &changed); CHKERRQ(ierr);
+
+	if(changed == PETSC_TRUE || mg->valid != PETSC_TRUE)
+	{
+		for(i = 1; i < mg->nlvl; i++)
+		{
+			ierr = TMGLevelRestrictCond(&mg->lvls[i], &mg->lvls[i-1]); CHKERRQ(ierr);
+			ierr = TMGLevelSetupProlong(&mg->lvls[i], &mg->lvls[i-1]); CHKERRQ(ierr);
+		}
+
+		mg->valid = PETSC_TRUE;
+	}
+
+	// recompute coarse grid operators
+	ierr = PCSetOperators(mg->pc, A, A); CHKERRQ(ierr);
+	ierr = PCSetUp(mg->pc);              CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode TMGApply(PC pc, Vec x, Vec y)
+{
+	TMG *mg;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = PCShellGetContext(pc, (void**)&mg); CHKERRQ(ierr);
+
+	// apply multigrid preconditioner
+	ierr = PCApply(mg->pc, x, y); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode TMGGetNumLevels(TMG *mg)
+{
+	// check multigrid mesh restrictions, get actual number of levels
+	// (all possible coarsening steps are used by default)
+
+	FDSTAG   *fs;
+	PetscInt  nx, ny, nz, ncors, nlevels, refine_y;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	fs = mg->jr->fs;
+
+	// get refinement factor in y-direction (don't refine in y-direction in 2D)
+	refine_y = 2;
+	ierr = PetscOptionsGetInt(NULL, NULL, "-da_refine_y", &refine_y, NULL); CHKERRQ(ierr);
+
+	// check discretization in all directions
+	ierr = Discret1DCheckMG(&fs->dsx, "x", &nx); CHKERRQ(ierr);                ncors = nx;
+
+	if(refine_y > 1)
+	{
+		ierr = Discret1DCheckMG(&fs->dsy, "y", &ny); CHKERRQ(ierr);
+		if(ny < ncors) ncors = ny;
+	}
+
+	ierr = Discret1DCheckMG(&fs->dsz, "z", &nz); CHKERRQ(ierr); if(nz < ncors) ncors = nz;
+
+	// check number of levels requested on the command line
+	nlevels = ncors+1;
+
+	ierr = PetscOptionsGetInt(NULL, NULL, "-tmg_pc_mg_levels", &nlevels, NULL); CHKERRQ(ierr);
+
+	if(nlevels < 2 || nlevels > ncors+1)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Incorrect # of temperature multigrid levels specified. Requested: %lld. Max. possible: %lld", (LLD)nlevels, (LLD)(ncors+1));
+	}
+
+	ierr = PetscPrintf(PETSC_COMM_WORLD, "   Temperature multigrid levels  :  %lld\n", (LLD)nlevels); CHKERRQ(ierr);
+
+	// store number of levels
+	mg->nlvl = nlevels;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
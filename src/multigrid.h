@@ -36,6 +36,7 @@ struct MGLevel
 	Vec       bcvx, bcvy, bcvz, bcp; // restricted boundary condition vectors
 	Vec       eta, etax, etay, etaz; // viscosity vectors
 	Mat       R, P;                  // restriction & prolongation operators (not set on finest grid)
+	Mat       Af, Rf, Pf;            // single precision copies of level, restriction & prolongation operators
 
 
 	// ******** fine level ************
@@ -105,6 +106,7 @@ struct MG
 
 	PetscBool crs_setup;     // coarse solver setup flag
 	PetscBool no_restric_bc; // boundary constraint restriction deactivation flag
+	PetscBool mixed;         // single precision level operators flag (except coarse grid)
 
 };
 
@@ -118,11 +120,73 @@ PetscErrorCode MGSetupCoarse(MG *mg, Mat A);
 
 PetscErrorCode MGSetup(MG *mg, Mat A);
 
+PetscErrorCode MGSetupMixed(MG *mg);
+
+PetscErrorCode MGRestoreMixed(MG *mg);
+
 PetscErrorCode MGApply(PC pc, Vec x, Vec y);
 
 PetscErrorCode MGDumpMat(MG *mg);
 
 PetscErrorCode MGGetNumLevels(MG *mg);
 
+//---------------------------------------------------------------------------
+//...................   TEMPERATURE GEOMETRIC MULTIGRID   ...................
+//---------------------------------------------------------------------------
+
+// Cell-centered Galerkin multigrid for the energy equation.
+// Coarse grids follow the coarsening sequence of the velocity multigrid.
+// Prolongation is trilinear, weighted with the restricted conductivity.
+// Restriction is the transpose of prolongation (set by PCMG).
+
+struct TMGLevel
+{
+	DM  DA_CEN; // central points array (ghosted box stencil)
+	Vec k;      // conductivity
+	Vec ind;    // global indices of cells
+	Mat P;      // prolongation operator (not set on finest grid)
+
+} ;
+
+//---------------------------------------------------------------------------
+
+PetscErrorCode TMGLevelCreate(TMGLevel *lvl, TMGLevel *fine, FDSTAG *fs);
+
+PetscErrorCode TMGLevelDestroy(TMGLevel *lvl);
+
+PetscErrorCode TMGLevelRestrictCond(TMGLevel *lvl, TMGLevel *fine);
+
+PetscErrorCode TMGLevelSetupProlong(TMGLevel *lvl, TMGLevel *fine);
+
+//---------------------------------------------------------------------------
+
+struct TMG
+{
+	// LaMEM level numbering (0 - fine grid), see MG
+
+	PetscInt  nlvl;  // number of levels
+	TMGLevel *lvls;  // multigrid levels
+	PC        pc;    // internal preconditioner context
+	JacRes   *jr;    // finest level context
+	PetscBool valid; // prolongation operators match current conductivity
+
+};
+
+//---------------------------------------------------------------------------
+
+PetscErrorCode TMGCreate(TMG *mg, JacRes *jr);
+
+PetscErrorCode TMGDestroy(TMG *mg);
+
+PetscErrorCode TMGInitCond(TMG *mg, PetscBool *changed);
+
+PetscErrorCode TMGSetPC(TMG *mg, KSP ksp);
+
+PetscErrorCode TMGSetup(PC pc);
+
+PetscErrorCode TMGApply(PC pc, Vec x, Vec y);
+
+PetscErrorCode TMGGetNumLevels(TMG *mg);
+
 //---------------------------------------------------------------------------
 #endif
@@ -48,7 +48,7 @@ PetscErrorCode NLSolCreate(NLSol *nl, PCStokes pc, SNES *p_snes)
 	SNESLineSearch  ls;
 	JacRes         *jr;
 	DOFIndex       *dof;
-	PetscBool       flg;
+	PetscBool       flg, mixed, flexible;
 	SNESType        type;
 
     PetscErrorCode ierr;
@@ -94,6 +94,19 @@ PetscErrorCode NLSolCreate(NLSol *nl, PCStokes pc, SNES *p_snes)
 	ierr = KSPGetPC(ksp, &ipc);            CHKERRQ(ierr);
 	ierr = PCSetType(ipc, PCMAT);          CHKERRQ(ierr);
 
+	// single precision multigrid operators make preconditioner variable
+	ierr = PCStokesGetMixedPrecision(pc, &mixed); CHKERRQ(ierr);
+
+	if(mixed)
+	{
+		ierr = PetscObjectTypeCompareAny((PetscObject)ksp, &flexible, KSPFGMRES, KSPGCR, KSPFCG, KSPPIPEFGMRES, KSPFBCGSR, ""); CHKERRQ(ierr);
+
+		if(!flexible)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "-gmg_mixed_precision requires flexible outer Krylov solver (e.g. -js_ksp_type fgmres or gcr)\n");
+		}
+	}
+
 	ierr = SNESSetConvergenceTest(snes, &SNESCoupledTest, nl, NULL); CHKERRQ(ierr);
 
 	// initialize Jacobian controls
@@ -109,6 +122,12 @@ PetscErrorCode NLSolCreate(NLSol *nl, PCStokes pc, SNES *p_snes)
 	ierr = PetscOptionsGetInt   (NULL, NULL, "-snes_NewtonSwitchToPicard_it",   &nl->nNwtIt, &flg); CHKERRQ(ierr);
 	ierr = PetscOptionsGetScalar(NULL, NULL, "-snes_NewtonSwitchToPicard_rtol", &nl->rtolNwt, &flg); CHKERRQ(ierr);
 
+	// activate Krylov subspace recycling
+	ierr = NLSolRecycleCreate(nl, snes); CHKERRQ(ierr);
+
+	// activate extrapolated initial guess
+	ierr = NLSolPredictCreate(nl); CHKERRQ(ierr);
+
 	// return solver
 	(*p_snes) = snes;
 
@@ -166,6 +185,8 @@ PetscErrorCode DisplaySpecifiedSolverOptions(PCStokes pc, SNES snes)
 	ierr = SNESGetKSP(snes, &ksp);         CHKERRQ(ierr);
 	KSPGetType(ksp, &ksp_type);
 	PetscPrintf(PETSC_COMM_WORLD, "   Outermost Krylov solver       : %s \n", ksp_type);
+	ierr = PetscOptionsGetInt(NULL, NULL,"-js_recycle", &integer, &found); CHKERRQ(ierr);
+	if (found && integer > 0 && !strcmp(ksp_type, KSPGMRES)){PetscPrintf(PETSC_COMM_WORLD, "   Krylov recycling space size   : %lld \n", (LLD) integer); }
 	if (pc->type == _STOKES_MG_){
 		
 		mg 		= 	(PCStokesMG*)pc->data; // retrieve MG object
@@ -308,6 +329,10 @@ PetscErrorCode NLSolDestroy(NLSol *nl)
 	ierr = MatDestroy(&nl->P);    CHKERRQ(ierr);
 	ierr = MatDestroy(&nl->MFFD); CHKERRQ(ierr);
 
+	ierr = NLSolRecycleDestroy(nl); CHKERRQ(ierr);
+
+	ierr = NLSolPredictDestroy(nl); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -455,6 +480,418 @@ PetscErrorCode FormJacobian(SNES snes, Vec x, Mat Amat, Mat Pmat, void *ctx)
 	ierr = MatAssemblyBegin(nl->J, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
 	ierr = MatAssemblyEnd  (nl->J, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
 
+	// recycle space image must be recomputed for new Jacobian
+	if(nl->nrec)
+	{
+		ierr = MatAssemblyBegin(nl->PD, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+		ierr = MatAssemblyEnd  (nl->PD, MAT_FINAL_ASSEMBLY); CHKERRQ(ierr);
+
+		nl->Cvalid = PETSC_FALSE;
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode NLSolRecycleCreate(NLSol *nl, SNES snes)
+{
+	// Recycle slow Krylov directions across consecutive linear solves.
+	// Harmonic Ritz vectors U of the last solve are deflated by the
+	// preconditioner M_D^{-1} = U*C' + M^{-1}*(I - C*C'), with C = J*U orthonormal,
+	// which maps U to an invariant subspace with unit eigenvalue.
+	// The space survives Newton iterations and time steps, C is refreshed
+	// whenever the Jacobian changes.
+
+	KSP       ksp;
+	PCSide    side;
+	DOFIndex  *dof;
+	PetscBool flg, gmres, mixed;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	nl->nrec = 0;
+
+	ierr = PetscOptionsGetInt(NULL, NULL, "-js_recycle", &nl->nrec, &flg); CHKERRQ(ierr);
+
+	if(nl->nrec <= 0) { nl->nrec = 0; PetscFunctionReturn(0); }
+
+	// single precision multigrid requires flexible solver, recycling requires GMRES
+	ierr = PCStokesGetMixedPrecision(nl->pc, &mixed); CHKERRQ(ierr);
+
+	if(mixed)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "-js_recycle and -gmg_mixed_precision are incompatible\n");
+	}
+
+	// harmonic Ritz vectors are only available for (non-flexible) GMRES
+	ierr = SNESGetKSP(snes, &ksp);                                      CHKERRQ(ierr);
+	ierr = PetscObjectTypeCompare((PetscObject)ksp, KSPGMRES, &gmres); CHKERRQ(ierr);
+
+	if(!gmres)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "WARNING! Krylov recycling requires -js_ksp_type gmres, deactivating\n");
+
+		nl->nrec = 0;
+
+		PetscFunctionReturn(0);
+	}
+
+	// deflation of the solution space is only valid for left preconditioning
+	ierr = KSPGetPCSide(ksp, &side); CHKERRQ(ierr);
+
+	if(side != PC_LEFT && side != PC_SIDE_DEFAULT)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "WARNING! Krylov recycling requires left preconditioning (-js_ksp_pc_side left), deactivating\n");
+
+		nl->nrec = 0;
+
+		PetscFunctionReturn(0);
+	}
+
+	dof = &(nl->pc->pm->jr->fs->dof);
+
+	// extract half of the space after every solve, keep the rest from previous solves
+	nl->nrit = (nl->nrec+1)/2;
+	nl->nu   = 0;
+
+	// allocate storage
+	ierr = VecDuplicateVecs(nl->pc->pm->jr->gsol, nl->nrec, &nl->U); CHKERRQ(ierr);
+	ierr = VecDuplicateVecs(nl->pc->pm->jr->gsol, nl->nrec, &nl->C); CHKERRQ(ierr);
+	ierr = VecDuplicateVecs(nl->pc->pm->jr->gsol, nl->nrit, &nl->S); CHKERRQ(ierr);
+	ierr = VecDuplicate    (nl->pc->pm->jr->gsol, &nl->wrk);         CHKERRQ(ierr);
+
+	ierr = PetscMalloc1(nl->nrec, &nl->w);     CHKERRQ(ierr);
+	ierr = PetscMalloc1(nl->nrit, &nl->tetar); CHKERRQ(ierr);
+	ierr = PetscMalloc1(nl->nrit, &nl->tetai); CHKERRQ(ierr);
+
+	// create deflated preconditioner operator
+	ierr = MatCreateShell(PETSC_COMM_WORLD, dof->ln, dof->ln,
+		PETSC_DETERMINE, PETSC_DETERMINE, (void*)nl, &nl->PD);                           CHKERRQ(ierr);
+	ierr = MatShellSetOperation(nl->PD, MATOP_MULT, (void(*)(void))NLSolRecycleApply); CHKERRQ(ierr);
+	ierr = MatSetUp(nl->PD);                                                           CHKERRQ(ierr);
+
+	// replace preconditioner operator
+	ierr = SNESSetJacobian(snes, nl->J, nl->PD, &FormJacobian, nl); CHKERRQ(ierr);
+
+	// harmonic Ritz pairs must be requested before setup
+	ierr = KSPSetComputeRitz(ksp, PETSC_TRUE);                      CHKERRQ(ierr);
+	ierr = KSPSetPostSolve(ksp, &NLSolRecycleUpdate, (void*)nl);    CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode NLSolRecycleDestroy(NLSol *nl)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!nl->nrec) PetscFunctionReturn(0);
+
+	ierr = VecDestroyVecs(nl->nrec, &nl->U); CHKERRQ(ierr);
+	ierr = VecDestroyVecs(nl->nrec, &nl->C); CHKERRQ(ierr);
+	ierr = VecDestroyVecs(nl->nrit, &nl->S); CHKERRQ(ierr);
+	ierr = VecDestroy(&nl->wrk);             CHKERRQ(ierr);
+	ierr = MatDestroy(&nl->PD);              CHKERRQ(ierr);
+	ierr = PetscFree(nl->w);                 CHKERRQ(ierr);
+	ierr = PetscFree(nl->tetar);             CHKERRQ(ierr);
+	ierr = PetscFree(nl->tetai);             CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode NLSolRecycleSetup(NLSol *nl)
+{
+	// compute C = J*U, orthonormalize C by modified Gram-Schmidt,
+	// apply the same transformation to U to preserve C = J*U
+
+	PetscInt    i, j, n;
+	PetscScalar h, nrm, nrm0;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	n = 0;
+
+	for(i = 0; i < nl->nu; i++)
+	{
+		if(i != n)
+		{
+			ierr = VecCopy(nl->U[i], nl->U[n]); CHKERRQ(ierr);
+		}
+
+		ierr = MatMult(nl->J, nl->U[n], nl->C[n]); CHKERRQ(ierr);
+		ierr = VecNorm(nl->C[n], NORM_2, &nrm0);   CHKERRQ(ierr);
+
+		for(j = 0; j < n; j++)
+		{
+			ierr = VecDot (nl->C[n], nl->C[j], &h); CHKERRQ(ierr);
+			ierr = VecAXPY(nl->C[n], -h, nl->C[j]); CHKERRQ(ierr);
+			ierr = VecAXPY(nl->U[n], -h, nl->U[j]); CHKERRQ(ierr);
+		}
+
+		ierr = VecNorm(nl->C[n], NORM_2, &nrm); CHKERRQ(ierr);
+
+		// drop (nearly) linearly dependent directions
+		if(nrm <= 1e-8*nrm0) continue;
+
+		ierr = VecScale(nl->C[n], 1.0/nrm); CHKERRQ(ierr);
+		ierr = VecScale(nl->U[n], 1.0/nrm); CHKERRQ(ierr);
+
+		n++;
+	}
+
+	nl->nu     = n;
+	nl->Cvalid = PETSC_TRUE;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode NLSolRecycleUpdate(KSP ksp, Vec b, Vec x, void *ctx)
+{
+	NLSol              *nl;
+	KSPConvergedReason reason;
+	PetscInt           i, its, nrit, nold;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// clear unused parameters
+	if(b) b = NULL;
+	if(x) x = NULL;
+
+	// access context
+	nl = (NLSol*)ctx;
+
+	// skip failed or trivial solves
+	ierr = KSPGetConvergedReason(ksp, &reason); CHKERRQ(ierr);
+	ierr = KSPGetIterationNumber(ksp, &its);    CHKERRQ(ierr);
+
+	if(reason < 0 || its < 2) PetscFunctionReturn(0);
+
+	// get harmonic Ritz vectors of smallest harmonic Ritz values (last restart cycle)
+	nrit = nl->nrit;
+
+	ierr = KSPComputeRitz(ksp, PETSC_FALSE, PETSC_TRUE, &nrit, nl->S, nl->tetar, nl->tetai); CHKERRQ(ierr);
+
+	if(!nrit) PetscFunctionReturn(0);
+
+	// shift previous space, put new vectors in front
+	nold = PetscMin(nl->nu, nl->nrec - nrit);
+
+	for(i = nold-1; i >= 0; i--)
+	{
+		ierr = VecCopy(nl->U[i], nl->U[i+nrit]); CHKERRQ(ierr);
+	}
+
+	for(i = 0; i < nrit; i++)
+	{
+		ierr = VecCopy(nl->S[i], nl->U[i]); CHKERRQ(ierr);
+	}
+
+	nl->nu     = nrit + nold;
+	nl->Cvalid = PETSC_FALSE;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode NLSolRecycleApply(Mat PD, Vec r, Vec y)
+{
+	NLSol    *nl;
+	PetscInt  i;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// access context
+	ierr = MatShellGetContext(PD, (void**)&nl); CHKERRQ(ierr);
+
+	// refresh image of recycle space
+	if(!nl->Cvalid)
+	{
+		ierr = NLSolRecycleSetup(nl); CHKERRQ(ierr);
+	}
+
+	// plain preconditioner until recycle space is available
+	if(!nl->nu)
+	{
+		ierr = MatMult(nl->P, r, y); CHKERRQ(ierr);
+
+		PetscFunctionReturn(0);
+	}
+
+	// w = C'*r
+	ierr = VecMDot(r, nl->nu, nl->C, nl->w); CHKERRQ(ierr);
+
+	// wrk = r - C*w
+	ierr = VecCopy(r, nl->wrk); CHKERRQ(ierr);
+
+	for(i = 0; i < nl->nu; i++) nl->w[i] = -nl->w[i];
+
+	ierr = VecMAXPY(nl->wrk, nl->nu, nl->w, nl->C); CHKERRQ(ierr);
+
+	// y = M^{-1}*wrk + U*w
+	ierr = MatMult(nl->P, nl->wrk, y); CHKERRQ(ierr);
+
+	for(i = 0; i < nl->nu; i++) nl->w[i] = -nl->w[i];
+
+	ierr = VecMAXPY(y, nl->nu, nl->w, nl->U); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode NLSolPredictCreate(NLSol *nl)
+{
+	PetscInt  i, order;
+	PetscBool flg;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	order     = 0;
+	nl->npred = 0;
+	nl->nsol  = 0;
+
+	ierr = PetscOptionsGetInt(NULL, NULL, "-snes_predictor_order", &order, &flg); CHKERRQ(ierr);
+
+	if(order <= 0) PetscFunctionReturn(0);
+
+	if(order > 2)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Extrapolation order must be 1 (linear) or 2 (quadratic)\n");
+	}
+
+	nl->npred = order + 1;
+
+	for(i = 0; i < nl->npred; i++)
+	{
+		ierr = VecDuplicate(nl->pc->pm->jr->gsol, &nl->xsol[i]); CHKERRQ(ierr);
+	}
+
+	ierr = VecDuplicate(nl->pc->pm->jr->gsol, &nl->xpred); CHKERRQ(ierr);
+
+	PetscPrintf(PETSC_COMM_WORLD, "Initial guess extrapolation order  : %lld \n", (LLD)order);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode NLSolPredictDestroy(NLSol *nl)
+{
+	PetscInt i;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!nl->npred) PetscFunctionReturn(0);
+
+	for(i = 0; i < nl->npred; i++)
+	{
+		ierr = VecDestroy(&nl->xsol[i]); CHKERRQ(ierr);
+	}
+
+	ierr = VecDestroy(&nl->xpred); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode NLSolPredict(NLSol *nl, SNES snes, Vec x)
+{
+	// Lagrange extrapolation in time from previous converged solutions,
+	// falls back to the previous solution if the residual does not decrease
+
+	JacRes      *jr;
+	PetscInt    i, j, n;
+	PetscScalar t, L[3], nrm, nrmp;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// clear unused parameters
+	if(snes) snes = NULL;
+
+	if(nl->nsol < 2) PetscFunctionReturn(0);
+
+	// access context
+	jr = nl->pc->pm->jr;
+	t  = jr->ts->time;
+	n  = nl->nsol;
+
+	// compute Lagrange weights (time steps are taken from stored time stamps)
+	for(i = 0; i < n; i++)
+	{
+		L[i] = 1.0;
+
+		for(j = 0; j < n; j++)
+		{
+			if(j != i) L[i] *= (t - nl->tsol[j])/(nl->tsol[i] - nl->tsol[j]);
+		}
+	}
+
+	ierr = VecSet  (nl->xpred, 0.0);               CHKERRQ(ierr);
+	ierr = VecMAXPY(nl->xpred, n, L, nl->xsol);    CHKERRQ(ierr);
+
+	// compare residuals of previous and extrapolated solutions
+	ierr = JacResFormResidual(jr, x, jr->gres);         CHKERRQ(ierr);
+	ierr = VecNorm(jr->gres, NORM_2, &nrm);             CHKERRQ(ierr);
+	ierr = JacResFormResidual(jr, nl->xpred, jr->gres); CHKERRQ(ierr);
+	ierr = VecNorm(jr->gres, NORM_2, &nrmp);            CHKERRQ(ierr);
+
+	if(nrmp < nrm)
+	{
+		ierr = VecCopy(nl->xpred, x); CHKERRQ(ierr);
+
+		PetscPrintf(PETSC_COMM_WORLD, "Extrapolated initial guess accepted: |F|_2 = %e (previous %e) \n", nrmp, nrm);
+	}
+	else
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "Extrapolated initial guess rejected: |F|_2 = %e (previous %e) \n", nrmp, nrm);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode NLSolPredictStore(NLSol *nl, SNES snes, Vec x)
+{
+	Vec                 tmp;
+	PetscInt            i;
+	PetscScalar         t;
+	SNESConvergedReason reason;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!nl->npred) PetscFunctionReturn(0);
+
+	t = nl->pc->pm->jr->ts->time;
+
+	// discard history after failed solves
+	ierr = SNESGetConvergedReason(snes, &reason); CHKERRQ(ierr);
+
+	if(reason < 0) { nl->nsol = 0; PetscFunctionReturn(0); }
+
+	// repeated solve at the same time (time step restart), replace newest solution
+	if(nl->nsol && t <= nl->tsol[0])
+	{
+		ierr = VecCopy(x, nl->xsol[0]); CHKERRQ(ierr);
+
+		PetscFunctionReturn(0);
+	}
+
+	// rotate storage, put new solution in front
+	tmp = nl->xsol[nl->npred-1];
+
+	for(i = nl->npred-1; i > 0; i--)
+	{
+		nl->xsol[i] = nl->xsol[i-1];
+		nl->tsol[i] = nl->tsol[i-1];
+	}
+
+	nl->xsol[0] = tmp;
+	nl->tsol[0] = t;
+
+	ierr = VecCopy(x, nl->xsol[0]); CHKERRQ(ierr);
+
+	if(nl->nsol < nl->npred) nl->nsol++;
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
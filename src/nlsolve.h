@@ -82,6 +82,27 @@ struct NLSol
 	PetscInt    nNwtIt;   // number of Newton iterations before switch to Picard
 	PetscScalar rtolNwt;  // Newton divergence tolerance
 
+	// Krylov subspace recycling (deflation)
+	PetscInt    nrec;     // maximum size of recycle space (0 - deactivated)
+	PetscInt    nrit;     // number of harmonic Ritz vectors extracted per solve
+	PetscInt    nu;       // actual size of recycle space
+	Vec        *U;        // recycle space (slow directions of preconditioned operator)
+	Vec        *C;        // image of recycle space (C = J*U, orthonormal)
+	Vec        *S;        // harmonic Ritz vectors of last solve
+	Vec         wrk;      // work vector
+	PetscScalar *w;       // projection coefficients
+	PetscReal  *tetar;    // harmonic Ritz values (real part)
+	PetscReal  *tetai;    // harmonic Ritz values (imaginary part)
+	PetscBool   Cvalid;   // image is consistent with current Jacobian
+	Mat         PD;       // deflated preconditioner
+
+	// extrapolated initial guess
+	PetscInt    npred;    // number of solutions used for extrapolation (0 - deactivated)
+	PetscInt    nsol;     // number of stored solutions
+	Vec         xsol[3];  // previous converged solutions (newest first)
+	PetscScalar tsol[3];  // time stamps of stored solutions
+	Vec         xpred;    // extrapolated solution
+
 } ;
 
 //---------------------------------------------------------------------------
@@ -102,6 +123,33 @@ PetscErrorCode FormJacobian(SNES snes, Vec x, Mat Amat, Mat Pmat, void *ctx);
 
 //---------------------------------------------------------------------------
 
+// Krylov subspace recycling across linear solves (-js_recycle <size>)
+PetscErrorCode NLSolRecycleCreate(NLSol *nl, SNES snes);
+
+PetscErrorCode NLSolRecycleDestroy(NLSol *nl);
+
+// compute and orthonormalize image of recycle space for current Jacobian
+PetscErrorCode NLSolRecycleSetup(NLSol *nl);
+
+// extract harmonic Ritz vectors after every linear solve
+PetscErrorCode NLSolRecycleUpdate(KSP ksp, Vec b, Vec x, void *ctx);
+
+// apply deflated preconditioner y = U*C'*r + M^{-1}*(r - C*C'*r)
+PetscErrorCode NLSolRecycleApply(Mat PD, Vec r, Vec y);
+//---------------------------------------------------------------------------
+
+// extrapolated initial guess from previous time steps (-snes_predictor_order <1,2>)
+PetscErrorCode NLSolPredictCreate(NLSol *nl);
+
+PetscErrorCode NLSolPredictDestroy(NLSol *nl);
+
+// replace initial guess by extrapolated solution if it reduces the residual
+PetscErrorCode NLSolPredict(NLSol *nl, SNES snes, Vec x);
+
+// store converged solution of current time step
+PetscErrorCode NLSolPredictStore(NLSol *nl, SNES snes, Vec x);
+//---------------------------------------------------------------------------
+
 PetscErrorCode JacApplyMFFD(Mat A, Vec x, Vec y);
 
 //---------------------------------------------------------------------------
@@ -75,6 +75,9 @@ struct ModParam
 	PetscScalar      mfit, mfitCenter;                  // misfit value for current model parameters
     DBMat            dbm_modified;                      // holds the (modified) LaMEM material database
 	FB 				*fb;								// holds a copy of the filebuffer	
+	PetscInt         reuse;                             // keep forward model in memory & restore initial state between runs
+	void            *model;                             // forward model kept in memory (LaMEMModel)
+	PetscInt         warnJac;                           // warning on Newton Jacobian in adjoint solve was printed
 	PetscScalar 	 ReferenceDensity;		  			// Reference density (perturbations are computed w.r.t. this value)
 	
 	// Variables additionally needed for the adjoint TAO solver
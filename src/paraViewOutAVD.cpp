@@ -39,6 +39,7 @@
 #include "advect.h"
 #include "JacRes.h"
 #include "tools.h"
+#include "profile.h"
 //---------------------------------------------------------------------------
 #define __AVD_DEBUG_MODE
 //---------------------------------------------------------------------------
@@ -693,6 +694,8 @@ PetscErrorCode PVAVDWriteTimeStep(PVAVD *pvavd, const char *dirName, PetscScalar
 
 	if(!pvavd->outavd) PetscFunctionReturn(0);
 
+	ierr = PetscLogEventBegin(LaMEM_PVAVD, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	// create Approximate Voronoi Diagram from particles
 	ierr = AVDViewCreate(&A, pvavd->actx, pvavd->refine); CHKERRQ(ierr);
 
@@ -706,6 +709,8 @@ PetscErrorCode PVAVDWriteTimeStep(PVAVD *pvavd, const char *dirName, PetscScalar
 	// cleanup
 	AVD3DDestroy(&A);
 
+	ierr = PetscLogEventEnd(LaMEM_PVAVD, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -775,6 +780,7 @@ PetscErrorCode PVAVDWritePVTR(PVAVD *pvavd, AVD3D A, const char *dirName)
 
 	fprintf(fp, "</VTKFile>\n");
 
+	LogBytesWritten(fp);
 	fclose( fp );
 
 	PetscFunctionReturn(0);
@@ -899,6 +905,7 @@ PetscErrorCode PVAVDWriteVTR(PVAVD *pvavd, AVD3D A, const char *dirName)
 
 	fprintf(fp, "</VTKFile>\n");
 
+	LogBytesWritten(fp);
 	fclose( fp );
 
 	PetscFunctionReturn(0);
@@ -19,6 +19,7 @@
 #include "phase.h"
 #include "outFunct.h"
 #include "tools.h"
+#include "profile.h"
 //---------------------------------------------------------------------------
 // * phase-ratio output
 // * integrate AVD phase viewer
@@ -562,6 +563,8 @@ PetscErrorCode PVOutWriteTimeStep(PVOut *pvout, const char *dirName, PetscScalar
 	PetscErrorCode ierr;
 	PetscFunctionBeginUser;
 
+	ierr = PetscLogEventBegin(LaMEM_PVOut, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	// update .pvd file if necessary
 	ierr = UpdatePVDFile(dirName, pvout->outfile, "pvtr", &pvout->offset, ttime, pvout->outpvd); CHKERRQ(ierr);
 
@@ -571,6 +574,8 @@ PetscErrorCode PVOutWriteTimeStep(PVOut *pvout, const char *dirName, PetscScalar
 	// write sub-domain data .vtr files
 	ierr = PVOutWriteVTR(pvout, dirName); CHKERRQ(ierr);
 
+	ierr = PetscLogEventEnd(LaMEM_PVOut, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 
@@ -648,6 +653,7 @@ PetscErrorCode PVOutWritePVTR(PVOut *pvout, const char *dirName)
 	fprintf(fp, "</VTKFile>\n");
 
 	// close file
+	LogBytesWritten(fp);
 	fclose(fp);
 	PetscFunctionReturn(0);
 }
@@ -759,6 +765,7 @@ PetscErrorCode PVOutWriteVTR(PVOut *pvout, const char *dirName)
 	fprintf(fp, "</VTKFile>\n");
 
 	// close file
+	LogBytesWritten(fp);
 	fclose(fp);
 
 	PetscFunctionReturn(0);
@@ -18,6 +18,7 @@
 #include "advect.h"
 #include "JacRes.h"
 #include "tools.h"
+#include "profile.h"
 //---------------------------------------------------------------------------
 PetscErrorCode PVMarkCreate(PVMark *pvmark, FB *fb)
 {
@@ -60,6 +61,8 @@ PetscErrorCode PVMarkWriteTimeStep(PVMark *pvmark, const char *dirName, PetscSca
 	// check activation
 	if(!pvmark->outmark) PetscFunctionReturn(0);
 
+	ierr = PetscLogEventBegin(LaMEM_PVMark, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	// update .pvd file if necessary
 	ierr = UpdatePVDFile(dirName, pvmark->outfile, "pvtu", &pvmark->offset, ttime, pvmark->outpvd); CHKERRQ(ierr);
 
@@ -69,6 +72,8 @@ PetscErrorCode PVMarkWriteTimeStep(PVMark *pvmark, const char *dirName, PetscSca
 	// write sub-domain data .vtu files
 	ierr = PVMarkWriteVTU(pvmark, dirName); CHKERRQ(ierr);
 
+	ierr = PetscLogEventEnd(LaMEM_PVMark, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -232,6 +237,7 @@ PetscErrorCode PVMarkWriteVTU(PVMark *pvmark, const char *dirName)
 	fprintf( fp, "</VTKFile>\n");
 
 	// close file
+	LogBytesWritten(fp);
 	fclose(fp);
 
 	PetscFunctionReturn(0);
@@ -299,6 +305,7 @@ PetscErrorCode PVMarkWritePVTU(PVMark *pvmark, const char *dirName)
 	fprintf( fp, "</VTKFile>\n");
 
 	// close file and free name
+	LogBytesWritten(fp);
 	fclose(fp);
 
 	PetscFunctionReturn(0);
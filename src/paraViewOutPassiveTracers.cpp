@@ -19,6 +19,7 @@
 #include "paraViewOutPassiveTracers.h"
 #include "tools.h"
 #include "passive_tracer.h"
+#include "profile.h"
 
 //---------------------------------------------------------------------------
 PetscErrorCode PVPtrCreate(PVPtr *pvptr, FB *fb)
@@ -74,6 +75,8 @@ PetscErrorCode PVPtrWriteTimeStep(PVPtr *pvptr, const char *dirName, PetscScalar
 	// check activation
 	if(pvptr->actx->jr->ctrl.Passive_Tracer == 0) PetscFunctionReturn(0);
 
+	ierr = PetscLogEventBegin(LaMEM_PVPtr, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	// update .pvd file if necessary
 	ierr = UpdatePVDFile(dirName, pvptr->outfile, "pvtu", &pvptr->offset, ttime, pvptr->outpvd); CHKERRQ(ierr);
 
@@ -83,6 +86,8 @@ PetscErrorCode PVPtrWriteTimeStep(PVPtr *pvptr, const char *dirName, PetscScalar
 	// write sub-domain data .vtu files
 	ierr = PVPtrWriteVTU(pvptr, dirName); CHKERRQ(ierr);
 
+	ierr = PetscLogEventEnd(LaMEM_PVPtr, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -422,6 +427,7 @@ PetscErrorCode PVPtrWriteVTU(PVPtr *pvptr, const char *dirName)
 	fprintf( fp,"\n\t</AppendedData>\n");
 	fprintf( fp, "</VTKFile>\n");
 	// close file
+	LogBytesWritten(fp);
 	fclose(fp);
 
 	PetscFunctionReturn(0);
@@ -530,6 +536,7 @@ PetscErrorCode PVPtrWritePVTU(PVPtr *pvptr, const char *dirName)
 	fprintf( fp, "</VTKFile>\n");
 
 	// close file and free name
+	LogBytesWritten(fp);
 	fclose(fp);
 
 	PetscFunctionReturn(0);
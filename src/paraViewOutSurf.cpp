@@ -19,6 +19,7 @@
 #include "surf.h"
 #include "JacRes.h"
 #include "tools.h"
+#include "profile.h"
 //---------------------------------------------------------------------------
 PetscErrorCode PVSurfCreate(PVSurf *pvsurf, FB *fb)
 {
@@ -116,6 +117,8 @@ PetscErrorCode PVSurfWriteTimeStep(PVSurf *pvsurf, const char *dirName, PetscSca
 	// check activation
 	if(!pvsurf->outsurf) PetscFunctionReturn(0);
 
+	ierr = PetscLogEventBegin(LaMEM_PVSurf, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	// update .pvd file if necessary
 	ierr = UpdatePVDFile(dirName, pvsurf->outfile, "pvts", &pvsurf->offset, ttime, pvsurf->outpvd); CHKERRQ(ierr);
 
@@ -125,6 +128,8 @@ PetscErrorCode PVSurfWriteTimeStep(PVSurf *pvsurf, const char *dirName, PetscSca
 	// write sub-domain data .vts files
 	ierr = PVSurfWriteVTS(pvsurf, dirName); CHKERRQ(ierr);
 
+	ierr = PetscLogEventEnd(LaMEM_PVSurf, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -212,6 +217,7 @@ PetscErrorCode PVSurfWritePVTS(PVSurf *pvsurf, const char *dirName)
 	fprintf(fp, "</VTKFile>\n");
 
 	// close file
+	LogBytesWritten(fp);
 	fclose(fp);
 
 	PetscFunctionReturn(0);
@@ -327,6 +333,7 @@ PetscErrorCode PVSurfWriteVTS(PVSurf *pvsurf, const char *dirName)
 		fprintf(fp, "</VTKFile>\n");
 
 		// close file
+		LogBytesWritten(fp);
 		fclose(fp);
 	}
 
@@ -14,6 +14,19 @@
 #include "parsing.h"
 #include "tools.h"
 
+//---------------------------------------------------------------------------
+// in-memory input parameters (replace -ParamFile if set)
+static const char *FBInputBuffer = NULL;
+//---------------------------------------------------------------------------
+PetscErrorCode FBSetInputBuffer(const char *buff)
+{
+	PetscFunctionBeginUser;
+
+	// buffer must stay valid until FBSetInputBuffer(NULL) is called
+	FBInputBuffer = buff;
+
+	PetscFunctionReturn(0);
+}
 //---------------------------------------------------------------------------
 PetscErrorCode FBLoad(FB **pfb, PetscBool DisplayOutput, char *restartFileName)
 {
@@ -29,7 +42,24 @@ PetscErrorCode FBLoad(FB **pfb, PetscBool DisplayOutput, char *restartFileName)
 	ierr = PetscMalloc(sizeof(FB), &fb); CHKERRQ(ierr);
 	ierr = PetscMemzero(fb, sizeof(FB)); CHKERRQ(ierr);
 
-	if(ISRankZero(PETSC_COMM_WORLD))
+	if(ISRankZero(PETSC_COMM_WORLD) && !restartFileName && FBInputBuffer)
+	{
+		if (DisplayOutput)
+		{
+			PetscPrintf(PETSC_COMM_WORLD, "Parsing input parameters from memory buffer \n");
+		}
+
+		// copy in-memory input parameters
+		sz = strlen(FBInputBuffer);
+
+		ierr = PetscMalloc((sz + 1)*sizeof(char), &fb->fbuf); CHKERRQ(ierr);
+
+		ierr = PetscMemcpy(fb->fbuf, FBInputBuffer, (sz + 1)*sizeof(char)); CHKERRQ(ierr);
+
+		// set number of characters
+		fb->nchar = (PetscInt)sz + 1;
+	}
+	else if(ISRankZero(PETSC_COMM_WORLD))
 	{
 		if(!restartFileName)
 		{
@@ -67,6 +67,9 @@ struct FB
 
 PetscErrorCode FBLoad(FB **pfb, PetscBool DisplayOutput, char *restartFileName = NULL);
 
+// use in-memory input parameters instead of -ParamFile (NULL to reset)
+PetscErrorCode FBSetInputBuffer(const char *buff);
+
 PetscErrorCode FBDestroy(FB **pfb);
 
 PetscErrorCode FBParseBuffer(FB *fb);
@@ -483,7 +483,7 @@ PetscErrorCode ADVAdvectPassiveTracer(AdvCtx *actx)
 	Ttop     =  0.0;
 
 
-	MPI_Comm_rank( MPI_COMM_WORLD, &rank );
+	MPI_Comm_rank( PETSC_COMM_WORLD, &rank );
 
 	// access context
 	fs = actx->fs;
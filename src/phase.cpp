@@ -145,6 +145,9 @@ PetscErrorCode DBMatCreate(DBMat *dbm, FB *fb, PetscBool PrintOutput)
 		// adjust density if needed
 		ierr = Overwrite_density(dbm);CHKERRQ(ierr);
 
+		// set phase-to-transition dispatch table
+		ierr = DBMatSetPhaseTrTable(dbm); CHKERRQ(ierr);
+
 	}
 
 	ierr = FBFreeBlocks(fb); CHKERRQ(ierr);
@@ -259,6 +259,12 @@ struct DBMat
 	Soft_t       matSoft[_max_num_soft_];  // material softening law parameters
 	Ph_trans_t   matPhtr[_max_num_tr_];    // phase transition properties
 	PetscInt     numPhtr;                  // number phase transitions
+
+	// phase transition dispatch table (laws evaluated for each phase in ascending order)
+	PetscInt     numPhtrPhase[_max_num_phases_];               // number of laws evaluated for each phase
+	PetscInt     PhtrPhase   [_max_num_phases_][_max_num_tr_]; // IDs of laws evaluated for each phase
+	PetscInt     PhtrBelow   [_max_num_phases_][_max_num_tr_]; // position of phase in PhaseBelow (PhaseInside) of each law (-1 if absent)
+	PetscInt     PhtrAbove   [_max_num_phases_][_max_num_tr_]; // position of phase in PhaseAbove (PhaseOutside) of each law (-1 if absent)
 };
 
 // read material database
@@ -65,6 +65,7 @@
 #include "surf.h"
 #include "tssolve.h"
 #include "dike.h"
+#include "profile.h"
 
 //-----------------------------------------------------------------------------
 
@@ -698,27 +699,86 @@ PetscErrorCode SetClapeyron_Eq(Ph_trans_t *ph)
 }
 //===========================================================================================================//
 
+PetscErrorCode DBMatSetPhaseTrTable(DBMat *dbm)
+{
+	// set phase-to-transition dispatch table
+	// A law is evaluated for a marker if its phase is listed in the law.
+	// Box-like laws can also set temperature (or force inside phase) for
+	// markers of unlisted phases, such laws are evaluated for all phases.
+
+	Ph_trans_t *PhaseTrans;
+	Marker      P;
+	PetscInt    ph, nPtr, below, above, num_phas, all;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	for(ph = 0; ph < _max_num_phases_; ph++)
+	{
+		dbm->numPhtrPhase[ph] = 0;
+
+		P.phase = ph;
+
+		for(nPtr = 0; nPtr < dbm->numPhtr; nPtr++)
+		{
+			PhaseTrans = dbm->matPhtr + nPtr;
+			num_phas   = PhaseTrans->number_phases;
+
+			if(PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_)
+			{
+				ierr = Check_Phase_above_below(PhaseTrans->PhaseInside,  &P, num_phas, &below); CHKERRQ(ierr);
+				ierr = Check_Phase_above_below(PhaseTrans->PhaseOutside, &P, num_phas, &above); CHKERRQ(ierr);
+
+				all = (PhaseTrans->TempType != 0
+				|| (PhaseTrans->Type == _Box_ && PhaseTrans->PhaseOutside[0] < 0 && PhaseTrans->PhaseDirection == 2));
+			}
+			else
+			{
+				ierr = Check_Phase_above_below(PhaseTrans->PhaseBelow, &P, num_phas, &below); CHKERRQ(ierr);
+				ierr = Check_Phase_above_below(PhaseTrans->PhaseAbove, &P, num_phas, &above); CHKERRQ(ierr);
+
+				all = 0;
+			}
+
+			dbm->PhtrBelow[ph][nPtr] = below;
+			dbm->PhtrAbove[ph][nPtr] = above;
+
+			if(below >= 0 || above >= 0 || all)
+			{
+				dbm->PhtrPhase[ph][dbm->numPhtrPhase[ph]++] = nPtr;
+			}
+		}
+	}
+
+	PetscFunctionReturn(0);
+}
+//===========================================================================================================//
 PetscErrorCode Phase_Transition(AdvCtx *actx)
 {
-	// creates arrays to optimize marker-cell interaction
+	// apply phase transition laws in a single pass over the markers
+	// laws are applied to every marker in ascending order, only laws listed
+	// in the dispatch table for the current marker phase are evaluated
 
 	DBMat           *dbm;
 	TSSol           *ts;
+	FDSTAG          *fs;
 	Ph_trans_t      *PhaseTrans;
 	Marker          *P;
 	JacRes          *jr;
-	PetscInt        i, ph,nPtr, numPhTrn,below,above,num_phas;
-	PetscInt        PH1,PH2, ID, InsideAbove,nphc; // nphc nophasechange condition
-	PetscScalar     T, time, factor, dxBox, dyBox, dzBox;
+	PetscInt        i, pos, last, nlist, *list, nPtr, numPhTrn, nbox, ID;
+	PetscInt        boxID[_max_num_tr_];
+	PetscScalar     time;
 	PetscLogDouble  t;
 	SolVarCell      *svCell;
 	Scaling         *scal;
+	char            *mask;
 
 	PetscErrorCode  ierr;
 	PetscFunctionBeginUser;
 
     // Retrieve parameters
 	jr          =   actx->jr;
+	fs          =   jr->fs;
 	dbm         =   jr->dbm;
 	ts          =   jr->ts;
 	numPhTrn    =   dbm->numPhtr;
@@ -727,185 +787,281 @@ PetscErrorCode Phase_Transition(AdvCtx *actx)
 	
 	if (!numPhTrn) 	PetscFunctionReturn(0);		// only execute this function if we have phase transitions
 
+	ierr = PetscLogEventBegin(LaMEM_PhaseTrans, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PrintStart(&t, "Phase_Transition", NULL);
 
 	//For dynamic diking
 	ierr = Locate_Dike_Zones(actx); CHKERRQ(ierr);
-	
-	// loop over all phase transition laws		PetscPrintf(PETSC_COMM_WORLD,"PHASE = %d  i = %d, counter = %d\n",P->phase,i,counter);
-	nPtr        =   0;
 
-	for(nPtr=0; nPtr<numPhTrn; nPtr++)
-	  {
-	    PhaseTrans = jr->dbm->matPhtr+nPtr;
+	// update moving & linked boxes, count box-like laws
+	for(nPtr = 0, nbox = 0; nPtr < numPhTrn; nPtr++)
+	{
+		PhaseTrans = dbm->matPhtr + nPtr;
 
-	    // Is the phase transition changing the phase, or other properites?
-	    if((PhaseTrans->PhaseInside[0]>=0 && PhaseTrans->PhaseOutside[0]>=0) || (PhaseTrans->PhaseAbove[0]>=0 && PhaseTrans->PhaseBelow[0]>=0))
-	    {
-              nphc = 1;
-	    }
-	    else
-	    {
-              nphc = 0;
-	    }
-	    // calling the moving dike function
+		boxID[nPtr] = -1;
 
-	    if ( PhaseTrans->Type == _NotInAirBox_ )
-	    {
-              if (PhaseTrans->v_box) {
-                ierr = MovingBox(PhaseTrans, ts, jr); CHKERRQ(ierr);
-              }
+		if(PhaseTrans->Type == _NotInAirBox_)
+		{
+			if(PhaseTrans->v_box)
+			{
+				ierr = MovingBox(PhaseTrans, ts, jr); CHKERRQ(ierr);
+			}
 
-              ierr = LinkNotInAirBoxes(PhaseTrans, jr); CHKERRQ(ierr);
+			ierr = LinkNotInAirBoxes(PhaseTrans, jr); CHKERRQ(ierr);
+		}
 
-	    }
-	    
-		for(i = 0; i < actx->nummark; i++)      // loop over all (local) particles
+		if(PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_) boxID[nPtr] = nbox++;
+	}
+
+	// mark cells located completely outside the boxes
+	mask = NULL;
+
+	if(nbox)
+	{
+		ierr = PetscMalloc((size_t)(nbox*fs->nCells)*sizeof(char), &mask); CHKERRQ(ierr);
+
+		for(nPtr = 0; nPtr < numPhTrn; nPtr++)
 		{
-			// access marker
-			P   =   &actx->markers[i];      
+			if(boxID[nPtr] == -1) continue;
 
-			// get consecutive index of the host cell of marker
-			ID = 	actx->cellnum[i];
+			ierr = Get_Cell_Box_Mask(dbm->matPhtr + nPtr, fs, mask + boxID[nPtr]*fs->nCells); CHKERRQ(ierr);
+		}
+	}
 
-			// access host cell solution variables
-			svCell = &jr->svCell[ID];
-			
-			num_phas    =   PhaseTrans->number_phases;
+	for(i = 0; i < actx->nummark; i++)      // loop over all (local) particles
+	{
+		// access marker
+		P   =   &actx->markers[i];
+
+		// get consecutive index of the host cell of marker
+		ID  = 	actx->cellnum[i];
+
+		// access host cell solution variables
+		svCell = &jr->svCell[ID];
+
+		// scan laws of the current phase, rescan the list if phase changes
+		last  = -1;
+		pos   =  0;
+		nlist =  dbm->numPhtrPhase[P->phase];
+		list  =  dbm->PhtrPhase   [P->phase];
+
+		while(pos < nlist)
+		{
+			nPtr = list[pos];
+
+			if(nPtr <= last) { pos++; continue; }
+
+			ierr = Apply_Phase_Transition(dbm->matPhtr + nPtr, P,
+				dbm->PhtrBelow[P->phase][nPtr],
+				dbm->PhtrAbove[P->phase][nPtr],
+				boxID[nPtr] != -1 && mask[boxID[nPtr]*fs->nCells + ID],
+				jr->ctrl, scal, svCell, time, jr, ID); CHKERRQ(ierr);
+
+			last = nPtr;
 
-			if(PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_ )
+			if(dbm->PhtrPhase[P->phase] != list)
 			{
-				ierr = Check_Phase_above_below(PhaseTrans->PhaseInside,   P, num_phas, &below); CHKERRQ(ierr);
-				ierr = Check_Phase_above_below(PhaseTrans->PhaseOutside,  P, num_phas, &above); CHKERRQ(ierr);
+				nlist = dbm->numPhtrPhase[P->phase];
+				list  = dbm->PhtrPhase   [P->phase];
+				pos   = 0;
 			}
-			else {
-				ierr = Check_Phase_above_below(PhaseTrans->PhaseBelow,   P, num_phas, &below); CHKERRQ(ierr);
-				ierr = Check_Phase_above_below(PhaseTrans->PhaseAbove,   P, num_phas, &above); CHKERRQ(ierr);
+			else pos++;
+		}
+	}
+
+	ierr = PetscFree(mask); CHKERRQ(ierr);
+
+	ierr = ADVInterpMarkToCell(actx);   CHKERRQ(ierr);
+
+    	PrintDone(t);
+	ierr = PetscLogEventEnd(LaMEM_PhaseTrans, 0, 0, 0, 0); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//----------------------------------------------------------------------------------------
+PetscErrorCode Apply_Phase_Transition(Ph_trans_t *PhaseTrans, Marker *P, PetscInt below, PetscInt above, PetscInt outside,
+		Controls ctrl, Scaling *scal, SolVarCell *svCell, PetscScalar time, JacRes *jr, PetscInt cellID)
+{
+	// apply single phase transition law to a marker
+	// below, above - positions of marker phase in the phase arrays of the law
+	// outside      - host cell is located completely outside of the box (box-like laws)
+
+	PetscInt        ph, PH1, PH2, InsideAbove, nphc; // nphc nophasechange condition
+	PetscScalar     T, factor, dxBox, dyBox, dzBox;
+
+	PetscErrorCode  ierr;
+	PetscFunctionBeginUser;
+
+    // Is the phase transition changing the phase, or other properites?
+	if((PhaseTrans->PhaseInside[0]>=0 && PhaseTrans->PhaseOutside[0]>=0) || (PhaseTrans->PhaseAbove[0]>=0 && PhaseTrans->PhaseBelow[0]>=0))
+	{
+		nphc = 1;
+	}
+	else
+	{
+		nphc = 0;
+	}
+
+	PH1 = P->phase;
+	PH2 = P->phase;
+
+	if  ( (below >= 0) || (above >= 0) )
+	{
+		// the current phase is indeed involved in a phase transition
+		if      (   (below>=0) && (nphc ==1))
+		{
+			if ( PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_){
+				PH1 = PhaseTrans->PhaseInside[below];
+				PH2 = PhaseTrans->PhaseOutside[below];
 			}
+			else{
+				PH1 = PhaseTrans->PhaseBelow[below];
+				PH2 = PhaseTrans->PhaseAbove[below];
+			}
+		}
+		else if (   (above >=0) && (nphc==1))
+		{
+			if ( PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_){
+				PH1 = PhaseTrans->PhaseInside[above];
+				PH2 = PhaseTrans->PhaseOutside[above];
+			}
+			else{
+				PH1 = PhaseTrans->PhaseBelow[above];
+				PH2 = PhaseTrans->PhaseAbove[above];
+			}
+		}
+	}
 
-			if  ( (below >= 0) || (above >= 0) )
-			{
-				PH2 = P->phase;
-				PH1 = P->phase;
-                 // the current phase is indeed involved in a phase transition
-				if      (   (below>=0) && (nphc ==1))
+	ph 			= P->phase;
+	InsideAbove = 0;
+
+	if(outside)
+	{
+		// host cell is outside of the box, keep T
+		ph = PH2;
+		T  = P->T;
+	}
+	else
+	{
+		ierr = Transition(PhaseTrans, P, PH1, PH2, ctrl, scal, svCell, &ph, &T, &InsideAbove, time, jr, cellID); CHKERRQ(ierr);
+	}
+
+	if  ( (below >= 0) || (above >= 0) )
+	{
+		if ( (PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_ ) )
+		{
+			if (PhaseTrans->PhaseInside[0]<0){ 
+				ph = P->phase;				// do not change the phase
+			}
+
+			if (PhaseTrans->BoxVicinity==1){
+				factor = 1.0;
+				dxBox  = (PhaseTrans->bounds[1]-PhaseTrans->bounds[0])*factor;
+				dyBox  = (PhaseTrans->bounds[3]-PhaseTrans->bounds[2])*factor;
+				dzBox  = (PhaseTrans->bounds[3]-PhaseTrans->bounds[2])*factor;
+				
+				if ( (P->X[0] < (PhaseTrans->bounds[0]-dxBox)) | (P->X[0] > (PhaseTrans->bounds[1]+dxBox)) |
+					 (P->X[1] < (PhaseTrans->bounds[2]-dyBox)) | (P->X[1] > (PhaseTrans->bounds[3]+dyBox)) |
+					 (P->X[2] < (PhaseTrans->bounds[4]-dzBox)) | (P->X[2] > (PhaseTrans->bounds[5]+dzBox))  )
 				{
-					if ( PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_){
-						PH1 = PhaseTrans->PhaseInside[below];
-						PH2 = PhaseTrans->PhaseOutside[below];
-					}
-					else{
-						PH1 = PhaseTrans->PhaseBelow[below];
-						PH2 = PhaseTrans->PhaseAbove[below];
-					}
+					ph = P->phase;				// do not change the phase
 				}
-				else if (   (above >=0) && (nphc==1))
-				{
-					if ( PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_){
-						PH1 = PhaseTrans->PhaseInside[above];
-						PH2 = PhaseTrans->PhaseOutside[above];
-					}
-					else{
-						PH1 = PhaseTrans->PhaseBelow[above];
-						PH2 = PhaseTrans->PhaseAbove[above];
-					}
+			}
+		}
+		if (PhaseTrans->PhaseDirection==0){
+			P->phase    =   ph;
+		}
+		else if ( (PhaseTrans->PhaseDirection==1) & (below>=0) ){
+			P->phase    =   ph;
+		}
+		else if ( (PhaseTrans->PhaseDirection==2) & (above>=0) ){
+			P->phase    =   ph;
+		}
+		P->T = T;	// set T
+
+		// Reset other parameters on particles if requested
+		if (PhaseTrans->PhaseDirection< 2){
+
+			// Both ways or below2above	
+			if (InsideAbove==1){
+				if (PhaseTrans->Reset==1){
+					P->APS = 0.0;
 				}
-				else
-				{
-					PH1 = P->phase;
-					PH2 = PH1;
+			}
+		}
+		else{
+			// Above to below
+			if (InsideAbove==0){
+				if (PhaseTrans->Reset==1){
+					P->APS = 0.0;
 				}
+			}
+		}
+	}
+	else if ( (PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_ ) )
+	{
+		// allow cases in which we only reset T
+		if ((PhaseTrans->PhaseOutside[0]<0) & (PhaseTrans->PhaseDirection==2) & (InsideAbove==1)){ 	
+			// PhaseOutside is set to -1 and OutsideToInside is selected, in which case we 
+			// set everything inside the box to a constant phase (specified in PhaseInside)
+			P->phase = PhaseTrans->PhaseInside[0];
+		}
+		
+		P->T 	= T;	// set T
+	}
 
-				ph 			= P->phase;
-				InsideAbove = 0;
+	PetscFunctionReturn(0);
+}
+//----------------------------------------------------------------------------------------
+PetscErrorCode Get_Cell_Box_Mask(Ph_trans_t *PhaseTrans, FDSTAG *fs, char *mask)
+{
+	// mark cells located completely outside of the box (cell extent is
+	// inflated by half of the neighbor cells to account for tolerances)
 
-				ierr = Transition(PhaseTrans, P, PH1, PH2, jr->ctrl, scal, svCell, &ph, &T, &InsideAbove, time, jr, ID); CHKERRQ(ierr);
+	PetscInt     i, j, k, nx, ny, nz, iter;
+	PetscScalar  xs, xe, ys, ye, zs, ze, bL, bR;
+	PetscScalar *ccx, *ccy, *ccz;
 
-				if ( (PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_ ) )
-				{
-					if (PhaseTrans->PhaseInside[0]<0){ 
-						ph = P->phase;				// do not change the phase
-					}
+	PetscFunctionBeginUser;
 
-				
-					if (PhaseTrans->BoxVicinity==1){
-						factor = 1.0;
-						dxBox  = (PhaseTrans->bounds[1]-PhaseTrans->bounds[0])*factor;
-						dyBox  = (PhaseTrans->bounds[3]-PhaseTrans->bounds[2])*factor;
-						dzBox  = (PhaseTrans->bounds[3]-PhaseTrans->bounds[2])*factor;
-						
-						if ( (P->X[0] < (PhaseTrans->bounds[0]-dxBox)) | (P->X[0] > (PhaseTrans->bounds[1]+dxBox)) |
-							 (P->X[1] < (PhaseTrans->bounds[2]-dyBox)) | (P->X[1] > (PhaseTrans->bounds[3]+dyBox)) |
-							 (P->X[2] < (PhaseTrans->bounds[4]-dzBox)) | (P->X[2] > (PhaseTrans->bounds[5]+dzBox))  )
-						{
-							ph = P->phase;				// do not change the phase
-						}
-					}
+	nx  = fs->dsx.ncels; ccx = fs->dsx.ccoor;
+	ny  = fs->dsy.ncels; ccy = fs->dsy.ccoor;
+	nz  = fs->dsz.ncels; ccz = fs->dsz.ccoor;
 
-				
-				}
-				if (PhaseTrans->PhaseDirection==0){
-					P->phase    =   ph;
-				}
-				else if ( (PhaseTrans->PhaseDirection==1) & (below>=0) ){
-					P->phase    =   ph;
-				}
-				else if ( (PhaseTrans->PhaseDirection==2) & (above>=0) ){
-					P->phase    =   ph;
-				}
-				P->T = T;	// set T
+	iter = 0;
 
-				// Reset other parameters on particles if requested
-				if (PhaseTrans->PhaseDirection< 2){
+	for(k = 0; k < nz; k++)
+	{	zs = ccz[k-1]; ze = ccz[k+1];
 
-					// Both ways or below2above	
-					if (InsideAbove==1){
-						if (PhaseTrans->Reset==1){
-							P->APS = 0.0;
-						}
-					}
-				}
-				else{
-					// Above to below
-					if (InsideAbove==0){
-						if (PhaseTrans->Reset==1){
-							P->APS = 0.0;
-						}
-					}
+		for(j = 0; j < ny; j++)
+		{	ys = ccy[j-1]; ye = ccy[j+1];
 
+			if(PhaseTrans->Type == _NotInAirBox_)
+			{
+				// envelope of interpolated segment bounds
+				bL = PetscMin(PetscMin(PhaseTrans->celly_xboundL[j-1], PhaseTrans->celly_xboundL[j]), PhaseTrans->celly_xboundL[j+1]);
+				bR = PetscMax(PetscMax(PhaseTrans->celly_xboundR[j-1], PhaseTrans->celly_xboundR[j]), PhaseTrans->celly_xboundR[j+1]);
+			}
 
+			for(i = 0; i < nx; i++)
+			{	xs = ccx[i-1]; xe = ccx[i+1];
+
+				if(PhaseTrans->Type == _NotInAirBox_)
+				{
+					mask[iter++] = (char)(xe < bL || xs > bR
+					|| ze < PhaseTrans->zbounds[0] || zs > PhaseTrans->zbounds[1]);
 				}
-			}
-			else{
-				// allow cases in which we only reset T
-				ph 			= P->phase;
-				InsideAbove = 0;
-
-				ierr = Transition(PhaseTrans, P, PH1, PH2, jr->ctrl, scal, svCell, &ph, &T, &InsideAbove, time, jr, ID); CHKERRQ(ierr);
-
-				if ( (PhaseTrans->Type == _Box_ || PhaseTrans->Type == _NotInAirBox_ ) ){
-					if (PhaseTrans->PhaseInside[0]<0){ 
-						ph 		= P->phase;				// do not change the phase
-					}
-					
-					if ((PhaseTrans->PhaseOutside[0]<0) & (PhaseTrans->PhaseDirection==2) & (InsideAbove==1)){ 	
-						// PhaseOutside is set to -1 and OutsideToInside is selected, in which case we 
-						// set everything inside the box to a constant phase (specified in PhaseInside)
-						ph = PhaseTrans->PhaseInside[0];
-						P->phase = ph;
-					}
-					
-					P->T 	= T;	// set T
+				else
+				{
+					mask[iter++] = (char)(xe < PhaseTrans->bounds[0] || xs > PhaseTrans->bounds[1]
+					|| ye < PhaseTrans->bounds[2] || ys > PhaseTrans->bounds[3]
+					|| ze < PhaseTrans->bounds[4] || zs > PhaseTrans->bounds[5]);
 				}
 			}
-
-
 		}
-
 	}
-	ierr = ADVInterpMarkToCell(actx);   CHKERRQ(ierr);
 
-    	PrintDone(t);
 	PetscFunctionReturn(0);
 }
 
@@ -26,6 +26,7 @@ struct ConstEqCtx;
 struct Marker;
 struct Material_t;
 struct Freesurf;
+struct FDSTAG;
 
 // read phase transition law
 PetscErrorCode DBMatReadPhaseTr(DBMat *dbm, FB *fb);
@@ -35,7 +36,11 @@ PetscErrorCode Set_Box_Phase_Transition(Ph_trans_t   *ph, DBMat *dbm, FB *fb);
 PetscErrorCode Set_NotInAirBox_Phase_Transition(Ph_trans_t *ph, DBMat *dbm, FB *fb);
 PetscErrorCode SetClapeyron_Eq(Ph_trans_t *ph);
 PetscErrorCode Overwrite_density(DBMat *dbm);
+PetscErrorCode DBMatSetPhaseTrTable(DBMat *dbm);
 PetscErrorCode Phase_Transition(AdvCtx *actx);
+PetscErrorCode Apply_Phase_Transition(Ph_trans_t *PhaseTrans, Marker *P, PetscInt below, PetscInt above, PetscInt outside,
+		Controls ctrl, Scaling *scal, SolVarCell *svCell, PetscScalar time, JacRes *jr, PetscInt cellID);
+PetscErrorCode Get_Cell_Box_Mask(Ph_trans_t *PhaseTrans, FDSTAG *fs, char *mask);
 PetscErrorCode Transition(Ph_trans_t *PhaseTrans, Marker *P, PetscInt PH1,PetscInt PH2,
 		Controls ctrl,Scaling *scal, SolVarCell *svCell, PetscInt *ph, PetscScalar *T, PetscInt *InsideAbove, PetscScalar, JacRes *jr, PetscInt cellID);
 PetscErrorCode Check_Phase_above_below(PetscInt *phase_array, Marker *P, PetscInt num_phas, PetscInt *ID);
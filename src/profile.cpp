@@ -0,0 +1,334 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+// ........................... PROFILING EVENTS .............................
+//---------------------------------------------------------------------------
+#include "LaMEM.h"
+#include "profile.h"
+#include "parsing.h"
+#include "scaling.h"
+#include "tssolve.h"
+#include "advect.h"
+//---------------------------------------------------------------------------
+PetscLogEvent LaMEM_StrainRate;
+PetscLogEvent LaMEM_Residual;
+PetscLogEvent LaMEM_LithoPres;
+PetscLogEvent LaMEM_PMatAssemble;
+PetscLogEvent LaMEM_MGSetup;
+PetscLogEvent LaMEM_MapMarkCells;
+PetscLogEvent LaMEM_ProjHistGrid;
+PetscLogEvent LaMEM_MarkerControl;
+PetscLogEvent LaMEM_Exchange;
+PetscLogEvent LaMEM_PhaseTrans;
+PetscLogEvent LaMEM_FreeSurfAdvect;
+PetscLogEvent LaMEM_PVOut;
+PetscLogEvent LaMEM_PVSurf;
+PetscLogEvent LaMEM_PVMark;
+PetscLogEvent LaMEM_PVAVD;
+PetscLogEvent LaMEM_PVPtr;
+//---------------------------------------------------------------------------
+static PetscBool      LaMEMLogEventRegistered = PETSC_FALSE;
+static PetscLogDouble LaMEMBytesWritten       = 0.0;
+//---------------------------------------------------------------------------
+static PetscErrorCode LaMEMLogEventFinalize()
+{
+	// events must be registered again if PETSc is reinitialized
+	LaMEMLogEventRegistered = PETSC_FALSE;
+
+	return 0;
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLogEventRegister()
+{
+	PetscClassId classid;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(LaMEMLogEventRegistered) PetscFunctionReturn(0);
+
+	ierr = PetscClassIdRegister("LaMEM", &classid); CHKERRQ(ierr);
+
+	ierr = PetscLogEventRegister("JacResStrainRate", classid, &LaMEM_StrainRate);     CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("JacResResidual",   classid, &LaMEM_Residual);       CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("JacResLithoPres",  classid, &LaMEM_LithoPres);      CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("PMatAssemble",     classid, &LaMEM_PMatAssemble);   CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("MGSetup",          classid, &LaMEM_MGSetup);        CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("ADVMapMarkCells",  classid, &LaMEM_MapMarkCells);   CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("ADVProjHistGrid",  classid, &LaMEM_ProjHistGrid);   CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("AVDMarkerCtrl",    classid, &LaMEM_MarkerControl);  CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("ADVExchange",      classid, &LaMEM_Exchange);       CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("PhaseTransition",  classid, &LaMEM_PhaseTrans);     CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("FreeSurfAdvect",   classid, &LaMEM_FreeSurfAdvect); CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("PVOutWrite",       classid, &LaMEM_PVOut);          CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("PVSurfWrite",      classid, &LaMEM_PVSurf);         CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("PVMarkWrite",      classid, &LaMEM_PVMark);         CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("PVAVDWrite",       classid, &LaMEM_PVAVD);          CHKERRQ(ierr);
+	ierr = PetscLogEventRegister("PVPtrWrite",       classid, &LaMEM_PVPtr);          CHKERRQ(ierr);
+
+	ierr = PetscRegisterFinalize(LaMEMLogEventFinalize); CHKERRQ(ierr);
+
+	LaMEMLogEventRegistered = PETSC_TRUE;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+void LogBytesWritten(FILE *fp)
+{
+	long pos;
+
+	pos = ftell(fp);
+
+	if(pos > 0) LaMEMBytesWritten += (PetscLogDouble)pos;
+}
+//---------------------------------------------------------------------------
+// Per-step performance log
+//---------------------------------------------------------------------------
+PetscErrorCode PerfLogCreate(PerfLog *plog)
+{
+	PetscMPIInt rank;
+	PetscBool   found;
+	char        file[_str_len_];
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	// clear object
+	ierr = PetscMemzero(plog, sizeof(PerfLog)); CHKERRQ(ierr);
+
+	plog->phase = -1;
+
+	ierr = PetscOptionsGetCheckString("-perf_log", file, &found); CHKERRQ(ierr);
+
+	if(!found) PetscFunctionReturn(0);
+
+	plog->use = 1;
+
+	ierr = MPI_Comm_size(PETSC_COMM_WORLD, &plog->nproc); CHKERRQ(ierr);
+	ierr = MPI_Comm_rank(PETSC_COMM_WORLD, &rank);        CHKERRQ(ierr);
+
+	// only first rank writes the log
+	if(!rank)
+	{
+		plog->fp = fopen(file, "w");
+
+		if(plog->fp == NULL)
+		{
+			SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Cannot open performance log file %s\n", file);
+		}
+	}
+
+	// track maximum resident set size (sampled by PETSc during the run)
+	ierr = PetscMemorySetGetMaximumUsage(); CHKERRQ(ierr);
+
+	ierr = PerfLogStart(plog); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfLogStart(PerfLog *plog)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!plog->use) PetscFunctionReturn(0);
+
+	// discard bytes written before the first step
+	LaMEMBytesWritten = 0.0;
+
+	ierr = PetscTime(&plog->tstep); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode PerfLogFlush(PerfLog *plog)
+{
+	// complete pending reductions and write record
+
+	PetscInt        i;
+	FILE           *fp;
+	PetscLogDouble  n;
+	const char     *name[] = { "setup", "solve", "adjoint", "advect", "remap", "output", "step" };
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!plog->pend) PetscFunctionReturn(0);
+
+	ierr = MPI_Waitall(3, plog->req, MPI_STATUSES_IGNORE); CHKERRQ(ierr);
+
+	plog->pend = 0;
+
+	fp = plog->fp;
+
+	if(!fp) PetscFunctionReturn(0);
+
+	n = (PetscLogDouble)plog->nproc;
+
+	fprintf(fp, "{\"step\": %lld, \"time\": %g, \"dt\": %g, \"nproc\": %lld, \"its\": %lld, \"lits\": %lld, ",
+		(LLD)plog->step, plog->time, plog->dt, (LLD)plog->nproc, (LLD)plog->pits, (LLD)plog->plits);
+
+	// wall time per phase [max, avg]
+	fprintf(fp, "\"wall\": {");
+
+	for(i = 0; i < _perf_num_phases_; i++)
+	{
+		fprintf(fp, "\"%s\": [%g, %g]%s", name[i], plog->rmax[i], plog->rsum[i]/n, i < _perf_num_phases_-1 ? ", " : "}, ");
+	}
+
+	// markers [min, max, avg]
+	fprintf(fp, "\"markers\": [%.0f, %.0f, %.1f], \"injected\": %.0f, \"deleted\": %.0f, \"mem_max\": %.0f, \"bytes\": %.0f}\n",
+		plog->rmin[_perf_mark_], plog->rmax[_perf_mark_], plog->rsum[_perf_mark_]/n,
+		plog->rsum[_perf_inj_],  plog->rsum[_perf_del_],
+		plog->rmax[_perf_mem_],  plog->rsum[_perf_bytes_]);
+
+	fflush(fp);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfLogDestroy(PerfLog *plog)
+{
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!plog->use) PetscFunctionReturn(0);
+
+	// write last record
+	ierr = PerfLogFlush(plog); CHKERRQ(ierr);
+
+	if(plog->fp) fclose(plog->fp);
+
+	plog->fp  = NULL;
+	plog->use = 0;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfLogBegin(PerfLog *plog, PetscInt phase)
+{
+	PetscLogDouble t;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!plog->use) PetscFunctionReturn(0);
+
+	ierr = PetscTime(&t); CHKERRQ(ierr);
+
+	if(plog->phase != -1) plog->val[plog->phase] += t - plog->tbeg;
+
+	plog->phase = phase;
+	plog->tbeg  = t;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfLogEnd(PerfLog *plog)
+{
+	PetscLogDouble t;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!plog->use || plog->phase == -1) PetscFunctionReturn(0);
+
+	ierr = PetscTime(&t); CHKERRQ(ierr);
+
+	plog->val[plog->phase] += t - plog->tbeg;
+
+	plog->phase = -1;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfLogSetIterations(PerfLog *plog, SNES snes)
+{
+	PetscInt its, lits;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!plog->use) PetscFunctionReturn(0);
+
+	ierr = SNESGetIterationNumber(snes, &its);        CHKERRQ(ierr);
+	ierr = SNESGetLinearSolveIterations(snes, &lits); CHKERRQ(ierr);
+
+	plog->its  += its;
+	plog->lits += lits;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfLogStep(PerfLog *plog, AdvCtx *actx, TSSol *ts)
+{
+	PetscLogDouble t, mem, cur;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(!plog->use) PetscFunctionReturn(0);
+
+	// complete record of previous step (reductions had a full step to progress)
+	ierr = PerfLogFlush(plog); CHKERRQ(ierr);
+
+	// close step
+	ierr = PerfLogEnd(plog); CHKERRQ(ierr);
+
+	ierr = PetscTime(&t); CHKERRQ(ierr);
+
+	plog->val[_perf_step_] = t - plog->tstep;
+	plog->tstep            = t;
+
+	// marker counters
+	plog->val[_perf_mark_] = (PetscLogDouble)actx->nummark;
+	plog->val[_perf_inj_]  = (PetscLogDouble)actx->tinj;
+	plog->val[_perf_del_]  = (PetscLogDouble)actx->tdel;
+
+	actx->tinj = 0;
+	actx->tdel = 0;
+
+	// memory high-water mark (maximum resident set size since start of the run)
+	// PETSc samples the usage when objects are destroyed, include current usage
+	ierr = PetscMemoryGetMaximumUsage(&mem);  CHKERRQ(ierr);
+	ierr = PetscMemoryGetCurrentUsage(&cur);  CHKERRQ(ierr);
+
+	plog->val[_perf_mem_] = PetscMax(mem, cur);
+
+	// output volume
+	plog->val[_perf_bytes_] = LaMEMBytesWritten;
+
+	LaMEMBytesWritten = 0.0;
+
+	// store pending record
+	plog->step  = ts->istep;
+	plog->time  = ts->time*ts->scal->time;
+	plog->dt    = ts->dt*ts->scal->time;
+	plog->pits  = plog->its;
+	plog->plits = plog->lits;
+
+	ierr = PetscMemcpy(plog->sbuf, plog->val, sizeof(plog->val)); CHKERRQ(ierr);
+
+	// reset step counters
+	ierr = PetscMemzero(plog->val, sizeof(plog->val)); CHKERRQ(ierr);
+
+	plog->its  = 0;
+	plog->lits = 0;
+
+	// start non-blocking reductions (completed at the end of next step)
+	ierr = MPI_Ireduce(plog->sbuf, plog->rmin, _perf_num_vals_, MPI_DOUBLE, MPI_MIN, 0, PETSC_COMM_WORLD, &plog->req[0]); CHKERRQ(ierr);
+	ierr = MPI_Ireduce(plog->sbuf, plog->rmax, _perf_num_vals_, MPI_DOUBLE, MPI_MAX, 0, PETSC_COMM_WORLD, &plog->req[1]); CHKERRQ(ierr);
+	ierr = MPI_Ireduce(plog->sbuf, plog->rsum, _perf_num_vals_, MPI_DOUBLE, MPI_SUM, 0, PETSC_COMM_WORLD, &plog->req[2]); CHKERRQ(ierr);
+
+	plog->pend = 1;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,141 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+// ........................... PROFILING EVENTS .............................
+//---------------------------------------------------------------------------
+#ifndef __profile_h__
+#define __profile_h__
+//---------------------------------------------------------------------------
+
+struct AdvCtx;
+struct TSSol;
+
+//---------------------------------------------------------------------------
+
+// Events are reported by -log_view within the profiling stages
+// (Initial guess, SNES solve, Advect markers, I/O)
+
+// residual & Jacobian
+extern PetscLogEvent LaMEM_StrainRate;     // JacResGetEffStrainRate
+extern PetscLogEvent LaMEM_Residual;       // JacResGetResidual (incl. constitutive update)
+extern PetscLogEvent LaMEM_LithoPres;      // JacResGetLithoStaticPressure
+extern PetscLogEvent LaMEM_PMatAssemble;   // PMatAssemble
+extern PetscLogEvent LaMEM_MGSetup;        // MGSetup
+
+// markers
+extern PetscLogEvent LaMEM_MapMarkCells;   // ADVMapMarkToCells
+extern PetscLogEvent LaMEM_ProjHistGrid;   // ADVProjHistMarkToGrid
+extern PetscLogEvent LaMEM_MarkerControl;  // AVDMarkerControl
+extern PetscLogEvent LaMEM_Exchange;       // ADVExchange
+extern PetscLogEvent LaMEM_PhaseTrans;     // Phase_Transition
+extern PetscLogEvent LaMEM_FreeSurfAdvect; // FreeSurfAdvect
+
+// output
+extern PetscLogEvent LaMEM_PVOut;          // PVOutWriteTimeStep
+extern PetscLogEvent LaMEM_PVSurf;         // PVSurfWriteTimeStep
+extern PetscLogEvent LaMEM_PVMark;         // PVMarkWriteTimeStep
+extern PetscLogEvent LaMEM_PVAVD;          // PVAVDWriteTimeStep
+extern PetscLogEvent LaMEM_PVPtr;          // PVPtrWriteTimeStep
+
+//---------------------------------------------------------------------------
+
+// register profiling events (only once after PETSc initialization)
+PetscErrorCode LaMEMLogEventRegister();
+
+// count bytes written to output file (call before closing file)
+void LogBytesWritten(FILE *fp);
+
+//---------------------------------------------------------------------------
+// Per-step performance log (-perf_log <file>)
+//---------------------------------------------------------------------------
+
+// Every step appends one JSON line with:
+//    wall time per phase (max & average over ranks),
+//    nonlinear & linear iteration counts,
+//    local marker counts (min, max & average over ranks),
+//    injected & deleted markers, memory high-water mark (max over ranks),
+//    and bytes written to disk.
+// Step time is measured from PerfLogStart (initial guess is excluded) or
+// from the end of the previous step.
+// Statistics are collected by non-blocking reductions, which are completed
+// at the end of the next step (record is delayed by one step). No barriers.
+
+enum PerfVal
+{
+	// wall time per phase
+	_perf_setup_,   // phase transitions, boundary conditions, temperature
+	_perf_solve_,   // nonlinear solve
+	_perf_adjoint_, // adjoint gradients
+	_perf_advect_,  // time step, free surface & marker advection, exchange
+	_perf_remap_,   // erosion, sedimentation, marker remapping
+	_perf_output_,  // output & restart database
+	_perf_step_,    // total step
+
+	// step counters
+	_perf_mark_,    // local markers
+	_perf_inj_,     // injected markers
+	_perf_del_,     // deleted markers
+	_perf_mem_,     // memory high-water mark
+	_perf_bytes_,   // bytes written
+
+	_perf_num_vals_
+};
+
+#define _perf_num_phases_ 7
+
+//---------------------------------------------------------------------------
+
+struct PerfLog
+{
+	PetscInt       use;                   // log activation flag
+	FILE          *fp;                    // log file (first rank)
+	PetscInt       phase;                 // currently timed phase (-1 if none)
+	PetscLogDouble tbeg;                  // start time of current phase
+	PetscLogDouble tstep;                 // start time of current step
+	PetscLogDouble val[_perf_num_vals_];  // local values of current step
+	PetscInt       its, lits;             // nonlinear & linear iterations of current step
+
+	// pending record
+	PetscInt       pend;                  // non-blocking reductions are pending
+	PetscInt       step;                  // step number
+	PetscScalar    time;                  // model time
+	PetscScalar    dt;                    // time step
+	PetscInt       pits, plits;           // nonlinear & linear iterations
+	PetscMPIInt    nproc;                 // number of ranks
+	PetscLogDouble sbuf[_perf_num_vals_]; // send buffer
+	PetscLogDouble rmin[_perf_num_vals_]; // minimum over ranks
+	PetscLogDouble rmax[_perf_num_vals_]; // maximum over ranks
+	PetscLogDouble rsum[_perf_num_vals_]; // sum over ranks
+	MPI_Request    req[3];                // reduction requests
+};
+
+//---------------------------------------------------------------------------
+
+PetscErrorCode PerfLogCreate(PerfLog *plog);
+
+PetscErrorCode PerfLogDestroy(PerfLog *plog);
+
+// start timing a phase (closes previous phase)
+PetscErrorCode PerfLogBegin(PerfLog *plog, PetscInt phase);
+
+// stop timing current phase
+PetscErrorCode PerfLogEnd(PerfLog *plog);
+
+// start timing of the first step (excludes initial guess & preceding output)
+PetscErrorCode PerfLogStart(PerfLog *plog);
+
+// store iteration counts of the nonlinear solve
+PetscErrorCode PerfLogSetIterations(PerfLog *plog, SNES snes);
+
+// complete previous record, start reductions for current step
+PetscErrorCode PerfLogStep(PerfLog *plog, AdvCtx *actx, TSSol *ts);
+
+//---------------------------------------------------------------------------
+#endif
@@ -55,8 +55,6 @@ PetscErrorCode ADVMarkSubGrid(AdvCtx *actx)
 	PetscLogDouble    t0, t1;
 	ipair             t;
 	spair             d;
-	vector <Marker>   iclone;
-	vector <PetscInt> imerge;
 	vector <ipair>    cell;
 	vector <spair>    dist;
 	vector <Marker>   mark;
@@ -80,11 +78,11 @@ PetscErrorCode ADVMarkSubGrid(AdvCtx *actx)
 	dist.reserve(_mark_buff_sz_);
 	mark.reserve(_mark_buff_sz_);
 
-	iclone.reserve(actx->nummark*_mark_buff_ratio_/100);
-	imerge.reserve(actx->nummark*_mark_buff_ratio_/100);
+	// reserve persistent injection & deletion buffers
+	ierr = ADVReserveBuff(actx, 0, actx->nummark*_mark_buff_ratio_/100, actx->nummark*_mark_buff_ratio_/100); CHKERRQ(ierr);
 
-	iclone.clear();
-	imerge.clear();
+	actx->nrecv = 0;
+	actx->ndel  = 0;
 
 	nclone = 0;
 	nmerge = 0;
@@ -156,7 +154,7 @@ PetscErrorCode ADVMarkSubGrid(AdvCtx *actx)
 			if(isubcell != i)
 			{
 				// clone markers
-				ierr = ADVMarkClone(actx, icell, i, s, h, dist, iclone); CHKERRQ(ierr);
+				ierr = ADVMarkClone(actx, icell, i, s, h, dist); CHKERRQ(ierr);
 
 				// update counter
 				nclone++;
@@ -169,7 +167,7 @@ PetscErrorCode ADVMarkSubGrid(AdvCtx *actx)
 				// merge markers if required
 				if(ie - ib > actx->npmax)
 				{
-					ierr = ADVMarkCheckMerge(actx, ib, ie, nmerge, mark, cell, iclone, imerge); CHKERRQ(ierr);
+					ierr = ADVMarkCheckMerge(actx, ib, ie, nmerge, mark, cell); CHKERRQ(ierr);
 				}
 
 				// switch to next populated subcell
@@ -179,7 +177,10 @@ PetscErrorCode ADVMarkSubGrid(AdvCtx *actx)
 	}
 
 	// rearrange storage after marker resampling
-	ierr = ADVCollectGarbageVec(actx, iclone, imerge); CHKERRQ(ierr);
+	ierr = ADVCollectGarbage(actx); CHKERRQ(ierr);
+
+	actx->nrecv = 0;
+	actx->ndel  = 0;
 
 	// compute host cells for all the markers
 	ierr = ADVMapMarkToCells(actx); CHKERRQ(ierr);
@@ -199,12 +200,11 @@ PetscErrorCode ADVMarkClone(
 	PetscInt         isubcell,
 	PetscScalar      s[3],
 	PetscScalar      h[3],
-	vector <spair>  &dist,
-	vector <Marker> &iclone)
+	vector <spair>  &dist)
 {
 	// clone closest marker & put it in the center of an empty subcell
 	// current marker storage is not modified, the following is done instead:
-	//  - all newly created markers are stored for insertion in iclone
+	//  - all newly created markers are stored for insertion in the injection buffer
 
 	BCCtx            *bc;
 	spair             d;
@@ -261,7 +261,7 @@ PetscErrorCode ADVMarkClone(
 	ierr = BCOverridePhase(bc, icell, &P); CHKERRQ(ierr);
 
 	// store cloned marker
-	iclone.push_back(P);
+	ierr = ADVPushMark(actx, &P); CHKERRQ(ierr);
 
 	PetscFunctionReturn(0);
 }
@@ -272,15 +272,13 @@ PetscErrorCode ADVMarkCheckMerge(
 	PetscInt           ie,
 	PetscInt          &nmerge,
 	vector <Marker>   &mark,
-	vector <ipair>    &cell,
-	vector <Marker>   &iclone,
-	vector <PetscInt> &imerge)
+	vector <ipair>    &cell)
 {
 	// merge markers in a densely populated subcell
 	// never merge markers of different phases
 	// current marker storage is not modified, the following is done instead:
-	//  - indices of merged markers are flagged for removal in imerge
-	//  - all newly created markers are stored for insertion in iclone
+	//  - indices of merged markers are flagged for removal in the deletion buffer
+	//  - all newly created markers are stored for insertion in the injection buffer
 	//  - difference between original and final number of markers is added to counter
 
 	PetscInt j, jb, je, k, sz, phase, nmark;
@@ -333,7 +331,7 @@ PetscErrorCode ADVMarkCheckMerge(
 			{
 				if(mark[k].phase == -1)
 				{
-					imerge.push_back(cell[j].second);
+					ierr = ADVPushDel(actx, cell[j].second); CHKERRQ(ierr);
 				}
 			}
 
@@ -342,7 +340,7 @@ PetscErrorCode ADVMarkCheckMerge(
 			{
 				if(mark[k].phase != -1)
 				{
-					iclone.push_back(mark[k]);
+					ierr = ADVPushMark(actx, &mark[k]); CHKERRQ(ierr);
 				}
 			}
 		}
@@ -418,66 +416,6 @@ PetscErrorCode ADVMarkMerge(
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode ADVCollectGarbageVec(AdvCtx *actx, vector <Marker> &recvbuf, vector <PetscInt> &idel)
-{
-	// rearrange storage after marker resampling
-
-	Marker   *markers;
-	PetscInt  nummark, nrecv, ndel;
-
-	PetscErrorCode ierr;
-	PetscFunctionBeginUser;
-
-	// access storage
-	nummark = actx->nummark;
-	markers = actx->markers;
-	nrecv   = (PetscInt)recvbuf.size();
-	ndel    = (PetscInt)idel.size();
-
-	// close holes in marker storage
-	while(nrecv && ndel)
-	{
-		markers[idel[ndel-1]] = recvbuf[nrecv-1];
-		nrecv--;
-		ndel--;
-	}
-
-	if(nrecv)
-	{
-		// make sure space is enough
-		ierr = ADVReAllocStorage(actx, nummark + nrecv); CHKERRQ(ierr);
-
-		// make sure we have a correct storage pointer
-		markers = actx->markers;
-
-		// put the rest in the end of marker storage
-		while(nrecv)
-		{
-			markers[nummark++] = recvbuf[nrecv-1];
-			nrecv--;
-		}
-	}
-
-	if(ndel)
-	{
-		// collect garbage
-		while(ndel)
-		{
-			if(idel[ndel-1] != nummark-1)
-			{
-				markers[idel[ndel-1]] = markers[nummark-1];
-			}
-			nummark--;
-			ndel--;
-		}
-	}
-
-	// store new number of markers
-	actx->nummark = nummark;
-
-	PetscFunctionReturn(0);
-}
-//---------------------------------------------------------------------------
 PetscErrorCode ADVMarkCrossFreeSurf(AdvCtx *actx)
 {
 	// change marker phase when crossing free surface
@@ -29,8 +29,7 @@ PetscErrorCode ADVMarkClone(
 	PetscInt         isubcell,
 	PetscScalar     *s,
 	PetscScalar     *h,
-	vector <spair>  &dist,
-	vector <Marker> &iclone);
+	vector <spair>  &dist);
 
 // merge markers in a densely populated subcell
 PetscErrorCode ADVMarkCheckMerge(
@@ -39,9 +38,7 @@ PetscErrorCode ADVMarkCheckMerge(
 	PetscInt           ie,
 	PetscInt          &nmerge,
 	vector <Marker>   &mark,
-	vector <ipair>    &cell,
-	vector <Marker>   &iclone,
-	vector <PetscInt> &imerge);
+	vector <ipair>    &cell);
 
 // recursively find and merge closest markers until required number is reached
 PetscErrorCode ADVMarkMerge(
@@ -56,9 +53,6 @@ PetscErrorCode ADVMarkCrossFreeSurf(AdvCtx *actx);
 // compute reference sedimentation phases
 PetscErrorCode ADVGetSedPhase(AdvCtx *actx, Vec vphase);
 
-// rearrange storage after marker resampling
-PetscErrorCode ADVCollectGarbageVec(AdvCtx *actx, vector <Marker> &recvbuf, vector <PetscInt> &idel);
-
 #define MAP_SUBCELL(i, x, s, h, n) \
 { i = (PetscInt)PetscFloorReal(((x) - (s))/(h)); if(i > n - 1) { i = n - 1; } if(i < 0) { i = 0; } }
 
@@ -21,6 +21,7 @@
 #include "JacRes.h"
 #include "interpolate.h"
 #include "tools.h"
+#include "profile.h"
 //---------------------------------------------------------------------------
 // * stair-case type of free surface
 // ...
@@ -252,6 +253,8 @@ PetscErrorCode FreeSurfAdvect(FreeSurf *surf)
 	// free surface cases only
 	if(!surf->UseFreeSurf) PetscFunctionReturn(0);
 
+	ierr = PetscLogEventBegin(LaMEM_FreeSurfAdvect, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	// access context
 	jr = surf->jr;
 
@@ -269,6 +272,8 @@ PetscErrorCode FreeSurfAdvect(FreeSurf *surf)
 	// compute & store average topography
 	ierr = FreeSurfGetAvgTopo(surf); CHKERRQ(ierr);
 
+	ierr = PetscLogEventEnd(LaMEM_FreeSurfAdvect, 0, 0, 0, 0); CHKERRQ(ierr);
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -1273,14 +1278,15 @@ PetscErrorCode FreeSurfSetInitialPerturbation(FreeSurf *surf)
 //---------------------------------------------------------------------------
 PetscErrorCode FreeSurfSetTopoFromFile(FreeSurf *surf, FB *fb)
 {
+	// reads only the block of the topography grid that covers the local nodes
+
 	FDSTAG         *fs;
-	int            fd;
 	PetscLogDouble t;
-	PetscViewer    view_in;
 	char           filename[_str_len_];
-	PetscInt 	   nxTopo, nyTopo, Ix, Iy, GridSize;
+	PetscInt 	   nxTopo, nyTopo, Ix, Iy, Ix0, Iy0, Ix1, Iy1;
 	PetscInt       i, j, nx, ny, sx, sy, sz, level;
-	PetscScalar    ***topo, *Z, header, dim[2], start[2], spacing[2];
+	PetscInt       sizes[2], starts[2], subsizes[2];
+	PetscScalar    ***topo, *Z, header[7], dim[2], start[2], spacing[2];
 	PetscScalar    xp, yp, xpL, ypL, DX, DY, bx, by, ex, ey, leng, X1, Y1;
 
 	PetscErrorCode ierr;
@@ -1292,42 +1298,24 @@ PetscErrorCode FreeSurfSetTopoFromFile(FreeSurf *surf, FB *fb)
 	// check whether file is provided
 	if(!strlen(filename)) PetscFunctionReturn(0);
 
-	PrintStart(&t, "Loading topography redundantly from", filename);
+	PrintStart(&t, "Loading topography from", filename);
 
 	// access context
 	fs    = surf->jr->fs;
 	level = fs->dsz.rank;
 	leng  = surf->jr->scal->length;
 
-	// open & read file
-	ierr = PetscViewerBinaryOpen(PETSC_COMM_SELF, filename, FILE_MODE_READ, &view_in); CHKERRQ(ierr);
-	ierr = PetscViewerBinaryGetDescriptor(view_in, &fd);                               CHKERRQ(ierr);
-
-	// read (and ignore) the silent undocumented file header
-	ierr = PetscBinaryRead(fd, &header, 1, NULL, PETSC_SCALAR); CHKERRQ(ierr);
+	// read file header: (ignored) silent header, grid dimensions,
+	// south-west corner coordinates, grid spacing
+	ierr = BinaryReadHeader(PETSC_COMM_WORLD, filename, 7, header); CHKERRQ(ierr);
 
-	// read grid dimensions
-	ierr = PetscBinaryRead(fd, &dim, 2,  NULL, PETSC_SCALAR); CHKERRQ(ierr);
-
-	// read south-west corner coordinates
-	ierr = PetscBinaryRead(fd, &start, 2,  NULL, PETSC_SCALAR); CHKERRQ(ierr);
-
-	// read grid spacing
-	ierr = PetscBinaryRead(fd, &spacing, 2,  NULL, PETSC_SCALAR); CHKERRQ(ierr);
+	dim    [0] = header[1]; dim    [1] = header[2];
+	start  [0] = header[3]; start  [1] = header[4];
+	spacing[0] = header[5]; spacing[1] = header[6];
 
 	// compute grid size
 	nxTopo = (PetscInt)dim[0];
 	nyTopo = (PetscInt)dim[1];
-	GridSize = nxTopo * nyTopo;
-
-	// allocate space for entire file & initialize counter
-	ierr = PetscMalloc((size_t)GridSize*sizeof(PetscScalar), &Z); CHKERRQ(ierr);
-	
-	// read entire file
-	ierr = PetscBinaryRead(fd, Z, GridSize, NULL, PETSC_SCALAR); CHKERRQ(ierr);
-
-	// destroy file handle
-	ierr = PetscViewerDestroy(&view_in); CHKERRQ(ierr);
 
 	// get input topography grid spacing
 	DX = spacing[0]/leng;
@@ -1363,6 +1351,26 @@ PetscErrorCode FreeSurfSetTopoFromFile(FreeSurf *surf, FB *fb)
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Topography input file does not cover northern edge of the LaMEM box!");
 	}
 
+	// get range of input grid elements spanned by local nodes
+	Ix0 = (PetscInt)PetscFloorReal((COORD_NODE(sx,      sx, fs->dsx)-X1)/DX);
+	Ix1 = (PetscInt)PetscFloorReal((COORD_NODE(sx+nx-1, sx, fs->dsx)-X1)/DX);
+	Iy0 = (PetscInt)PetscFloorReal((COORD_NODE(sy,      sy, fs->dsy)-Y1)/DY);
+	Iy1 = (PetscInt)PetscFloorReal((COORD_NODE(sy+ny-1, sy, fs->dsy)-Y1)/DY);
+
+	if(Ix0 == nxTopo - 1) Ix0 = nxTopo - 2;
+	if(Ix1 == nxTopo - 1) Ix1 = nxTopo - 2;
+	if(Iy0 == nyTopo - 1) Iy0 = nyTopo - 2;
+	if(Iy1 == nyTopo - 1) Iy1 = nyTopo - 2;
+
+	// read local block of input grid (stored with x running fastest)
+	sizes   [0] = nyTopo;      sizes   [1] = nxTopo;
+	starts  [0] = Iy0;         starts  [1] = Ix0;
+	subsizes[0] = Iy1-Iy0+2;   subsizes[1] = Ix1-Ix0+2;
+
+	ierr = PetscMalloc((size_t)(subsizes[0]*subsizes[1])*sizeof(PetscScalar), &Z); CHKERRQ(ierr);
+
+	ierr = BinaryReadSubArray(PETSC_COMM_WORLD, filename, 7, 2, sizes, starts, subsizes, Z); CHKERRQ(ierr);
+
 
 	// runs over all LaMEM nodes
 	START_PLANE_LOOP
@@ -1383,12 +1391,16 @@ PetscErrorCode FreeSurfSetTopoFromFile(FreeSurf *surf, FB *fb)
 		xpL = (PetscScalar)((xp-(X1+(((PetscScalar) Ix)*DX)))/DX);
 		ypL = (PetscScalar)((yp-(Y1+(((PetscScalar) Iy)*DY)))/DY);
 
+		// switch to local block indices
+		Ix -= Ix0;
+		Iy -= Iy0;
+
 		// interpolate topography from input grid onto LaMEM nodes
 		topo[level][j][i] = (
-			(1.0-xpL) * (1.0-ypL) * Z[Ix   + Iy     * nxTopo] +
-			(xpL)     * (1.0-ypL) * Z[Ix+1 + Iy     * nxTopo] +
-			(xpL)     * (ypL)     * Z[Ix+1 + (Iy+1) * nxTopo] +
-			(1.0-xpL) * (ypL)     * Z[Ix   + (Iy+1) * nxTopo])/leng;
+			(1.0-xpL) * (1.0-ypL) * Z[Ix   + Iy     * subsizes[1]] +
+			(xpL)     * (1.0-ypL) * Z[Ix+1 + Iy     * subsizes[1]] +
+			(xpL)     * (ypL)     * Z[Ix+1 + (Iy+1) * subsizes[1]] +
+			(1.0-xpL) * (ypL)     * Z[Ix   + (Iy+1) * subsizes[1]])/leng;
 	}
 	END_PLANE_LOOP
 
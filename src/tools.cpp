@@ -108,6 +108,83 @@ PetscErrorCode VecWriteRestart(Vec x, FILE *fp)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+// Read blocks of binary input files
+//---------------------------------------------------------------------------
+PetscErrorCode BinaryReadHeader(MPI_Comm comm, const char *filename, PetscInt n, PetscScalar *header)
+{
+	// read leading scalars of a PETSc binary file on the first rank, broadcast to others
+
+	int          fd;
+	PetscViewer  view_in;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(ISRankZero(comm))
+	{
+		ierr = PetscViewerBinaryOpen(PETSC_COMM_SELF, filename, FILE_MODE_READ, &view_in); CHKERRQ(ierr);
+		ierr = PetscViewerBinaryGetDescriptor(view_in, &fd);                               CHKERRQ(ierr);
+		ierr = PetscBinaryRead(fd, header, n, NULL, PETSC_SCALAR);                         CHKERRQ(ierr);
+		ierr = PetscViewerDestroy(&view_in);                                               CHKERRQ(ierr);
+	}
+
+	ierr = MPI_Bcast(header, (PetscMPIInt)n, MPIU_SCALAR, 0, comm); CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode BinaryReadSubArray(
+		MPI_Comm     comm,     // communicator (collective)
+		const char  *filename, // file name
+		PetscInt     offset,   // number of scalars preceding the array
+		PetscInt     ndim,     // number of array dimensions (slowest first)
+		PetscInt    *sizes,    // global array sizes
+		PetscInt    *starts,   // first index of local block
+		PetscInt    *subsizes, // sizes of local block
+		PetscScalar *buff)     // local block storage
+{
+	// read a block of a C-ordered scalar array through an MPI-IO subarray view,
+	// so that every rank only touches the part of the file it actually needs
+
+	MPI_File     fh;
+	MPI_Datatype block;
+	PetscMPIInt  gsz[3], lsz[3], lst[3];
+	PetscInt     i, n;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	if(ndim > 3)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Binary sub-array reader supports up to three dimensions");
+	}
+
+	for(i = 0, n = 1; i < ndim; i++)
+	{
+		gsz[i] = (PetscMPIInt)sizes[i];
+		lsz[i] = (PetscMPIInt)subsizes[i];
+		lst[i] = (PetscMPIInt)starts[i];
+		n     *= subsizes[i];
+	}
+
+	ierr = MPI_Type_create_subarray((PetscMPIInt)ndim, gsz, lsz, lst, MPI_ORDER_C, MPIU_SCALAR, &block); CHKERRQ(ierr);
+	ierr = MPI_Type_commit(&block); CHKERRQ(ierr);
+
+	ierr = MPI_File_open(comm, (char*)filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh); CHKERRQ(ierr);
+	ierr = MPI_File_set_view(fh, (MPI_Offset)offset*(MPI_Offset)sizeof(PetscScalar), MPIU_SCALAR, block, (char*)"native", MPI_INFO_NULL); CHKERRQ(ierr);
+	ierr = MPI_File_read_all(fh, buff, (PetscMPIInt)n, MPIU_SCALAR, MPI_STATUS_IGNORE); CHKERRQ(ierr);
+	ierr = MPI_File_close(&fh); CHKERRQ(ierr);
+
+	ierr = MPI_Type_free(&block); CHKERRQ(ierr);
+
+#if !defined(PETSC_WORDS_BIGENDIAN)
+	// PETSc binary files are big-endian
+	ierr = PetscByteSwap(buff, PETSC_SCALAR, n); CHKERRQ(ierr);
+#endif
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 //  basic statistic functions
 //---------------------------------------------------------------------------
 PetscScalar getArthMean(PetscScalar *data, PetscInt n)
@@ -261,6 +338,41 @@ void getLocalRank(PetscInt *i, PetscInt *j, PetscInt *k, PetscMPIInt rank, Petsc
 
 }
 //---------------------------------------------------------------------------
+PetscErrorCode RankGroupSplit(MPI_Comm comm, PetscInt *ngroups, PetscInt *color, MPI_Comm *gcomm, PetscMPIInt *grank)
+{
+	// split communicator into groups formed by contiguous blocks of ranks
+
+	PetscMPIInt size, rank;
+
+	PetscErrorCode ierr;
+	PetscFunctionBeginUser;
+
+	ierr = MPI_Comm_size(comm, &size); CHKERRQ(ierr);
+	ierr = MPI_Comm_rank(comm, &rank); CHKERRQ(ierr);
+
+	if((*ngroups) < 1)    (*ngroups) = 1;
+	if((*ngroups) > size) (*ngroups) = size;
+
+	(*color) = ((PetscInt)rank*(*ngroups))/(PetscInt)size;
+
+	ierr = MPI_Comm_split(comm, (PetscMPIInt)(*color), rank, gcomm); CHKERRQ(ierr);
+	ierr = MPI_Comm_rank((*gcomm), grank);                             CHKERRQ(ierr);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+void RankGroupSwitch(MPI_Comm comm)
+{
+	// The LaMEM library consistently creates its objects on PETSC_COMM_WORLD,
+	// which is reassigned to run a model on a group of ranks.
+	// NOTE: reassigning PETSC_COMM_WORLD after PetscInitialize is not supported
+	// by PETSc. It works as long as all PETSc objects of a model are created and
+	// destroyed on the same communicator. Data that PETSc caches on a communicator
+	// (e.g. the stdout viewer with its output stream) persists between models.
+
+	PETSC_COMM_WORLD = comm;
+}
+//---------------------------------------------------------------------------
 PetscErrorCode DirMake(const char *name)
 {
 	int status;
@@ -369,6 +481,26 @@ PetscErrorCode DirCheck(const char *name, PetscInt *exists)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode DirChange(const char *name, char *prev)
+{
+	// change working directory of the calling process
+	// (previous directory is stored in prev, if requested, PETSC_MAX_PATH_LEN)
+
+	PetscFunctionBeginUser;
+
+	if(prev && !getcwd(prev, PETSC_MAX_PATH_LEN))
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Failed to get current directory");
+	}
+
+	if(chdir(name))
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Failed to change directory to %s", name);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 // Fast detection points inside a polygonal region.
 //
 // Originally written as a MATLAB mexFunction by:
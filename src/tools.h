@@ -31,6 +31,22 @@ PetscErrorCode VecReadRestart (Vec x, FILE *fp);
 
 PetscErrorCode VecWriteRestart(Vec x, FILE *fp);
 
+//---------------------------------------------------------------------------
+// Read blocks of binary input files
+//---------------------------------------------------------------------------
+
+PetscErrorCode BinaryReadHeader(MPI_Comm comm, const char *filename, PetscInt n, PetscScalar *header);
+
+PetscErrorCode BinaryReadSubArray(
+		MPI_Comm     comm,      // communicator (collective)
+		const char  *filename,  // file name
+		PetscInt     offset,    // number of scalars preceding the array
+		PetscInt     ndim,      // number of array dimensions (slowest first)
+		PetscInt    *sizes,     // global array sizes
+		PetscInt    *starts,    // first index of local block
+		PetscInt    *subsizes,  // sizes of local block
+		PetscScalar *buff);     // local block storage
+
 //---------------------------------------------------------------------------
 // Basic statistic functions
 //---------------------------------------------------------------------------
@@ -71,6 +87,16 @@ PetscMPIInt getGlobalRankPeriodic(
 // get local ranks of processor in DMDA
 void getLocalRank(PetscInt *i, PetscInt *j, PetscInt *k, PetscMPIInt rank, PetscInt m, PetscInt n);
 
+//---------------------------------------------------------------------------
+// Groups of ranks running independent models
+//---------------------------------------------------------------------------
+
+// split communicator into contiguous blocks of ranks (number of groups is corrected)
+PetscErrorCode RankGroupSplit(MPI_Comm comm, PetscInt *ngroups, PetscInt *color, MPI_Comm *gcomm, PetscMPIInt *grank);
+
+// set communicator used by the LaMEM library (PETSC_COMM_WORLD)
+void RankGroupSwitch(MPI_Comm comm);
+
 //---------------------------------------------------------------------------
 // Directory management functions
 //---------------------------------------------------------------------------
@@ -83,6 +109,8 @@ PetscErrorCode DirRename(const char *old_name, const char *new_name);
 
 PetscErrorCode DirCheck(const char *name, PetscInt *exists);
 
+PetscErrorCode DirChange(const char *name, char *prev);
+
 //---------------------------------------------------------------------------
 // Numerical functions
 //---------------------------------------------------------------------------
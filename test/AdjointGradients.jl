@@ -110,6 +110,30 @@ ParamFile = "t8_AdjointGradients_CompareGradients_2.dat";
                         args="",
                         keywords=keywords, accuracy=acc, cores=1, opt=true, mpiexec=mpiexec)
 
+# t8_AdjointGradients_CompareAnalytic
+# analytic dr/dp of density & linear viscosity versus brute force FD gradients
+pairs      = (  ("|       FD     1:          rho[ 1]", "|  adjoint     2:          rho[ 1]"),
+                ("|       FD     3:          eta[ 0]", "|  adjoint     4:          eta[ 0]"),
+                ("|       FD     5:          eta[ 1]", "|  adjoint     6:          eta[ 1]"),
+             );
+
+ParamFile = "t8_AdjointGradients_CompareAnalytic.dat";
+@test perform_lamem_agreement_test(dir,ParamFile,pairs,
+                        accuracy=(rtol=1e-3, atol=1e-12), cores=1, opt=true, mpiexec=mpiexec)
+
+# t8_AdjointGradients_CompareAnalytic_2
+# analytic dr/dp of power-law creep parameters versus FD dr/dp (same forward solution & adjoint solve)
+pairs      = (  ("|  adjoint     1:         eta0[ 0]", "|  adjoint     1:         eta0[ 0]"),
+                ("|  adjoint     2:            n[ 0]", "|  adjoint     2:            n[ 0]"),
+                ("|  adjoint     3:         eta0[ 1]", "|  adjoint     3:         eta0[ 1]"),
+                ("|  adjoint     4:            n[ 1]", "|  adjoint     4:            n[ 1]"),
+             );
+
+ParamFile = "t8_AdjointGradients_CompareAnalytic_2.dat";
+@test perform_lamem_agreement_test(dir,ParamFile,pairs,
+                        args=("", "-FD_adjoint_drdp"),
+                        accuracy=(rtol=1e-4, atol=1e-12), cores=2, opt=true, mpiexec=mpiexec)
+
 # t8_Adjoint_Subduction2D_FreeSlip
 keywords   = (  "|Div|_inf",
                 "|Div|_2",
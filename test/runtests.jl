@@ -37,7 +37,21 @@ else
     global is64bit=false
 end
 
-@show use_dynamic_lib test_superlu test_mumps create_plots
+# performance regression tests (timings are machine specific, so they are optional)
+if "perf" in ARGS
+    test_perf=true
+else
+    test_perf=false
+end
+
+if "perf_baseline" in ARGS
+    test_perf=true
+    create_perf_baseline=true
+else
+    create_perf_baseline=false
+end
+
+@show use_dynamic_lib test_superlu test_mumps create_plots test_perf
 include("test_utils.jl")        # test-framework specific functions
 
 test_dir = pwd()
@@ -1095,5 +1109,67 @@ end
     clean_test_directory(dir)
 end
 
+@testset "t34_CAPI" begin
+    cd(test_dir)
+    dir = "t34_CAPI";
+
+    # requires the shared library (make mode=opt dylib), runs in a separate process
+    # since the in-memory options database is global to the process
+    lib = get(ENV, "LAMEM_LIB", joinpath(test_dir, "..", "lib", "opt", "LaMEMLib.dylib"))
+    if isfile(lib)
+        @test success(Cmd(`$(Base.julia_cmd()) --project=$(Base.active_project()) t34_CAPI.jl`, dir=dir))
+    else
+        @info "Skipping C API test, shared library not found: $lib"
+    end
+end
+
+@testset "t35_Ensemble" begin
+    cd(test_dir)
+    dir = "t35_Ensemble";
+
+    include(joinpath(dir,"t35_Ensemble.jl"))
+
+    success, out, logs, mdirs = run_ensemble_t35(dir, "t35_Ensemble.dat", "t35_members.txt", cores=2, mpiexec=mpiexec)
+
+    # failure of member 0 is reported, the other members finish
+    @test success == false
+    @test contains(out, "Ensemble member 0 on group 0 FAILED")
+    @test contains(out, "Finished ensemble member 1 on group 1")
+    @test contains(out, "Finished ensemble member 2 on group 0")
+    @test contains(out, "Finished 3 ensemble members (1 failed)")
+
+    # every group writes its own log file, members run in their own directories
+    @test contains(logs[1], "Member_000000") && contains(logs[1], "Member_000002")
+    @test contains(logs[2], "Member_000001") && !contains(logs[2], "Member_000000")
+    @test count("Total solution time", logs[1]) == 1
+    @test count("Total solution time", logs[2]) == 1
+    @test all(mdirs)
+end
+
+@testset "Performance" begin
+    if test_perf
+        cd(test_dir)
+        baseline_dir = joinpath(test_dir,"perf_baselines")
+
+        names = ("Initial guess","SNES solve","Advect markers",
+                 "JacResStrainRate","JacResResidual","PMatAssemble","MGSetup",
+                 "ADVMapMarkCells","ADVProjHistGrid","AVDMarkerCtrl","ADVExchange")
+
+        # direct solver & marker advection
+        @test perform_lamem_perf_test("t1_FB1_Direct","FallingBlock_mono_PenaltyDirect.dat",
+                            joinpath(baseline_dir,"FB1_Direct_opt-p1.perf"), names=names,
+                            cores=1, opt=true, mpiexec=mpiexec, args="-nstep_max 5",
+                            create_baseline=create_perf_baseline)
+
+        # coupled multigrid in parallel
+        if test_superlu
+            @test perform_lamem_perf_test("t2_FB2_MG","FallingBlock_mono_CoupledMG_RedundantCoarse.dat",
+                                joinpath(baseline_dir,"FB2_CoupledMG_opt-p4.perf"), names=names,
+                                cores=4, opt=true, mpiexec=mpiexec, args="-nstep_max 5",
+                                create_baseline=create_perf_baseline)
+        end
+    end
+end
+
 end
 
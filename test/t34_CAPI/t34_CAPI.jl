@@ -0,0 +1,47 @@
+# Smoke test of the C-callable LaMEM library API (src/LaMEM_C.h).
+# Runs in a separate julia process (started by runtests.jl), since it requires
+# the shared library (make mode=opt dylib, or set LAMEM_LIB).
+
+include(joinpath(@__DIR__, "..", "..", "src", "LaMEM_C.jl"))
+using .LaMEM_C
+using Test
+
+params = read(joinpath(@__DIR__, "t34_CAPI.dat"), String)
+
+LaMEM_C.initialize()
+
+# first model: additional options limit the number of steps
+h = LaMEM_C.create(params, "-nstep_max 1")
+
+done        = LaMEM_C.step(h, 5)
+time, istep = LaMEM_C.get_time(h)
+
+@test done == true
+@test istep == 1
+@test time > 0.0
+
+# the dense block sinks
+Vz = LaMEM_C.get_field(h, "velocity_z")
+@test all(isfinite, Vz)
+@test minimum(Vz) < 0.0
+
+# invalid phase IDs are rejected before markers are modified
+mark  = LaMEM_C.get_markers(h)
+phase = fill(Cint(2), length(mark.phase))
+@test_throws ErrorException LaMEM_C.set_markers!(h, phase, mark.T)
+@test LaMEM_C.get_markers(h).phase == mark.phase
+
+LaMEM_C.destroy(h)
+
+# second model: options of the first model must be removed from the database
+h = LaMEM_C.create(params, "")
+
+done        = LaMEM_C.step(h, 2)
+time, istep = LaMEM_C.get_time(h)
+
+@test done == false
+@test istep == 2
+
+LaMEM_C.destroy(h)
+
+LaMEM_C.finalize()
@@ -0,0 +1,25 @@
+# Runs an ensemble of three members on two groups of ranks, where the first member fails
+
+function run_ensemble_t35(dir, ParamFile, members; cores=2, mpiexec="mpiexec")
+    cur_dir = pwd();
+    cd(dir)
+
+    outfile = "test_ensemble.out"
+
+    # failed member is reported by a nonzero exit code
+    success = run_lamem_local_test(ParamFile, cores, "-ensemble_file $members -ensemble_groups 2", outfile=outfile, opt=true, mpiexec=mpiexec)
+
+    out   = read(outfile, String)
+    logs  = (isfile("Group_000000.log") ? read("Group_000000.log", String) : "",
+             isfile("Group_000001.log") ? read("Group_000001.log", String) : "")
+    mdirs = (isdir("Member_000000"), isdir("Member_000001"), isdir("Member_000002"))
+
+    # clean
+    rm(outfile, force=true)
+    for f in [glob("Group_*.log"); glob("Member_*")]
+        rm(f, force=true, recursive=true)
+    end
+
+    cd(cur_dir)
+    return success, out, logs, mdirs
+end
@@ -8,7 +8,7 @@ if use_dynamic_lib
     using PETSc_jll
 end
 
-export run_lamem_local_test, perform_lamem_test, clean_test_directory, run_lamem_save_grid_local, mpiexec
+export run_lamem_local_test, perform_lamem_test, perform_lamem_agreement_test, clean_test_directory, run_lamem_save_grid_local, mpiexec
 export CreatePartitioningFile_local
 
 
@@ -527,4 +527,319 @@ function perform_lamem_test(dir::String, ParamFile::String, expectedFile::String
 end 
 
 
+"""
+    perform_lamem_agreement_test(dir::String, 
+                                 ParamFile::String, 
+                                 pairs; 
+                                 args=("",""), 
+                                 accuracy=(rtol=1e-4,), 
+                                 cores::Int64=1, 
+                                 bin_dir="../bin",  
+                                 opt=true, 
+                                 deb=false, 
+                                 mpiexec="mpiexec",
+                                 clean_dir::Bool=true)
+
+This performs one or two LaMEM simulations and checks that values computed in different ways agree with each other, 
+rather than comparing them with an expected file (e.g. FD versus adjoint gradients).
+`pairs` is a Tuple of keyword pairs. The value after the first keyword is read from the run with `args[1]`, 
+the value after the second keyword from the run with `args[2]`. If both `args` are equal, LaMEM runs only once.
+
+Parameters:
+- `dir`: directory in which the LaMEM `*.dat` ParamFile is located
+- `ParamFile`: name of the LaMEM input file
+- `pairs`: Tuple with pairs of keywords, which contain numerical values that should agree
+- `args`: LaMEM command line arguments of the first & second run
+- `accuracy`: relative (`rtol`), and (optionally) absolute `atol` tolerance
+- `cores`: Number of cores on which to perform the test
+- `bin_dir`: directory where the LaMEM binaries are, relative to the current one
+- `opt`: run with optimized LaMEM?
+- `deb`: run with debug version of LaMEM?
+- `mpiexec`: mpi executable
+- `clean_dir`: delete all timestep & pvd files at the end?
+
+"""
+function perform_lamem_agreement_test(dir::String, ParamFile::String, pairs::NTuple{N,Tuple{String,String}}; 
+                args::Tuple{String,String}=("",""), accuracy=(rtol=1e-4,),
+                cores::Int64=1,
+                bin_dir="../bin",  opt=true, deb=false, mpiexec="mpiexec",
+                clean_dir::Bool=true
+                ) where N
+
+    # print info about running tests                
+    @info "Performing agreement test $ParamFile in directory $dir on $cores cores"
+    
+    cur_dir = pwd();
+    cd(dir)
+
+    bin_dir  = joinpath(cur_dir,bin_dir);
+    outfiles = ("test_$(cores)_1.out", "test_$(cores)_2.out")
+
+    # perform simulations
+    success = run_lamem_local_test(ParamFile, cores, args[1], outfile=outfiles[1], bin_dir=bin_dir, opt=opt, deb=deb, mpiexec=mpiexec);
+
+    if args[2] == args[1]
+        outfiles = (outfiles[1], outfiles[1])
+    elseif success==true
+        success = run_lamem_local_test(ParamFile, cores, args[2], outfile=outfiles[2], bin_dir=bin_dir, opt=opt, deb=deb, mpiexec=mpiexec);
+    end
+
+    if success==true
+        for (key1, key2) in pairs
+            val1 = extract_info_logfiles(outfiles[1], (key1,))[1]
+            val2 = extract_info_logfiles(outfiles[2], (key2,))[1]
+
+            if isempty(val1) || length(val1) != length(val2) || !isapprox(val1, val2; accuracy...)
+                printstyled("      $key1: $val1 does not agree with $key2: $val2, accuracy=$accuracy \n", color=:red)
+                success = false
+            end
+        end
+    end
+
+    if !success
+        println("Problem detected with test; see this on commandline with: ")
+        println("  dir=$(joinpath(cur_dir,dir)) ")
+        println("  ParamFile=$(ParamFile) ")
+        println("  cores=$(cores) ")
+        println("  args=$(args) ")
+        println("  outfiles=$(outfiles) ")
+    end
+
+    cd(cur_dir)  # return to directory       
+
+    if clean_dir
+       clean_test_directory(dir)
+    end 
+    
+    return success
+end 
+
+
+"""
+    out = extract_logview_timings(file::String, names::NTuple{N,String})
+
+Extracts timings (in seconds) from the `-log_view` summary that PETSc appends to the LaMEM logfile `file`.
+`names` can be profiling stages (e.g. "SNES solve", average time over all processors) or
+events (e.g. "JacResResidual", maximum time over all processors, summed over all stages).
+Names that do not appear in the summary are not part of the returned `Dict`.
+"""
+function extract_logview_timings(file::String, names::NTuple{N,String}) where N
+
+    out       = Dict{String,Float64}()
+    in_stages = false
+
+    for line in readlines(file)
+
+        # stage table ("Summary of Stages:") comes before all event tables
+        if occursin("Summary of Stages:", line)
+            in_stages = true
+            continue
+        end
+        if in_stages && occursin("Event Stage", line)
+            in_stages = false
+        end
+
+        if in_stages
+            # " 1:      SNES solve: 1.2345e+00  45.3% ..."
+            m = match(r"^\s*\d+:\s*(.+?):\s+([-+0-9.eE]+)\s", line)
+            if !isnothing(m) && strip(m[1]) in names
+                out[strip(m[1])] = parse(Float64, m[2])
+            end
+        else
+            # "JacResResidual        20 1.0 1.2345e-02 1.1 ..."
+            m = match(r"^(\S+)\s+\d+\s+[0-9.]+\s+([-+0-9.eE]+)\s", line)
+            if !isnothing(m) && m[1] in names
+                out[m[1]] = get(out, m[1], 0.0) + parse(Float64, m[2])
+            end
+        end
+    end
+
+    return out
+end
+
+"""
+    its, lits = extract_perf_iterations(file::String)
+
+Sums the nonlinear (`its`) and linear (`lits`) iteration counts of all time steps written by LaMEM to the performance log `file` (see `-perf_log`).
+"""
+function extract_perf_iterations(file::String)
+
+    its, lits = 0, 0
+    for line in readlines(file)
+        m = match(r"\"its\":\s*(\d+),\s*\"lits\":\s*(\d+)", line)
+        if !isnothing(m)
+            its  += parse(Int64, m[1])
+            lits += parse(Int64, m[2])
+        end
+    end
+
+    return its, lits
+end
+
+"""
+    write_perf_baseline(file::String, values::Dict)
+
+Writes a performance baseline file with one `name = value` line per entry.
+"""
+function write_perf_baseline(file::String, values::Dict)
+
+    mkpath(dirname(abspath(file)))
+    open(file, "w") do io
+        println(io, "# LaMEM performance baseline (machine specific)")
+        println(io, "# stage/event timings in s, iteration counts")
+        for key in sort(collect(keys(values)))
+            println(io, "$key = $(values[key])")
+        end
+    end
+
+    return nothing
+end
+
+"""
+    values = read_perf_baseline(file::String)
+
+Reads a performance baseline file written by `write_perf_baseline`.
+"""
+function read_perf_baseline(file::String)
+
+    values = Dict{String,Float64}()
+    for line in readlines(file)
+        line = strip(line)
+        if isempty(line) || startswith(line, "#")
+            continue
+        end
+        key, val = split(line, "=", limit=2)
+        values[strip(key)] = parse(Float64, val)
+    end
+
+    return values
+end
+
+"""
+    success = compare_perf_baseline(new::Dict, baseline::Dict; rtol=0.25, atol=0.05, rtol_its=0.1)
+
+Compares timings and iteration counts with a baseline. A timing is a regression if it exceeds `(1+rtol)*baseline + atol`
+(`atol` keeps short events from failing because of timer noise), an iteration count (`its`, `lits`) if it exceeds `(1+rtol_its)*baseline`.
+Entries of the baseline that are missing in `new` are regressions as well.
+"""
+function compare_perf_baseline(new::Dict, baseline::Dict; rtol=0.25, atol=0.05, rtol_its=0.1)
+
+    n = 24;
+    test_status = true
+
+    println("      $(rpad("Name",n)) | $(rpad("New",n)) | $(rpad("Baseline",n)) | $(rpad("Ratio",n))")
+
+    for key in sort(collect(keys(baseline)))
+        base = baseline[key]
+        col  = :normal
+        if !haskey(new, key)
+            printstyled("      $(rpad(key,n)) | $(rpad("missing",n)) | $(rpad(base,n)) | \n", color=:red)
+            test_status = false
+            continue
+        end
+        val = new[key]
+        if key in ("its", "lits")
+            limit = (1+rtol_its)*base
+        else
+            limit = (1+rtol)*base + atol
+        end
+        if val > limit
+            col = :red
+            test_status = false
+        end
+        printstyled("      $(rpad(key,n)) | $(rpad(val,n)) | $(rpad(base,n)) | $(rpad(round(val/max(base,eps()),digits=3),n)) \n", color=col)
+    end
+
+    return test_status
+end
+
+"""
+    perform_lamem_perf_test(dir::String, 
+                            ParamFile::String, 
+                            baselineFile::String; 
+                            names=("Initial guess","SNES solve","Advect markers","JacResResidual","PMatAssemble"), 
+                            rtol=0.25, 
+                            atol=0.05, 
+                            rtol_its=0.1,
+                            cores::Int64=1, 
+                            args::String="",
+                            bin_dir="../bin",  
+                            opt=true, 
+                            deb=false, 
+                            mpiexec="mpiexec",
+                            create_baseline::Bool=false, 
+                            clean_dir::Bool=true)
+
+This performs a LaMEM simulation with `-log_view`, and compares the timings of profiling stages & events, as well as 
+the total number of nonlinear and linear iterations, with a baseline file created in an earlier run on the same machine.        
+If the baseline file does not exist yet, it is created and the test passes.
 
+Parameters:
+- `dir`: directory in which the LaMEM `*.dat` ParamFile is located
+- `ParamFile`: name of the LaMEM input file
+- `baselineFile`: name of the baseline file (relative to `dir`, or absolute)
+- `names`: Tuple with names of the stages and events to be compared
+- `rtol`, `atol`: relative & absolute tolerance for timings
+- `rtol_its`: relative tolerance for iteration counts
+- `cores`: Number of cores on which to perform the test
+- `args`: Optional LaMEM command line Arguments
+- `bin_dir`: directory where the LaMEM binaries are, relative to the current one
+- `opt`: run with optimized LaMEM?
+- `deb`: run with debug version of LaMEM?
+- `mpiexec`: mpi executable
+- `create_baseline`: (re)create the baseline file
+- `clean_dir`: delete all timestep & pvd files at the end?
+
+"""
+function perform_lamem_perf_test(dir::String, ParamFile::String, baselineFile::String; 
+                names=("Initial guess","SNES solve","Advect markers","JacResResidual","PMatAssemble"), 
+                rtol=0.25, atol=0.05, rtol_its=0.1,
+                cores::Int64=1, args::String="",
+                bin_dir="../bin",  opt=true, deb=false, mpiexec="mpiexec",
+                create_baseline::Bool=false, clean_dir::Bool=true
+                )
+
+    # print info about running tests                
+    @info "Performing performance test $ParamFile in directory $dir on $cores cores"
+    
+    cur_dir = pwd();
+    cd(dir)
+
+    bin_dir  = joinpath(cur_dir,bin_dir);
+    outfile  = "perf_$(cores).out";
+    perffile = "perf_$(cores).jsonl";
+
+    # perform simulation with profiling
+    success = run_lamem_local_test(ParamFile, cores, args*" -log_view -perf_log $perffile", outfile=outfile, bin_dir=bin_dir, opt=opt, deb=deb, mpiexec=mpiexec);
+
+    if success==true
+        new       = extract_logview_timings(outfile, names)
+        its, lits = extract_perf_iterations(perffile)
+        new["its"]  = its
+        new["lits"] = lits
+
+        if create_baseline==true || !isfile(baselineFile)
+            write_perf_baseline(baselineFile, new)
+            println("Created performance baseline: $baselineFile in directory $dir")
+        else
+            success = compare_perf_baseline(new, read_perf_baseline(baselineFile), rtol=rtol, atol=atol, rtol_its=rtol_its)
+            if !success
+                println("Performance regression detected in directory $(joinpath(cur_dir,dir)) with: ")
+                println("  ParamFile=$(ParamFile) ")
+                println("  cores=$(cores) ")
+                println("  args=$(args) ")
+                println("  baseline=$(baselineFile) ")
+            end
+        end
+    end
+
+    rm(perffile, force=true)
+
+    cd(cur_dir)  # return to directory       
+
+    if clean_dir
+       clean_test_directory(dir)
+    end 
+    
+    return success
+end 